@@ -3,20 +3,27 @@
 #include <yycc/carton/fft.hpp>
 #include <random>
 #include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <numbers>
+#include <bit>
+#include <cmath>
+#include <type_traits>
+#include <limits>
 
 #define FFT ::yycc::carton::fft
 
 namespace yyccbench::carton::fft {
 
     using TIndex = size_t;
-    using TFloat = float;
-    using TComplex = std::complex<TFloat>;
-    template<TIndex N>
+    template<typename TFloat, TIndex N>
     using TFft = FFT::Fft<TIndex, TFloat, N>;
 
-    constexpr TIndex FFT_POINTS = 1024u;
-
+    template<typename TFloat, TIndex N>
     static void BM_FftCompute(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+
         // prepare random buffer
         constexpr TIndex RND_BUF_CNT = 8u;
         std::random_device rnd_device;
@@ -24,17 +31,1197 @@ namespace yyccbench::carton::fft {
         std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
         std::vector<std::vector<TComplex>> buffer_collection(RND_BUF_CNT);
         for (auto& buf : buffer_collection) {
-            buf.resize(FFT_POINTS);
+            buf.resize(N);
             std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
         }
 
-        // prepare FFT engine
-        TFft<FFT_POINTS> fft;
+        // prepare FFT engine and working buffer.
+        // We restore working buffer from random buffer in each iteration,
+        // otherwise the result will overflow into Inf and NaN after several rounds and distort the timing.
+        TFft<TFloat, N> fft;
+        std::vector<TComplex> work(N);
+        // do benchmark
+        for (auto _ : state) {
+            const auto& buf = buffer_collection[state.iterations() % RND_BUF_CNT];
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute(work.data());
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    // Odd exponents (512 and 2048) need an extra radix-2 pass, and their first radix-4 pass is narrower than AVX2 float pack.
+    BENCHMARK(BM_FftCompute<float, 256u>)->Name("FftCompute/float/256");
+    BENCHMARK(BM_FftCompute<float, 512u>)->Name("FftCompute/float/512");
+    BENCHMARK(BM_FftCompute<float, 1024u>)->Name("FftCompute/float/1024");
+    BENCHMARK(BM_FftCompute<float, 2048u>)->Name("FftCompute/float/2048");
+    BENCHMARK(BM_FftCompute<float, 4096u>)->Name("FftCompute/float/4096");
+    BENCHMARK(BM_FftCompute<double, 256u>)->Name("FftCompute/double/256");
+    BENCHMARK(BM_FftCompute<double, 512u>)->Name("FftCompute/double/512");
+    BENCHMARK(BM_FftCompute<double, 1024u>)->Name("FftCompute/double/1024");
+    BENCHMARK(BM_FftCompute<double, 2048u>)->Name("FftCompute/double/2048");
+    BENCHMARK(BM_FftCompute<double, 4096u>)->Name("FftCompute/double/4096");
+
+    template<typename TEngine, typename TValue, TIndex N>
+    static void BM_CompactFftCompute(benchmark::State& state) {
+        using TCompact = FFT::CompactComplex<TValue>;
+        // convert random number in [-0.5, 0.5) into compact number type
+        const auto to_compact = [](float v) -> TValue {
+            if constexpr (std::is_integral_v<TValue>) {
+                return static_cast<TValue>(std::ldexp(v, std::numeric_limits<TValue>::digits));
+            } else {
+                return static_cast<TValue>(v);
+            }
+        };
+
+        // prepare random buffer
+        constexpr TIndex RND_BUF_CNT = 8u;
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<float> rnd_dist(-0.5f, 0.5f);
+        std::vector<std::vector<TCompact>> buffer_collection(RND_BUF_CNT);
+        for (auto& buf : buffer_collection) {
+            buf.resize(N);
+            std::generate(buf.begin(), buf.end(), [&]() mutable -> TCompact {
+                return TCompact{to_compact(rnd_dist(rnd_engine)), to_compact(rnd_dist(rnd_engine))};
+            });
+        }
+
+        // prepare FFT engine and working buffer, and restore working buffer in each iteration like BM_FftCompute.
+        TEngine fft;
+        std::vector<TCompact> work(N);
+        // do benchmark
+        for (auto _ : state) {
+            const auto& buf = buffer_collection[state.iterations() % RND_BUF_CNT];
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute(work.data());
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_CompactFftCompute<FFT::FixedFft<TIndex, std::int16_t, 1024u>, std::int16_t, 1024u>)->Name("FixedFftCompute/q15/1024");
+    BENCHMARK(BM_CompactFftCompute<FFT::FixedFft<TIndex, std::int32_t, 1024u>, std::int32_t, 1024u>)->Name("FixedFftCompute/q31/1024");
+    BENCHMARK(BM_CompactFftCompute<FFT::HalfFft<TIndex, FFT::BFloat16, 1024u>, FFT::BFloat16, 1024u>)->Name("HalfFftCompute/bfloat16/1024");
+#if defined(YYCC_FFT_HAS_FLOAT16)
+    BENCHMARK(BM_CompactFftCompute<FFT::HalfFft<TIndex, _Float16, 1024u>, _Float16, 1024u>)->Name("HalfFftCompute/float16/1024");
+#endif
+
+    template<typename TFloat, FFT::FftAlgorithm VAlgorithm = FFT::FftAlgorithm::CooleyTukey>
+    static void BM_FftPlanCompute(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const TIndex n = static_cast<TIndex>(state.range(0));
+
+        // prepare random buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(n), work(n);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        // fetch runtime plan from cache
+        auto plan = FFT::FftPlanCache<TIndex, TFloat>::get(n, FFT::FftDirection::Forward, VAlgorithm);
+        // do benchmark
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            plan->compute(work.data());
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_FftPlanCompute<float>)->Name("FftPlanCompute/float")->Arg(256)->Arg(1024)->Arg(4096);
+    // the algorithm chosen by planner should be as fast as the faster one of fixed algorithms
+    BENCHMARK(BM_FftPlanCompute<float, FFT::FftAlgorithm::CooleyTukey>)->Name("FftPlanCompute/float/cooley-tukey")->Arg(1024)->Arg(262144);
+    BENCHMARK(BM_FftPlanCompute<float, FFT::FftAlgorithm::Stockham>)->Name("FftPlanCompute/float/stockham")->Arg(1024)->Arg(262144);
+    BENCHMARK(BM_FftPlanCompute<float, FFT::FftAlgorithm::Measure>)->Name("FftPlanCompute/float/measure")->Arg(1024)->Arg(262144);
+
+    template<typename TFloat>
+    static void BM_FftPlannerMeasure(benchmark::State& state) {
+        using TPlanner = FFT::FftPlanner<TIndex, TFloat>;
+        const TIndex n = static_cast<TIndex>(state.range(0));
+
+        // measure the cost of planner on first use, with candidate plans already cached
+        TPlanner::choose(n);
+        for (auto _ : state) {
+            TPlanner::clear();
+            benchmark::DoNotOptimize(TPlanner::choose(n));
+        }
+    }
+    BENCHMARK(BM_FftPlannerMeasure<float>)->Name("FftPlannerMeasure/float")->Unit(benchmark::kMillisecond)->Arg(1024)->Arg(262144);
+    // the point which is not a power of 2 (mixed-radix and Bluestein), along with their nearest power of 2
+    BENCHMARK(BM_FftPlanCompute<float>)
+        ->Name("FftPlanCompute/float/mixed")
+        ->Arg(480)
+        ->Arg(512)
+        ->Arg(960)
+        ->Arg(1000)
+        ->Arg(1009)
+        ->Arg(1024)
+        ->Arg(48000)
+        ->Arg(65536);
+
+    template<typename TFloat, FFT::FftAlgorithm VAlgorithm>
+    static void BM_FftPlanAlgorithm(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const TIndex n = static_cast<TIndex>(state.range(0));
+
+        // prepare random buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(n), work(n), scratch(n);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        // out of place from the same const source, so both algorithms do the same work.
+        auto plan = FFT::FftPlanCache<TIndex, TFloat>::get(n, FFT::FftDirection::Forward, VAlgorithm);
+        for (auto _ : state) {
+            plan->compute(buf.data(), work.data(), scratch.data());
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_FftPlanAlgorithm<float, FFT::FftAlgorithm::CooleyTukey>)
+        ->Name("FftAlgorithm/float/CooleyTukey")
+        ->RangeMultiplier(4)
+        ->Range(256, 1 << 20);
+    BENCHMARK(BM_FftPlanAlgorithm<float, FFT::FftAlgorithm::Stockham>)
+        ->Name("FftAlgorithm/float/Stockham")
+        ->RangeMultiplier(4)
+        ->Range(256, 1 << 20);
+    BENCHMARK(BM_FftPlanAlgorithm<double, FFT::FftAlgorithm::CooleyTukey>)
+        ->Name("FftAlgorithm/double/CooleyTukey")
+        ->RangeMultiplier(4)
+        ->Range(256, 1 << 20);
+    BENCHMARK(BM_FftPlanAlgorithm<double, FFT::FftAlgorithm::Stockham>)
+        ->Name("FftAlgorithm/double/Stockham")
+        ->RangeMultiplier(4)
+        ->Range(256, 1 << 20);
+
+    template<typename TFloat>
+    static void BM_FourStepFft(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const TIndex n = static_cast<TIndex>(state.range(0));
+        const size_t thread_count = static_cast<size_t>(state.range(1));
+
+        // prepare random buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(n), work(n);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        FFT::FftThreadPool pool(thread_count);
+        FFT::FourStepFft<TIndex, TFloat> fft(n);
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute(work.data(), pool);
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_FourStepFft<float>)
+        ->Name("FourStepFft/float")
+        ->ArgsProduct({{1 << 18, 1 << 20, 1 << 22}, {1, 2, 4, 8, 16, 32}})
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_FftPlanCompute<float>)
+        ->Name("FftPlanCompute/float/large")
+        ->Arg(1 << 18)
+        ->Arg(1 << 20)
+        ->Arg(1 << 22)
+        ->Unit(benchmark::kMillisecond);
+
+    template<TIndex N>
+    static void BM_Fft2D(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+        const size_t thread_count = static_cast<size_t>(state.range(0));
+
+        // prepare random square matrix
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(N * N), work(N * N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        FFT::FftThreadPool pool(thread_count);
+        FFT::Fft2D<TIndex, TFloat, N, N> fft;
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute(work.data(), pool);
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_Fft2D<512u>)->Name("Fft2D/float/512")->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_Fft2D<1024u>)->Name("Fft2D/float/1024")->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+    template<TIndex N>
+    static void BM_Fft2DNaive(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random square matrix
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(N * N), work(N * N), column(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        // the hand-rolled row-then-strided-column loop which Fft2D replaces
+        TFft<TFloat, N> fft;
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            for (TIndex r = 0u; r < N; ++r) {
+                fft.compute(work.data() + r * N);
+            }
+            for (TIndex c = 0u; c < N; ++c) {
+                for (TIndex r = 0u; r < N; ++r) column[r] = work[r * N + c];
+                fft.compute(column.data());
+                for (TIndex r = 0u; r < N; ++r) work[r * N + c] = column[r];
+            }
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_Fft2DNaive<512u>)->Name("Fft2DNaive/float/512")->Unit(benchmark::kMillisecond);
+    BENCHMARK(BM_Fft2DNaive<1024u>)->Name("Fft2DNaive/float/1024")->Unit(benchmark::kMillisecond);
+
+    static void BM_FftParallel(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+        constexpr TIndex N = 2048u;
+        const TIndex count = static_cast<TIndex>(state.range(0));
+        const size_t thread_count = static_cast<size_t>(state.range(1));
+
+        // prepare random independent frames
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(N * count), work(N * count);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        FFT::FftThreadPool pool(thread_count);
+        TFft<TFloat, N> fft;
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.parallel_compute(work.data(), count, pool);
+            benchmark::DoNotOptimize(work.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(count));
+    }
+    // small batch is executed inline, so it should cost the same as computing frames one by one
+    BENCHMARK(BM_FftParallel)
+        ->Name("FftParallel/float/2048")
+        ->Args({4, 1})
+        ->Args({4, 4})
+        ->Args({1024, 1})
+        ->Args({1024, 4})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+
+    template<typename TFloat, TIndex N, bool VSplit>
+    static void BM_FftSplit(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random split-complex buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> buf_re(N), buf_im(N), re(N), im(N);
+        std::generate(buf_re.begin(), buf_re.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+        std::generate(buf_im.begin(), buf_im.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // split-complex entry point, or the caller-managed interleaving which it replaces
+        TFft<TFloat, N> fft;
+        std::vector<TComplex> interleaved(N);
+        for (auto _ : state) {
+            std::copy(buf_re.begin(), buf_re.end(), re.begin());
+            std::copy(buf_im.begin(), buf_im.end(), im.begin());
+            if constexpr (VSplit) {
+                fft.compute(re.data(), im.data());
+            } else {
+                for (TIndex i = 0u; i < N; ++i) interleaved[i] = TComplex(re[i], im[i]);
+                fft.compute(interleaved.data());
+                for (TIndex i = 0u; i < N; ++i) {
+                    re[i] = interleaved[i].real();
+                    im[i] = interleaved[i].imag();
+                }
+            }
+            benchmark::DoNotOptimize(re.data());
+            benchmark::DoNotOptimize(im.data());
+        }
+    }
+    BENCHMARK(BM_FftSplit<float, 1024u, true>)->Name("FftSplit/float/1024");
+    BENCHMARK(BM_FftSplit<float, 1024u, false>)->Name("FftSplitInterleaved/float/1024");
+    BENCHMARK(BM_FftSplit<float, 4096u, true>)->Name("FftSplit/float/4096");
+    BENCHMARK(BM_FftSplit<float, 4096u, false>)->Name("FftSplitInterleaved/float/4096");
+    BENCHMARK(BM_FftSplit<float, 16384u, true>)->Name("FftSplit/float/16384");
+    BENCHMARK(BM_FftSplit<float, 16384u, false>)->Name("FftSplitInterleaved/float/16384");
+    BENCHMARK(BM_FftSplit<double, 1024u, true>)->Name("FftSplit/double/1024");
+    BENCHMARK(BM_FftSplit<double, 1024u, false>)->Name("FftSplitInterleaved/double/1024");
+    BENCHMARK(BM_FftSplit<double, 4096u, true>)->Name("FftSplit/double/4096");
+    BENCHMARK(BM_FftSplit<double, 4096u, false>)->Name("FftSplitInterleaved/double/4096");
+
+    static void BM_FftConstruct(benchmark::State& state) {
+        // constructing FFT should be free because all tables are shared per point.
+        for (auto _ : state) {
+            TFft<float, 1024u> fft;
+            benchmark::DoNotOptimize(&fft);
+        }
+    }
+    BENCHMARK(BM_FftConstruct)->Name("FftConstruct/float/1024");
+
+    template<typename TFloat, TIndex N>
+    static void BM_FftComputeBatch(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const TIndex channels = static_cast<TIndex>(state.range(0));
+
+        // prepare random interleaved buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(N * channels), work(N * channels);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        TFft<TFloat, N> fft;
+        // do benchmark
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute_batch(work.data(), channels, channels);
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_FftComputeBatch<float, 1024u>)->Name("FftComputeBatch/float/1024")->Arg(32)->Arg(64);
+
+    template<typename TFloat, TIndex N>
+    static void BM_FftComputeLoop(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const TIndex channels = static_cast<TIndex>(state.range(0));
+
+        // prepare random separated buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TComplex> buf(N * channels), work(N * channels);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex { return TComplex(rnd_dist(rnd_engine)); });
+
+        TFft<TFloat, N> fft;
+        // do benchmark with the same amount of copy
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            for (TIndex c = 0u; c < channels; ++c) {
+                fft.compute(work.data() + c * N);
+            }
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_FftComputeLoop<float, 1024u>)->Name("FftComputeLoop/float/1024")->Arg(32)->Arg(64);
+
+    template<typename TFloat, TIndex N, bool VReal>
+    static void BM_RealFftCompute(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TFloat> buf(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // real FFT, or N point complex FFT on the same real numbers which it should take about a half time of
+        FFT::RealFft<TIndex, TFloat, N> real_fft;
+        TFft<TFloat, N> complex_fft;
+        std::vector<TComplex> work(VReal ? N / 2u + 1u : N);
         // do benchmark
         for (auto _ : state) {
-            fft.compute(buffer_collection[state.iterations() % RND_BUF_CNT].data());
+            if constexpr (VReal) {
+                real_fft.compute(buf.data(), work.data());
+            } else {
+                std::copy(buf.begin(), buf.end(), work.begin());
+                complex_fft.compute(work.data());
+            }
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_RealFftCompute<float, 256u, true>)->Name("RealFftCompute/float/256");
+    BENCHMARK(BM_RealFftCompute<float, 256u, false>)->Name("RealFftAsComplex/float/256");
+    BENCHMARK(BM_RealFftCompute<float, 1024u, true>)->Name("RealFftCompute/float/1024");
+    BENCHMARK(BM_RealFftCompute<float, 1024u, false>)->Name("RealFftAsComplex/float/1024");
+    BENCHMARK(BM_RealFftCompute<float, 4096u, true>)->Name("RealFftCompute/float/4096");
+    BENCHMARK(BM_RealFftCompute<float, 4096u, false>)->Name("RealFftAsComplex/float/4096");
+    BENCHMARK(BM_RealFftCompute<double, 1024u, true>)->Name("RealFftCompute/double/1024");
+    BENCHMARK(BM_RealFftCompute<double, 1024u, false>)->Name("RealFftAsComplex/double/1024");
+
+    template<typename TFloat, TIndex N>
+    static void BM_FriendlyFftEasyCompute(benchmark::State& state) {
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TFloat> buf(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // prepare FFT engine, window and output buffer
+        FFT::FriendlyFft<TIndex, TFloat, N> fft;
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TFloat> freq(N / 2u);
+        // do benchmark
+        for (auto _ : state) {
+            fft.easy_compute(buf.data(), freq.data(), window);
+            benchmark::DoNotOptimize(freq.data());
+        }
+    }
+    BENCHMARK(BM_FriendlyFftEasyCompute<float, 1024u>)->Name("FriendlyFftEasyCompute/float/1024");
+
+    template<typename TFloat, TIndex N>
+    static void BM_AmplitudeDb(benchmark::State& state) {
+        // prepare random complex spectrum
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<std::complex<TFloat>> spectrum(N);
+        std::generate(spectrum.begin(), spectrum.end(), [&rnd_engine, &rnd_dist]() mutable -> std::complex<TFloat> {
+            return std::complex<TFloat>(rnd_dist(rnd_engine), rnd_dist(rnd_engine));
+        });
+        std::vector<TFloat> amplitude(N);
+        // do benchmark with fused power and fast logarithm kernel
+        for (auto _ : state) {
+            FFT::util::amplitude_db<TIndex, TFloat>(spectrum.data(), amplitude.data(), N);
+            benchmark::DoNotOptimize(amplitude.data());
         }
     }
-    BENCHMARK(BM_FftCompute)->Name("FftCompute");
+    BENCHMARK(BM_AmplitudeDb<float, 512u>)->Name("AmplitudeDb/float/512");
+    BENCHMARK(BM_AmplitudeDb<double, 512u>)->Name("AmplitudeDb/double/512");
+
+    template<typename TFloat, TIndex N>
+    static void BM_AmplitudeDbStd(benchmark::State& state) {
+        // prepare random complex spectrum
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<std::complex<TFloat>> spectrum(N);
+        std::generate(spectrum.begin(), spectrum.end(), [&rnd_engine, &rnd_dist]() mutable -> std::complex<TFloat> {
+            return std::complex<TFloat>(rnd_dist(rnd_engine), rnd_dist(rnd_engine));
+        });
+        std::vector<TFloat> amplitude(N);
+        // do benchmark with std::abs and std::log10 as reference
+        for (auto _ : state) {
+            for (TIndex i = 0u; i < N; ++i) {
+                amplitude[i] = static_cast<TFloat>(10) * std::log10(std::abs(spectrum[i]));
+            }
+            benchmark::DoNotOptimize(amplitude.data());
+        }
+    }
+    BENCHMARK(BM_AmplitudeDbStd<float, 512u>)->Name("AmplitudeDbStd/float/512");
+    BENCHMARK(BM_AmplitudeDbStd<double, 512u>)->Name("AmplitudeDbStd/double/512");
+
+    template<typename TFloat, TIndex N, bool VExplicit>
+    static void BM_ComplexButterfly(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random data and unit twiddle factors
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TComplex> buf(N), work(N), twiddles(N / 2u);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex {
+            return TComplex(rnd_dist(rnd_engine), rnd_dist(rnd_engine));
+        });
+        for (TIndex i = 0u; i < N / 2u; ++i) {
+            twiddles[i] = std::polar(static_cast<TFloat>(1), -FFT::util::tau_v<TFloat> * static_cast<TFloat>(i) / static_cast<TFloat>(N));
+        }
+
+        // one scalar radix-2 stage, with std::complex multiplication (lowered to __mulsc3 / __muldc3 without fast-math)
+        // or explicit arithmetic used by FFT kernels
+        constexpr TIndex HALF = N / 2u;
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            for (TIndex i = 0u; i < HALF; ++i) {
+                TComplex t;
+                if constexpr (VExplicit) t = FFT::util::complex_multiply(work[i + HALF], twiddles[i]);
+                else t = work[i + HALF] * twiddles[i];
+                work[i + HALF] = work[i] - t;
+                work[i] += t;
+            }
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_ComplexButterfly<float, 1024u, false>)->Name("ComplexButterflyStd/float/1024");
+    BENCHMARK(BM_ComplexButterfly<float, 1024u, true>)->Name("ComplexButterfly/float/1024");
+    BENCHMARK(BM_ComplexButterfly<double, 1024u, false>)->Name("ComplexButterflyStd/double/1024");
+    BENCHMARK(BM_ComplexButterfly<double, 1024u, true>)->Name("ComplexButterfly/double/1024");
+
+    template<typename TFloat, TIndex N>
+    static void BM_WindowApplyReversed(benchmark::State& state) {
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TFloat> buf(N), work(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::BlackmanHarrisWindow);
+        // do benchmark with fused reversed copy and multiplication
+        for (auto _ : state) {
+            window.apply_window(buf.data(), work.data(), true);
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_WindowApplyReversed<float, 1024u>)->Name("WindowApplyReversed/float/1024");
+
+    template<typename TFloat, TIndex N>
+    static void BM_WindowTransformReversed(benchmark::State& state) {
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TFloat> buf(N), work(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::BlackmanHarrisWindow);
+        // do benchmark with the element-by-element loop which fused kernel replaces
+        for (auto _ : state) {
+            std::transform(buf.rbegin(), buf.rend(), window.get_window_data(), work.begin(), std::multiplies<TFloat>());
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_WindowTransformReversed<float, 1024u>)->Name("WindowTransformReversed/float/1024");
+
+    static void BM_WindowConstruct(benchmark::State& state) {
+        // window function data is shared while any instance uses it, so constructing window is only a cache lookup.
+        FFT::Window<TIndex, float, 1024u> alive_window(FFT::WindowType::KaiserWindow);
+        for (auto _ : state) {
+            FFT::Window<TIndex, float, 1024u> window(FFT::WindowType::KaiserWindow);
+            benchmark::DoNotOptimize(window.get_window_data());
+        }
+    }
+    BENCHMARK(BM_WindowConstruct)->Name("WindowConstruct/float/1024");
+
+    template<TIndex BLOCK>
+    static void BM_ConvolverProcess(benchmark::State& state) {
+        using TFloat = float;
+        const TIndex impulse_len = static_cast<TIndex>(state.range(0));
+
+        // prepare random impulse and input block
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> impulse(impulse_len), input(BLOCK), output(BLOCK);
+        std::generate(impulse.begin(), impulse.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+        std::generate(input.begin(), input.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        FFT::Convolver<TIndex, TFloat, BLOCK> convolver(impulse.data(), impulse_len);
+        // do benchmark
+        for (auto _ : state) {
+            convolver.process(input.data(), output.data());
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+    BENCHMARK(BM_ConvolverProcess<256u>)->Name("ConvolverProcess/float/256")->Arg(256)->Arg(4096);
+
+    template<TIndex BLOCK>
+    static void BM_DirectConvolution(benchmark::State& state) {
+        using TFloat = float;
+        const TIndex impulse_len = static_cast<TIndex>(state.range(0));
+
+        // prepare random impulse and input history
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> impulse(impulse_len), input(impulse_len + BLOCK), output(BLOCK);
+        std::generate(impulse.begin(), impulse.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+        std::generate(input.begin(), input.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // do benchmark with time-domain loop producing the same amount of output
+        for (auto _ : state) {
+            for (TIndex n = 0u; n < BLOCK; ++n) {
+                TFloat sum = 0.0f;
+                const TFloat* window = input.data() + n + impulse_len - 1u;
+                for (TIndex k = 0u; k < impulse_len; ++k) {
+                    sum += impulse[k] * *(window - k);
+                }
+                output[n] = sum;
+            }
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+    BENCHMARK(BM_DirectConvolution<256u>)->Name("DirectConvolution/float/256")->Arg(256)->Arg(4096);
+
+
+    template<TIndex N, TIndex HOP>
+    static void BM_StftStream(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random hop block
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> block(HOP);
+        std::generate(block.begin(), block.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        FFT::Stft<TIndex, TFloat, N> stft(HOP);
+        std::vector<TComplex> frame(N / 2u + 1u);
+        // do benchmark with one hop per iteration
+        for (auto _ : state) {
+            stft.push(block.data(), HOP);
+            while (stft.pop_frame(frame.data())) {
+                benchmark::DoNotOptimize(frame.data());
+            }
+        }
+    }
+    BENCHMARK(BM_StftStream<1024u, 256u>)->Name("StftStream/float/1024/256");
+
+    template<TIndex N, TIndex HOP>
+    static void BM_SlidingWindowCopy(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random hop block
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> block(HOP);
+        std::generate(block.begin(), block.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // the caller-managed sliding window which STFT replaces
+        FFT::RealFft<TIndex, TFloat, N> fft;
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TFloat> history(N), slice(N);
+        std::vector<TComplex> frame(N / 2u + 1u);
+        for (auto _ : state) {
+            std::copy(history.begin() + HOP, history.end(), history.begin());
+            std::copy(block.begin(), block.end(), history.end() - HOP);
+            std::copy(history.begin(), history.end(), slice.begin());
+            window.apply_window(slice.data());
+            fft.compute(slice.data(), frame.data());
+            benchmark::DoNotOptimize(frame.data());
+        }
+    }
+    BENCHMARK(BM_SlidingWindowCopy<1024u, 256u>)->Name("SlidingWindowCopy/float/1024/256");
+
+    template<TIndex N>
+    static void BM_GoertzelCompute(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> buf(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // spread given count of bins over spectrum
+        const TIndex count = static_cast<TIndex>(state.range(0));
+        std::vector<TFloat> bins(count);
+        for (TIndex k = 0u; k < count; ++k) bins[k] = static_cast<TFloat>(N / 2u) * static_cast<TFloat>(k + 1u) / static_cast<TFloat>(count + 1u);
+
+        FFT::Goertzel<TIndex, TFloat, N> goertzel(bins.data(), count);
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TComplex> spectrum(count);
+        for (auto _ : state) {
+            goertzel.compute(buf.data(), spectrum.data(), window);
+            benchmark::DoNotOptimize(spectrum.data());
+        }
+    }
+    BENCHMARK(BM_GoertzelCompute<1024u>)->Name("GoertzelCompute/float/1024")->Arg(3)->Arg(10);
+
+    template<TIndex N, TIndex HOP>
+    static void BM_SlidingDftStream(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random hop block
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> block(HOP);
+        std::generate(block.begin(), block.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // spread given count of bins over spectrum
+        const TIndex count = static_cast<TIndex>(state.range(0));
+        std::vector<TFloat> bins(count);
+        for (TIndex k = 0u; k < count; ++k) bins[k] = static_cast<TFloat>(N / 2u) * static_cast<TFloat>(k + 1u) / static_cast<TFloat>(count + 1u);
+
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        FFT::SlidingDft<TIndex, TFloat, N> sliding(bins.data(), count, window);
+        std::vector<TComplex> spectrum(count);
+        // do benchmark with one hop per iteration, comparable with STFT stream
+        for (auto _ : state) {
+            sliding.push(block.data(), HOP);
+            sliding.get_spectrum(spectrum.data());
+            benchmark::DoNotOptimize(spectrum.data());
+        }
+    }
+    BENCHMARK(BM_SlidingDftStream<1024u, 256u>)->Name("SlidingDftStream/float/1024/256")->Arg(3)->Arg(10);
+
+
+    template<TIndex N, TIndex HOP>
+    static void BM_WelchPsdStream(benchmark::State& state) {
+        using TFloat = float;
+
+        // prepare random hop block
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> block(HOP);
+        std::generate(block.begin(), block.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        FFT::WelchPsd<TIndex, TFloat, N> welch(HOP, FFT::PsdAveraging::Exponential, 16u);
+        // do benchmark with one hop per iteration, reading estimate in decibel every 16 hops
+        std::vector<TFloat> psd(N / 2u + 1u);
+        for (auto _ : state) {
+            welch.push(block.data(), HOP);
+            if (state.iterations() % 16u == 0u) {
+                welch.get_psd_db(psd.data(), 48000.0f);
+                benchmark::DoNotOptimize(psd.data());
+            }
+        }
+    }
+    BENCHMARK(BM_WelchPsdStream<1024u, 512u>)->Name("WelchPsdStream/float/1024/512");
+
+    template<TIndex N, TIndex HOP>
+    static void BM_EasyComputeDbAverage(benchmark::State& state) {
+        using TFloat = float;
+
+        // prepare random hop block
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> block(HOP);
+        std::generate(block.begin(), block.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // the caller-managed averaging of decibel which WelchPsd replaces
+        FFT::FriendlyFft<TIndex, TFloat, N> fft;
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TFloat> history(N), freq(N / 2u), average(N / 2u);
+        for (auto _ : state) {
+            std::copy(history.begin() + HOP, history.end(), history.begin());
+            std::copy(block.begin(), block.end(), history.end() - HOP);
+            fft.easy_compute(history.data(), freq.data(), window);
+            for (TIndex i = 0u; i < N / 2u; ++i) {
+                average[i] += (freq[i] - average[i]) / 16.0f;
+            }
+            benchmark::DoNotOptimize(average.data());
+        }
+    }
+    BENCHMARK(BM_EasyComputeDbAverage<1024u, 512u>)->Name("EasyComputeDbAverage/float/1024/512");
+
+    template<TIndex N, TIndex MELS>
+    static void BM_MelFilterbankMfcc(benchmark::State& state) {
+        using TFloat = float;
+
+        // prepare random power spectrum
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TFloat> power(N / 2u + 1u), mfcc(13u);
+        std::generate(power.begin(), power.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        FFT::MelFilterbank<TIndex, TFloat, N> mel(16000.0f, MELS);
+        for (auto _ : state) {
+            mel.apply_mfcc(power.data(), mfcc.data(), 13u);
+            benchmark::DoNotOptimize(mfcc.data());
+        }
+    }
+    BENCHMARK(BM_MelFilterbankMfcc<512u, 40u>)->Name("MelFilterbankMfcc/float/512/40");
+
+    template<TIndex N, TIndex MELS>
+    static void BM_DenseMelMfcc(benchmark::State& state) {
+        using TFloat = float;
+        constexpr TIndex BINS = N / 2u + 1u;
+
+        // prepare random power spectrum
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(0.0f, 1.0f);
+        std::vector<TFloat> power(BINS), energies(MELS), mfcc(13u);
+        std::generate(power.begin(), power.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // the caller-managed dense mel matrix and DCT-II which MelFilterbank replaces
+        FFT::MelFilterbank<TIndex, TFloat, N> mel(16000.0f, MELS);
+        std::vector<TFloat> matrix(MELS * BINS, 0.0f), dct(13u * MELS);
+        for (TIndex m = 0u; m < MELS; ++m) {
+            auto [start, weights] = mel.get_filter(m);
+            std::copy(weights.begin(), weights.end(), matrix.begin() + m * BINS + start);
+        }
+        for (TIndex j = 0u; j < 13u; ++j) {
+            for (TIndex m = 0u; m < MELS; ++m) {
+                dct[j * MELS + m] = static_cast<TFloat>(std::cos(std::numbers::pi * j * (m + 0.5) / MELS));
+            }
+        }
+        for (auto _ : state) {
+            for (TIndex m = 0u; m < MELS; ++m) {
+                TFloat sum = 0.0f;
+                for (TIndex k = 0u; k < BINS; ++k) sum += matrix[m * BINS + k] * power[k];
+                energies[m] = 10.0f * std::log10(sum);
+            }
+            for (TIndex j = 0u; j < 13u; ++j) {
+                TFloat sum = 0.0f;
+                for (TIndex m = 0u; m < MELS; ++m) sum += dct[j * MELS + m] * energies[m];
+                mfcc[j] = sum;
+            }
+            benchmark::DoNotOptimize(mfcc.data());
+        }
+    }
+    BENCHMARK(BM_DenseMelMfcc<512u, 40u>)->Name("DenseMelMfcc/float/512/40");
+
+    template<typename TDct, TIndex N>
+    static void BM_DctCompute(benchmark::State& state) {
+        using TFloat = float;
+
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> src(N), dst(N);
+        std::generate(src.begin(), src.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        TDct dct;
+        for (auto _ : state) {
+            dct.compute(src.data(), dst.data());
+            benchmark::DoNotOptimize(dst.data());
+        }
+    }
+    BENCHMARK(BM_DctCompute<FFT::DctII<TIndex, float, 256u>, 256u>)->Name("DctIICompute/float/256");
+    BENCHMARK(BM_DctCompute<FFT::DctII<TIndex, float, 1024u>, 1024u>)->Name("DctIICompute/float/1024");
+    BENCHMARK(BM_DctCompute<FFT::DctIV<TIndex, float, 256u>, 256u>)->Name("DctIVCompute/float/256");
+    BENCHMARK(BM_DctCompute<FFT::DctIV<TIndex, float, 1024u>, 1024u>)->Name("DctIVCompute/float/1024");
+
+    template<TIndex N>
+    static void BM_MatrixDctCompute(benchmark::State& state) {
+        using TFloat = float;
+
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> src(N), dst(N);
+        std::generate(src.begin(), src.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // the caller-managed DCT-II matrix which DctII replaces
+        std::vector<TFloat> matrix(N * N);
+        for (TIndex k = 0u; k < N; ++k) {
+            for (TIndex n = 0u; n < N; ++n) {
+                matrix[k * N + n] = static_cast<TFloat>(std::cos(std::numbers::pi * static_cast<double>((2u * n + 1u) * k) / (2.0 * N)));
+            }
+        }
+        for (auto _ : state) {
+            for (TIndex k = 0u; k < N; ++k) {
+                TFloat sum = 0.0f;
+                for (TIndex n = 0u; n < N; ++n) sum += matrix[k * N + n] * src[n];
+                dst[k] = sum;
+            }
+            benchmark::DoNotOptimize(dst.data());
+        }
+    }
+    BENCHMARK(BM_MatrixDctCompute<256u>)->Name("MatrixDctCompute/float/256");
+    BENCHMARK(BM_MatrixDctCompute<1024u>)->Name("MatrixDctCompute/float/1024");
+
+    template<TIndex N, TIndex COLUMNS>
+    static void BM_SpectrumBinner(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random spectrum
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TComplex> spectrum(N / 2u + 1u);
+        std::vector<TFloat> columns_db(COLUMNS);
+        std::generate(spectrum.begin(), spectrum.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex {
+            return TComplex(rnd_dist(rnd_engine), rnd_dist(rnd_engine));
+        });
+
+        FFT::SpectrumBinner<TIndex, TFloat, N> binner(48000.0f, COLUMNS);
+        binner.enable_peak_hold(0.5f);
+        for (auto _ : state) {
+            binner.apply(spectrum.data(), columns_db.data());
+            benchmark::DoNotOptimize(columns_db.data());
+        }
+    }
+    BENCHMARK(BM_SpectrumBinner<4096u, 200u>)->Name("SpectrumBinner/float/4096/200");
+
+    template<TIndex N, TIndex COLUMNS>
+    static void BM_PerBinDbBinning(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+        constexpr TIndex BINS = N / 2u + 1u;
+
+        // prepare random spectrum
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TComplex> spectrum(BINS);
+        std::vector<TFloat> bins_db(BINS), columns_db(COLUMNS), held(COLUMNS, -1000.0f);
+        std::generate(spectrum.begin(), spectrum.end(), [&rnd_engine, &rnd_dist]() mutable -> TComplex {
+            return TComplex(rnd_dist(rnd_engine), rnd_dist(rnd_engine));
+        });
+
+        // the caller-managed loop which converts every bin into decibel and then takes maximum per column
+        FFT::SpectrumBinner<TIndex, TFloat, N> binner(48000.0f, COLUMNS);
+        std::vector<std::pair<TIndex, TIndex>> columns(COLUMNS);
+        for (TIndex c = 0u; c < COLUMNS; ++c) columns[c] = binner.get_column(c);
+        for (auto _ : state) {
+            for (TIndex k = 0u; k < BINS; ++k) bins_db[k] = 10.0f * std::log10(std::abs(spectrum[k]));
+            for (TIndex c = 0u; c < COLUMNS; ++c) {
+                auto [start, length] = columns[c];
+                TFloat value = *std::max_element(bins_db.begin() + start, bins_db.begin() + start + length);
+                held[c] = std::max(value, held[c] - 0.5f);
+                columns_db[c] = held[c];
+            }
+            benchmark::DoNotOptimize(columns_db.data());
+        }
+    }
+    BENCHMARK(BM_PerBinDbBinning<4096u, 200u>)->Name("PerBinDbBinning/float/4096/200");
+
+    template<TIndex N>
+    static void BM_ChirpZCompute(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> buf(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // zoom into 8 bins with given count of evaluated bins
+        const TIndex count = static_cast<TIndex>(state.range(0));
+        FFT::ChirpZ<TIndex, TFloat, N> czt(100.0f, 108.0f, count);
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TComplex> spectrum(count);
+        for (auto _ : state) {
+            czt.compute(buf.data(), spectrum.data(), window);
+            benchmark::DoNotOptimize(spectrum.data());
+        }
+    }
+    BENCHMARK(BM_ChirpZCompute<1024u>)->Name("ChirpZCompute/float/1024")->Arg(256);
+
+    template<TIndex N>
+    static void BM_ZeroPaddedZoom(benchmark::State& state) {
+        using TFloat = float;
+        using TComplex = std::complex<TFloat>;
+
+        // prepare random real-number buffer
+        std::random_device rnd_device;
+        std::default_random_engine rnd_engine(rnd_device());
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> buf(N);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+
+        // the brute-force zoom which ChirpZ replaces: zero-pad data into an FFT with given times of point
+        const TIndex n = N * static_cast<TIndex>(state.range(0));
+        auto plan = FFT::FftPlanCache<TIndex, TFloat>::get(n);
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TComplex> work(n);
+        for (auto _ : state) {
+            window.apply_window(buf.data(), work.data());
+            std::fill(work.begin() + N, work.end(), TComplex(0));
+            plan->compute(work.data());
+            benchmark::DoNotOptimize(work.data());
+        }
+    }
+    BENCHMARK(BM_ZeroPaddedZoom<1024u>)->Name("ZeroPaddedZoom/float/1024")->Arg(32);
+
+#pragma region Suite
+
+    // The suite below measures FFT engines over a wide range of points with the same input,
+    // and reports throughput and accuracy together, so that every optimization can be judged on both.
+    // Reported counters:
+    // - FLOPS: the nominal 5 * N * log2(N) floating point operations of complex FFT per second.
+    //   Naive DFT uses the same nominal count, so that it is comparable with FFT.
+    // - items_per_second: the count of processed samples per second.
+    // - max_err and rms_err: the error against the same transform computed in higher precision
+    //   (double for float, long double for double), measured once before timing.
+    //   They are not reported if long double has no more precision than double (e.g. MSVC),
+    //   because the error against the same precision is meaningless.
+    //   For complex spectrum, they are relative to the largest and the RMS magnitude of reference respectively.
+    //   For FriendlyFft::easy_compute(), they are the absolute error of amplitude in decibel.
+
+    constexpr TIndex SUITE_MIN_POWER = 4u;   ///< The smallest point is 16.
+    constexpr TIndex SUITE_MAX_POWER = 16u;  ///< The largest point is 65536.
+    constexpr TIndex SUITE_NAIVE_MAX_POWER = 12u; ///< Naive DFT is O(N^2), so it stops at 4096 points.
+
+    /// @brief The type of reference computation, which has higher precision than benchmarked type.
+    template<typename TFloat>
+    using TSuiteReference = std::conditional_t<std::is_same_v<TFloat, float>, double, long double>;
+
+    /// @brief Whether the reference type really has more significant bits than benchmarked type.
+    template<typename TFloat>
+    constexpr bool SUITE_HAS_REFERENCE = std::numeric_limits<TSuiteReference<TFloat>>::digits > std::numeric_limits<TFloat>::digits;
+
+    template<typename TFloat>
+    static std::vector<TFloat> make_suite_input(TIndex n) {
+        // fixed seed so that the accuracy of different runs are comparable
+        std::default_random_engine rnd_engine(20240607u);
+        std::uniform_real_distribution<TFloat> rnd_dist(-1.0f, 1.0f);
+        std::vector<TFloat> buf(n);
+        std::generate(buf.begin(), buf.end(), [&rnd_engine, &rnd_dist]() mutable -> TFloat { return rnd_dist(rnd_engine); });
+        return buf;
+    }
+
+    template<typename TFloat, TIndex N>
+    static void set_suite_counters(benchmark::State& state) {
+        constexpr double FLOP = 5.0 * static_cast<double>(N) * static_cast<double>(std::bit_width(N) - 1u);
+        state.counters["FLOPS"] = benchmark::Counter(FLOP, benchmark::Counter::kIsIterationInvariantRate);
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(N));
+    }
+
+    template<typename TFloat, typename TReference>
+    static void set_spectrum_error(benchmark::State& state, const std::complex<TFloat>* actual, const std::complex<TReference>* expected, TIndex n) {
+        double max_err = 0.0, max_mag = 0.0, err_power = 0.0, ref_power = 0.0;
+        for (TIndex i = 0u; i < n; ++i) {
+            std::complex<double> ref(static_cast<double>(expected[i].real()), static_cast<double>(expected[i].imag()));
+            std::complex<double> diff = std::complex<double>(actual[i]) - ref;
+            max_err = std::max(max_err, std::abs(diff));
+            max_mag = std::max(max_mag, std::abs(ref));
+            err_power += std::norm(diff);
+            ref_power += std::norm(ref);
+        }
+        state.counters["max_err"] = max_err / max_mag;
+        state.counters["rms_err"] = std::sqrt(err_power / ref_power);
+    }
+
+    /// @brief Compute the reference spectrum of complex sequence converted from real-number input.
+    template<typename TFloat, TIndex N>
+    static std::vector<std::complex<TSuiteReference<TFloat>>> compute_suite_reference(const std::vector<TFloat>& input) {
+        using TReference = TSuiteReference<TFloat>;
+        std::vector<std::complex<TReference>> reference(N);
+        std::transform(input.begin(), input.end(), reference.begin(), [](TFloat v) { return std::complex<TReference>(v); });
+        FFT::Fft<TIndex, TReference, N> fft;
+        fft.compute(reference.data());
+        return reference;
+    }
+
+    template<typename TFloat, TIndex N>
+    static void BM_SuiteFft(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const auto input = make_suite_input<TFloat>(N);
+        std::vector<TComplex> buf(N), work(N);
+        std::transform(input.begin(), input.end(), buf.begin(), [](TFloat v) { return TComplex(v); });
+
+        TFft<TFloat, N> fft;
+        // measure accuracy before timing
+        if constexpr (SUITE_HAS_REFERENCE<TFloat>) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute(work.data());
+            const auto reference = compute_suite_reference<TFloat, N>(input);
+            set_spectrum_error(state, work.data(), reference.data(), N);
+        }
+
+        for (auto _ : state) {
+            std::copy(buf.begin(), buf.end(), work.begin());
+            fft.compute(work.data());
+            benchmark::DoNotOptimize(work.data());
+        }
+        set_suite_counters<TFloat, N>(state);
+    }
+
+    template<typename TFloat, TIndex N>
+    static void BM_SuiteFriendlyFft(benchmark::State& state) {
+        using TReference = TSuiteReference<TFloat>;
+        const auto input = make_suite_input<TFloat>(N);
+        std::vector<TFloat> freq(N / 2u);
+
+        FFT::FriendlyFft<TIndex, TFloat, N> fft;
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        // measure accuracy before timing.
+        // The reference follows easy_compute(): window is applied to reversed input, and amplitude is 10 * log10(abs).
+        if constexpr (SUITE_HAS_REFERENCE<TFloat>) {
+            fft.easy_compute(input.data(), freq.data(), window);
+            FFT::Window<TIndex, TReference, N> ref_window(FFT::WindowType::HanningWindow);
+            std::vector<std::complex<TReference>> reference(N);
+            for (TIndex i = 0u; i < N; ++i) {
+                reference[i] = static_cast<TReference>(input[N - 1u - i]) * ref_window.get_window_data()[i];
+            }
+            FFT::Fft<TIndex, TReference, N> ref_fft;
+            ref_fft.compute(reference.data());
+            double max_err = 0.0, err_power = 0.0;
+            for (TIndex i = 0u; i < N / 2u; ++i) {
+                double expected = 10.0 * std::log10(static_cast<double>(std::abs(reference[i])));
+                double err = std::abs(static_cast<double>(freq[i]) - expected);
+                max_err = std::max(max_err, err);
+                err_power += err * err;
+            }
+            state.counters["max_err"] = max_err;
+            state.counters["rms_err"] = std::sqrt(err_power / static_cast<double>(N / 2u));
+        }
+
+        for (auto _ : state) {
+            fft.easy_compute(input.data(), freq.data(), window);
+            benchmark::DoNotOptimize(freq.data());
+        }
+        set_suite_counters<TFloat, N>(state);
+    }
+
+    template<typename TFloat, TIndex N>
+    static void BM_SuiteWindow(benchmark::State& state) {
+        const auto input = make_suite_input<TFloat>(N);
+        std::vector<TFloat> output(N);
+
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        for (auto _ : state) {
+            window.apply_window(input.data(), output.data());
+            benchmark::DoNotOptimize(output.data());
+        }
+        // Window application is exact up to one rounding, so only throughput is reported.
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(N));
+    }
+
+    template<typename TFloat, TIndex N>
+    static void BM_SuiteNaiveDft(benchmark::State& state) {
+        using TComplex = std::complex<TFloat>;
+        const auto input = make_suite_input<TFloat>(N);
+        std::vector<TComplex> output(N);
+
+        // precompute twiddle factors, so that only multiply-accumulate is measured
+        std::vector<TComplex> twiddles(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            double angle = -2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(N);
+            twiddles[i] = TComplex(static_cast<TFloat>(std::cos(angle)), static_cast<TFloat>(std::sin(angle)));
+        }
+        auto naive_dft = [&input, &output, &twiddles]() {
+            for (TIndex k = 0u; k < N; ++k) {
+                TComplex sum(0, 0);
+                for (TIndex i = 0u; i < N; ++i) {
+                    sum += input[i] * twiddles[(k * i) & (N - 1u)];
+                }
+                output[k] = sum;
+            }
+        };
+
+        // measure accuracy before timing
+        if constexpr (SUITE_HAS_REFERENCE<TFloat>) {
+            naive_dft();
+            const auto reference = compute_suite_reference<TFloat, N>(input);
+            set_spectrum_error(state, output.data(), reference.data(), N);
+        }
+
+        for (auto _ : state) {
+            naive_dft();
+            benchmark::DoNotOptimize(output.data());
+        }
+        set_suite_counters<TFloat, N>(state);
+    }
+
+    template<typename TFloat, TIndex N>
+    static void register_suite_point(const char* type_name) {
+        const std::string suffix = std::string(type_name) + "/" + std::to_string(N);
+        benchmark::RegisterBenchmark(("Suite/Fft/" + suffix).c_str(), BM_SuiteFft<TFloat, N>);
+        benchmark::RegisterBenchmark(("Suite/FriendlyFft/" + suffix).c_str(), BM_SuiteFriendlyFft<TFloat, N>);
+        benchmark::RegisterBenchmark(("Suite/Window/" + suffix).c_str(), BM_SuiteWindow<TFloat, N>);
+        if constexpr (N <= (static_cast<TIndex>(1) << SUITE_NAIVE_MAX_POWER)) {
+            benchmark::RegisterBenchmark(("Suite/NaiveDft/" + suffix).c_str(), BM_SuiteNaiveDft<TFloat, N>);
+        }
+    }
+
+    template<typename TFloat, TIndex... VPowers>
+    static void register_suite(const char* type_name, std::integer_sequence<TIndex, VPowers...>) {
+        (register_suite_point<TFloat, static_cast<TIndex>(1) << (SUITE_MIN_POWER + VPowers)>(type_name), ...);
+    }
+
+    static const bool SUITE_REGISTERED = []() {
+        using TPowers = std::make_integer_sequence<TIndex, SUITE_MAX_POWER - SUITE_MIN_POWER + 1u>;
+        register_suite<float>("float", TPowers{});
+        register_suite<double>("double", TPowers{});
+        return true;
+    }();
+
+#pragma endregion
 
 }
@@ -3,6 +3,7 @@
 #include <expected>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 
 namespace yycc::carton::binstore::types {
 
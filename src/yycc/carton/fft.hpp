@@ -1,4 +1,7 @@
 #pragma once
+#include "../macro/class_copy_move.hpp"
+#include "../macro/compiler_detector.hpp"
+#include "binstore.hpp"
 #include <concepts>
 #include <type_traits>
 #include <numbers>
@@ -6,273 +9,7355 @@
 #include <cstdint>
 #include <complex>
 #include <vector>
+#include <array>
 #include <cmath>
+#include <cstdlib>
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <map>
+#include <set>
+#include <tuple>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <span>
+#include <cstring>
+#include <chrono>
+#include <optional>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+
+// Detect which SIMD instruction set can be used by FFT butterflies.
+// It is decided at compile time by the flags passed to compiler (e.g. -mavx2 -mfma or /arch:AVX2).
+// Define YYCC_FFT_NO_SIMD before including this header to force the portable scalar implementation.
+#if !defined(YYCC_FFT_NO_SIMD)
+#if defined(__AVX2__) && (defined(__FMA__) || defined(YYCC_CC_MSVC))
+#define YYCC_FFT_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YYCC_FFT_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+// Detect whether fused multiply-add is an instruction rather than a library call,
+// so that scalar complex multiplication can use std::fma without slowing down.
+#if defined(__FMA__) || (defined(YYCC_CC_MSVC) && defined(__AVX2__))
+#define YYCC_FFT_HAS_FMA
+#endif
+
+// Detect whether compiler supports _Float16 as arithmetic type, which is used as a storage type of HalfFft.
+#if defined(__FLT16_MAX__)
+#define YYCC_FFT_HAS_FLOAT16
+#endif
 
 namespace yycc::carton::fft {
 
+#pragma region Compact Number Types
+
+    /**
+     * @brief The bfloat16 number used as storage type.
+     * @details
+     * It is the upper 16 bits of IEEE 754 single precision number,
+     * so it has the same range as \c float but only 8 significant bits.
+     * It supports no arithmetic, and only can be converted from and into \c float.
+     * The conversion from \c float rounds to nearest even.
+     */
+    struct BFloat16 {
+        std::uint16_t bits; ///< The raw bit pattern.
+
+        BFloat16() = default;
+        constexpr explicit BFloat16(float value) : bits(0) {
+            std::uint32_t v = std::bit_cast<std::uint32_t>(value);
+            if ((v & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+                // Keep NaN as quiet NaN, otherwise rounding may turn it into infinity.
+                bits = static_cast<std::uint16_t>((v >> 16) | UINT32_C(0x0040));
+            } else {
+                bits = static_cast<std::uint16_t>((v + UINT32_C(0x7FFF) + ((v >> 16) & UINT32_C(1))) >> 16);
+            }
+        }
+        constexpr explicit operator float() const { return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16); }
+    };
+
+    /**
+     * @brief The complex number stored in compact number type.
+     * @details
+     * \c std::complex is only specified for standard float-point types,
+     * so fixed-point and half-precision FFT use this plain structure which has the same interleaved layout.
+     * @tparam TValue The type of real and imaginary part.
+     */
+    template<typename TValue>
+    struct CompactComplex {
+        TValue re; ///< The real part.
+        TValue im; ///< The imaginary part.
+    };
+
+#pragma endregion
+
     /// @private
     /// @brief Meta-programming utilities for FFT modules.
     namespace util {
 
-        template<std::floating_point TFloat>
-        inline constexpr TFloat tau_v = static_cast<TFloat>(2) * std::numbers::pi_v<TFloat>;
+        template<std::floating_point TFloat>
+        inline constexpr TFloat tau_v = static_cast<TFloat>(2) * std::numbers::pi_v<TFloat>;
+
+        // NOTE:
+        // We use std::has_single_bit() to check whether given number is an integral power of 2.
+        // And use (std::bit_width() - 1) to get the exponent of given number based on 2.
+
+        template<typename TIndex, typename TFloat, TIndex VN>
+        struct validate_args {
+        private:
+            static constexpr bool is_unsigned_int = std::is_unsigned_v<TIndex> && std::is_integral_v<TIndex>;
+            static constexpr bool is_float_point = std::is_floating_point_v<TFloat>;
+            static constexpr bool n_is_pow_2 = std::has_single_bit<TIndex>(static_cast<TIndex>(VN)) && VN >= static_cast<TIndex>(2);
+
+        public:
+            static constexpr bool value = is_unsigned_int && is_float_point && n_is_pow_2;
+        };
+
+        template<typename TIndex, typename TFloat, TIndex VN>
+        inline constexpr bool validate_args_v = validate_args<TIndex, TFloat, VN>::value;
+
+        template<typename TIndex, typename TFloat>
+        struct validate_plan_args {
+        private:
+            static constexpr bool is_unsigned_int = std::is_unsigned_v<TIndex> && std::is_integral_v<TIndex>;
+            static constexpr bool is_float_point = std::is_floating_point_v<TFloat>;
+
+        public:
+            static constexpr bool value = is_unsigned_int && is_float_point;
+        };
+
+        template<typename TIndex, typename TFloat>
+        inline constexpr bool validate_plan_args_v = validate_plan_args<TIndex, TFloat>::value;
+
+        /**
+         * @brief Validate the arguments of the classes accepting any point >= 2.
+         * @details
+         * The point which is not a power of 2 is computed by mixed-radix Stockham passes if it only has prime factors 2, 3, 5 and 7,
+         * otherwise by Bluestein algorithm.
+         */
+        template<typename TIndex, typename TFloat, TIndex VN>
+        struct validate_mixed_args {
+        private:
+            static constexpr bool is_unsigned_int = std::is_unsigned_v<TIndex> && std::is_integral_v<TIndex>;
+            static constexpr bool is_float_point = std::is_floating_point_v<TFloat>;
+            static constexpr bool n_is_valid = VN >= static_cast<TIndex>(2);
+
+        public:
+            static constexpr bool value = is_unsigned_int && is_float_point && n_is_valid;
+        };
+
+        template<typename TIndex, typename TFloat, TIndex VN>
+        inline constexpr bool validate_mixed_args_v = validate_mixed_args<TIndex, TFloat, VN>::value;
+
+        /// @brief Check whether given type is fixed-point type supported by FixedFft (Q15 or Q31).
+        template<typename TValue>
+        inline constexpr bool is_fixed_point_v = std::is_same_v<TValue, std::int16_t> || std::is_same_v<TValue, std::int32_t>;
+
+        /// @brief Check whether given type is half-precision storage type supported by HalfFft.
+        template<typename TValue>
+        inline constexpr bool is_half_float_v = std::is_same_v<TValue, BFloat16>
+#if defined(YYCC_FFT_HAS_FLOAT16)
+                                                || std::is_same_v<TValue, _Float16>
+#endif
+            ;
+
+        template<typename TIndex, typename TValue, TIndex VN>
+        struct validate_compact_args {
+        private:
+            static constexpr bool is_unsigned_int = std::is_unsigned_v<TIndex> && std::is_integral_v<TIndex>;
+            static constexpr bool is_compact = is_fixed_point_v<TValue> || is_half_float_v<TValue>;
+            static constexpr bool n_is_pow_2 = std::has_single_bit<TIndex>(static_cast<TIndex>(VN)) && VN >= static_cast<TIndex>(2);
+
+        public:
+            static constexpr bool value = is_unsigned_int && is_compact && n_is_pow_2;
+        };
+
+        template<typename TIndex, typename TValue, TIndex VN>
+        inline constexpr bool validate_compact_args_v = validate_compact_args<TIndex, TValue, VN>::value;
+
+        // NOTE:
+        // Without -ffast-math, GCC and Clang lower the multiplication of std::complex into library call __mulsc3 or __muldc3,
+        // which recovers infinity from NaN result as C Annex G requires.
+        // All FFT kernels only multiply finite numbers, so they use complex_multiply() below instead,
+        // which gives the same result as textbook formula for finite numbers and is always inlined.
+
+        /**
+         * @brief Multiply two complex numbers by explicit arithmetic of real parts and imaginary parts.
+         * @details
+         * If fused multiply-add is an instruction on target, each part is computed by one multiplication and one FMA.
+         * The result is correct for finite numbers, but infinity and NaN are not handled like C Annex G.
+         * @param[in] a The multiplicand.
+         * @param[in] b The multiplier.
+         * @return The product of \p a and \p b.
+         */
+        template<typename TFloat>
+        inline std::complex<TFloat> complex_multiply(const std::complex<TFloat>& a, const std::complex<TFloat>& b) {
+#if defined(YYCC_FFT_HAS_FMA)
+            if constexpr (std::is_same_v<TFloat, float> || std::is_same_v<TFloat, double>) {
+                return std::complex<TFloat>(std::fma(a.real(), b.real(), -(a.imag() * b.imag())),
+                                            std::fma(a.real(), b.imag(), a.imag() * b.real()));
+            }
+#endif
+            return std::complex<TFloat>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+        }
+
+        /**
+         * @brief The portable scalar pack holding only one complex number.
+         * @details It is used by ComplexPack as fallback, and by SIMD code path for processing remains.
+         */
+        template<typename TFloat>
+        struct ScalarComplexPack {
+            using TComplex = std::complex<TFloat>;
+            using TReg = TComplex;
+            static constexpr size_t WIDTH = 1u;
+
+            static TReg load(const TComplex* p) { return *p; }
+            static TReg broadcast(const TComplex& v) { return v; }
+            static void store(TComplex* p, TReg v) { *p = v; }
+            static TReg add(TReg a, TReg b) { return a + b; }
+            static TReg sub(TReg a, TReg b) { return a - b; }
+            static TReg mul(TReg a, TReg b) { return complex_multiply(a, b); }
+            static TReg mul_neg_i(TReg a) { return TReg(a.imag(), -a.real()); }
+            static TReg mul_pos_i(TReg a) { return TReg(-a.imag(), a.real()); }
+            /// @brief Multiply real parts and imaginary parts respectively. With <TT>b = (c, c)</TT>, it multiplies \p a by real number c.
+            static TReg mul_parts(TReg a, TReg b) { return TReg(a.real() * b.real(), a.imag() * b.imag()); }
+            static TReg conj(TReg a) { return std::conj(a); }
+            /// @brief Reverse the order of complex numbers in pack.
+            static TReg reverse(TReg a) { return a; }
+        };
+
+        /**
+         * @brief The SIMD abstraction of a pack of interleaved complex numbers.
+         * @details
+         * This primary template is the portable scalar fallback.
+         * Specializations for \c float and \c double use SSE2 or AVX2 registers according to the compile flags,
+         * and hold WIDTH complex numbers in their native interleaved layout (real, imaginary, real, imaginary, ...).
+         * So that they can directly load from and store into the memory of \c std::complex array.
+         */
+        template<typename TFloat>
+        struct ComplexPack : public ScalarComplexPack<TFloat> {};
+
+#if defined(YYCC_FFT_SIMD_AVX2)
+
+        template<>
+        struct ComplexPack<float> {
+            using TComplex = std::complex<float>;
+            using TReg = __m256;
+            static constexpr size_t WIDTH = 4u;
+
+            static TReg load(const TComplex* p) { return _mm256_loadu_ps(reinterpret_cast<const float*>(p)); }
+            static TReg broadcast(const TComplex& v) {
+                return _mm256_setr_ps(v.real(), v.imag(), v.real(), v.imag(), v.real(), v.imag(), v.real(), v.imag());
+            }
+            static void store(TComplex* p, TReg v) { _mm256_storeu_ps(reinterpret_cast<float*>(p), v); }
+            static TReg add(TReg a, TReg b) { return _mm256_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm256_sub_ps(a, b); }
+            static TReg mul_parts(TReg a, TReg b) { return _mm256_mul_ps(a, b); }
+            static TReg mul(TReg a, TReg b) {
+                // (ar * br - ai * bi, ai * br + ar * bi)
+                TReg br = _mm256_moveldup_ps(b);
+                TReg bi = _mm256_movehdup_ps(b);
+                TReg as = _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm256_fmaddsub_ps(a, br, _mm256_mul_ps(as, bi));
+            }
+            static TReg mul_neg_i(TReg a) {
+                // (ai, -ar)
+                TReg as = _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm256_xor_ps(as, _mm256_set_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f));
+            }
+            static TReg mul_pos_i(TReg a) {
+                // (-ai, ar)
+                TReg as = _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm256_xor_ps(as, _mm256_set_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f));
+            }
+            static TReg conj(TReg a) { return _mm256_xor_ps(a, _mm256_set_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f)); }
+            static TReg reverse(TReg a) {
+                // Each complex number is a 64-bit unit.
+                return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(a), _MM_SHUFFLE(0, 1, 2, 3)));
+            }
+        };
+
+        template<>
+        struct ComplexPack<double> {
+            using TComplex = std::complex<double>;
+            using TReg = __m256d;
+            static constexpr size_t WIDTH = 2u;
+
+            static TReg load(const TComplex* p) { return _mm256_loadu_pd(reinterpret_cast<const double*>(p)); }
+            static TReg broadcast(const TComplex& v) { return _mm256_setr_pd(v.real(), v.imag(), v.real(), v.imag()); }
+            static void store(TComplex* p, TReg v) { _mm256_storeu_pd(reinterpret_cast<double*>(p), v); }
+            static TReg add(TReg a, TReg b) { return _mm256_add_pd(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm256_sub_pd(a, b); }
+            static TReg mul_parts(TReg a, TReg b) { return _mm256_mul_pd(a, b); }
+            static TReg mul(TReg a, TReg b) {
+                TReg br = _mm256_movedup_pd(b);
+                TReg bi = _mm256_permute_pd(b, 0xF);
+                TReg as = _mm256_permute_pd(a, 0x5);
+                return _mm256_fmaddsub_pd(a, br, _mm256_mul_pd(as, bi));
+            }
+            static TReg mul_neg_i(TReg a) {
+                TReg as = _mm256_permute_pd(a, 0x5);
+                return _mm256_xor_pd(as, _mm256_set_pd(-0.0, 0.0, -0.0, 0.0));
+            }
+            static TReg mul_pos_i(TReg a) {
+                TReg as = _mm256_permute_pd(a, 0x5);
+                return _mm256_xor_pd(as, _mm256_set_pd(0.0, -0.0, 0.0, -0.0));
+            }
+            static TReg conj(TReg a) { return _mm256_xor_pd(a, _mm256_set_pd(-0.0, 0.0, -0.0, 0.0)); }
+            static TReg reverse(TReg a) { return _mm256_permute2f128_pd(a, a, 0x01); }
+        };
+
+#elif defined(YYCC_FFT_SIMD_SSE2)
+
+        template<>
+        struct ComplexPack<float> {
+            using TComplex = std::complex<float>;
+            using TReg = __m128;
+            static constexpr size_t WIDTH = 2u;
+
+            static TReg load(const TComplex* p) { return _mm_loadu_ps(reinterpret_cast<const float*>(p)); }
+            static TReg broadcast(const TComplex& v) { return _mm_setr_ps(v.real(), v.imag(), v.real(), v.imag()); }
+            static void store(TComplex* p, TReg v) { _mm_storeu_ps(reinterpret_cast<float*>(p), v); }
+            static TReg add(TReg a, TReg b) { return _mm_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_ps(a, b); }
+            static TReg mul_parts(TReg a, TReg b) { return _mm_mul_ps(a, b); }
+            static TReg mul(TReg a, TReg b) {
+                // (ar * br - ai * bi, ai * br + ar * bi)
+                TReg br = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+                TReg bi = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+                TReg as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+                TReg cross = _mm_xor_ps(_mm_mul_ps(as, bi), _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f));
+                return _mm_add_ps(_mm_mul_ps(a, br), cross);
+            }
+            static TReg mul_neg_i(TReg a) {
+                // (ai, -ar)
+                TReg as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm_xor_ps(as, _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+            }
+            static TReg mul_pos_i(TReg a) {
+                // (-ai, ar)
+                TReg as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm_xor_ps(as, _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f));
+            }
+            static TReg conj(TReg a) { return _mm_xor_ps(a, _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f)); }
+            static TReg reverse(TReg a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)); }
+        };
+
+        template<>
+        struct ComplexPack<double> {
+            using TComplex = std::complex<double>;
+            using TReg = __m128d;
+            static constexpr size_t WIDTH = 1u;
+
+            static TReg load(const TComplex* p) { return _mm_loadu_pd(reinterpret_cast<const double*>(p)); }
+            static TReg broadcast(const TComplex& v) { return _mm_setr_pd(v.real(), v.imag()); }
+            static void store(TComplex* p, TReg v) { _mm_storeu_pd(reinterpret_cast<double*>(p), v); }
+            static TReg add(TReg a, TReg b) { return _mm_add_pd(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_pd(a, b); }
+            static TReg mul_parts(TReg a, TReg b) { return _mm_mul_pd(a, b); }
+            static TReg mul(TReg a, TReg b) {
+                TReg br = _mm_unpacklo_pd(b, b);
+                TReg bi = _mm_unpackhi_pd(b, b);
+                TReg as = _mm_shuffle_pd(a, a, 0x1);
+                TReg cross = _mm_xor_pd(_mm_mul_pd(as, bi), _mm_set_pd(0.0, -0.0));
+                return _mm_add_pd(_mm_mul_pd(a, br), cross);
+            }
+            static TReg mul_neg_i(TReg a) {
+                TReg as = _mm_shuffle_pd(a, a, 0x1);
+                return _mm_xor_pd(as, _mm_set_pd(-0.0, 0.0));
+            }
+            static TReg mul_pos_i(TReg a) {
+                TReg as = _mm_shuffle_pd(a, a, 0x1);
+                return _mm_xor_pd(as, _mm_set_pd(0.0, -0.0));
+            }
+            static TReg conj(TReg a) { return _mm_xor_pd(a, _mm_set_pd(-0.0, 0.0)); }
+            static TReg reverse(TReg a) { return a; }
+        };
+
+#endif
+
+        /**
+         * @brief The SIMD pack whose width is a half of ComplexPack.
+         * @details
+         * It is used by the first radix-4 pass of odd exponent point (Q = 2),
+         * whose quarter is less than the width of AVX2 \c float pack (4 complex numbers).
+         * It is the portable scalar pack unless there is a narrower register, and then that pass is computed by scalar code.
+         *
+         * When it holds 2 complex numbers, it also has \c sum_diff() computing <TT>(x0 + x1, x0 - x1)</TT> of them,
+         * so that the extra radix-2 pass of odd exponent point is fused into that radix-4 pass.
+         */
+        template<typename TFloat>
+        struct HalfComplexPack : public ScalarComplexPack<TFloat> {};
+
+#if defined(YYCC_FFT_SIMD_AVX2)
+
+        template<>
+        struct HalfComplexPack<float> {
+            using TComplex = std::complex<float>;
+            using TReg = __m128;
+            static constexpr size_t WIDTH = 2u;
+
+            static TReg load(const TComplex* p) { return _mm_loadu_ps(reinterpret_cast<const float*>(p)); }
+            static void store(TComplex* p, TReg v) { _mm_storeu_ps(reinterpret_cast<float*>(p), v); }
+            static TReg add(TReg a, TReg b) { return _mm_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_ps(a, b); }
+            static TReg mul(TReg a, TReg b) {
+                // The same as ComplexPack<float>::mul() in 128-bit register.
+                TReg br = _mm_moveldup_ps(b);
+                TReg bi = _mm_movehdup_ps(b);
+                TReg as = _mm_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm_fmaddsub_ps(a, br, _mm_mul_ps(as, bi));
+            }
+            static TReg mul_neg_i(TReg a) {
+                TReg as = _mm_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm_xor_ps(as, _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+            }
+            static TReg mul_pos_i(TReg a) {
+                TReg as = _mm_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm_xor_ps(as, _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f));
+            }
+            static TReg sum_diff(TReg a) {
+                // (x1, x0) + (x0, -x1)
+                TReg as = _mm_permute_ps(a, _MM_SHUFFLE(1, 0, 3, 2));
+                return _mm_add_ps(as, _mm_xor_ps(a, _mm_set_ps(-0.0f, -0.0f, 0.0f, 0.0f)));
+            }
+        };
+
+#endif
+
+        /**
+         * @brief The portable scalar pack holding only one real number.
+         * @details It is used by RealPack as fallback, and by SIMD code path for processing remains.
+         */
+        template<typename TFloat>
+        struct ScalarRealPack {
+            using TReg = TFloat;
+            static constexpr size_t WIDTH = 1u;
+
+            static TReg load(const TFloat* p) { return *p; }
+            static void store(TFloat* p, TReg v) { *p = v; }
+            static TReg zero() { return static_cast<TFloat>(0); }
+            /// @brief Fill all items in pack with given value.
+            static TReg broadcast(TFloat v) { return v; }
+            static TReg add(TReg a, TReg b) { return a + b; }
+            static TReg sub(TReg a, TReg b) { return a - b; }
+            static TReg mul(TReg a, TReg b) { return a * b; }
+        };
+
+        /**
+         * @brief The SIMD abstraction of a pack of real numbers.
+         * @details
+         * This primary template is the portable scalar fallback.
+         * Specializations for \c float and \c double use SSE2 or AVX2 registers according to the compile flags,
+         * like ComplexPack.
+         */
+        template<typename TFloat>
+        struct RealPack : public ScalarRealPack<TFloat> {
+            using TReg = TFloat;
+
+            /// @brief Reverse the order of items in pack.
+            static TReg reverse(TReg a) { return a; }
+            /// @brief Store items as complex numbers with zero imaginary part, that is, 2 * WIDTH float-point numbers.
+            static void store_widened(std::complex<TFloat>* p, TReg v) { *p = std::complex<TFloat>(v); }
+        };
+
+#if defined(YYCC_FFT_SIMD_AVX2)
+
+        template<>
+        struct RealPack<float> {
+            using TReg = __m256;
+            static constexpr size_t WIDTH = 8u;
+
+            static TReg load(const float* p) { return _mm256_loadu_ps(p); }
+            static void store(float* p, TReg v) { _mm256_storeu_ps(p, v); }
+            static TReg zero() { return _mm256_setzero_ps(); }
+            static TReg broadcast(float v) { return _mm256_set1_ps(v); }
+            static TReg add(TReg a, TReg b) { return _mm256_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm256_sub_ps(a, b); }
+            static TReg mul(TReg a, TReg b) { return _mm256_mul_ps(a, b); }
+            static TReg reverse(TReg a) { return _mm256_permutevar8x32_ps(a, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+            static void store_widened(std::complex<float>* p, TReg v) {
+                // (v0, 0, v1, 0 | v4, 0, v5, 0) and (v2, 0, v3, 0 | v6, 0, v7, 0)
+                TReg lo = _mm256_unpacklo_ps(v, _mm256_setzero_ps());
+                TReg hi = _mm256_unpackhi_ps(v, _mm256_setzero_ps());
+                float* fp = reinterpret_cast<float*>(p);
+                _mm256_storeu_ps(fp, _mm256_permute2f128_ps(lo, hi, 0x20));
+                _mm256_storeu_ps(fp + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+            }
+            /**
+             * @brief Store 4 packs by blocks of VStride items, that is, <TT>p[(t * 4 + k) * VStride + j] = v[k][t * VStride + j]</TT>.
+             * @details It is the output scatter of split-complex Stockham passes whose stride is less than WIDTH.
+             */
+            template<size_t VStride>
+                requires(VStride == 1u || VStride == 4u)
+            static void store_blocks(float* p, const TReg (&v)[4]) {
+                if constexpr (VStride == 1u) {
+                    // 4 x 8 transpose: unpack pairs, then quads in 128-bit lanes, then exchange lanes.
+                    TReg t0 = _mm256_unpacklo_ps(v[0], v[1]), t1 = _mm256_unpackhi_ps(v[0], v[1]);
+                    TReg t2 = _mm256_unpacklo_ps(v[2], v[3]), t3 = _mm256_unpackhi_ps(v[2], v[3]);
+                    TReg u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+                    TReg u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+                    _mm256_storeu_ps(p, _mm256_permute2f128_ps(u0, u1, 0x20));
+                    _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(u2, u3, 0x20));
+                    _mm256_storeu_ps(p + 16, _mm256_permute2f128_ps(u0, u1, 0x31));
+                    _mm256_storeu_ps(p + 24, _mm256_permute2f128_ps(u2, u3, 0x31));
+                } else {
+                    // Each 128-bit lane is a block, so only lanes are exchanged.
+                    _mm256_storeu_ps(p, _mm256_permute2f128_ps(v[0], v[1], 0x20));
+                    _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(v[2], v[3], 0x20));
+                    _mm256_storeu_ps(p + 16, _mm256_permute2f128_ps(v[0], v[1], 0x31));
+                    _mm256_storeu_ps(p + 24, _mm256_permute2f128_ps(v[2], v[3], 0x31));
+                }
+            }
+        };
+
+        template<>
+        struct RealPack<double> {
+            using TReg = __m256d;
+            static constexpr size_t WIDTH = 4u;
+
+            static TReg load(const double* p) { return _mm256_loadu_pd(p); }
+            static void store(double* p, TReg v) { _mm256_storeu_pd(p, v); }
+            static TReg zero() { return _mm256_setzero_pd(); }
+            static TReg broadcast(double v) { return _mm256_set1_pd(v); }
+            static TReg add(TReg a, TReg b) { return _mm256_add_pd(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm256_sub_pd(a, b); }
+            static TReg mul(TReg a, TReg b) { return _mm256_mul_pd(a, b); }
+            static TReg reverse(TReg a) { return _mm256_permute4x64_pd(a, _MM_SHUFFLE(0, 1, 2, 3)); }
+            static void store_widened(std::complex<double>* p, TReg v) {
+                // (v0, 0 | v2, 0) and (v1, 0 | v3, 0)
+                TReg lo = _mm256_unpacklo_pd(v, _mm256_setzero_pd());
+                TReg hi = _mm256_unpackhi_pd(v, _mm256_setzero_pd());
+                double* fp = reinterpret_cast<double*>(p);
+                _mm256_storeu_pd(fp, _mm256_permute2f128_pd(lo, hi, 0x20));
+                _mm256_storeu_pd(fp + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+            }
+            /// @brief Same as RealPack<float>::store_blocks().
+            template<size_t VStride>
+                requires(VStride == 1u)
+            static void store_blocks(double* p, const TReg (&v)[4]) {
+                // 4 x 4 transpose.
+                TReg t0 = _mm256_unpacklo_pd(v[0], v[1]), t1 = _mm256_unpackhi_pd(v[0], v[1]);
+                TReg t2 = _mm256_unpacklo_pd(v[2], v[3]), t3 = _mm256_unpackhi_pd(v[2], v[3]);
+                _mm256_storeu_pd(p, _mm256_permute2f128_pd(t0, t2, 0x20));
+                _mm256_storeu_pd(p + 4, _mm256_permute2f128_pd(t1, t3, 0x20));
+                _mm256_storeu_pd(p + 8, _mm256_permute2f128_pd(t0, t2, 0x31));
+                _mm256_storeu_pd(p + 12, _mm256_permute2f128_pd(t1, t3, 0x31));
+            }
+        };
+
+#elif defined(YYCC_FFT_SIMD_SSE2)
+
+        template<>
+        struct RealPack<float> {
+            using TReg = __m128;
+            static constexpr size_t WIDTH = 4u;
+
+            static TReg load(const float* p) { return _mm_loadu_ps(p); }
+            static void store(float* p, TReg v) { _mm_storeu_ps(p, v); }
+            static TReg zero() { return _mm_setzero_ps(); }
+            static TReg broadcast(float v) { return _mm_set1_ps(v); }
+            static TReg add(TReg a, TReg b) { return _mm_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_ps(a, b); }
+            static TReg mul(TReg a, TReg b) { return _mm_mul_ps(a, b); }
+            static TReg reverse(TReg a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 1, 2, 3)); }
+            static void store_widened(std::complex<float>* p, TReg v) {
+                float* fp = reinterpret_cast<float*>(p);
+                _mm_storeu_ps(fp, _mm_unpacklo_ps(v, _mm_setzero_ps()));
+                _mm_storeu_ps(fp + 4, _mm_unpackhi_ps(v, _mm_setzero_ps()));
+            }
+            /**
+             * @brief Store 4 packs by blocks of VStride items, that is, <TT>p[(t * 4 + k) * VStride + j] = v[k][t * VStride + j]</TT>.
+             * @details It is the output scatter of split-complex Stockham passes whose stride is less than WIDTH.
+             */
+            template<size_t VStride>
+                requires(VStride == 1u)
+            static void store_blocks(float* p, const TReg (&v)[4]) {
+                // 4 x 4 transpose.
+                TReg t0 = _mm_unpacklo_ps(v[0], v[1]), t1 = _mm_unpackhi_ps(v[0], v[1]);
+                TReg t2 = _mm_unpacklo_ps(v[2], v[3]), t3 = _mm_unpackhi_ps(v[2], v[3]);
+                _mm_storeu_ps(p, _mm_movelh_ps(t0, t2));
+                _mm_storeu_ps(p + 4, _mm_movehl_ps(t2, t0));
+                _mm_storeu_ps(p + 8, _mm_movelh_ps(t1, t3));
+                _mm_storeu_ps(p + 12, _mm_movehl_ps(t3, t1));
+            }
+        };
+
+        template<>
+        struct RealPack<double> {
+            using TReg = __m128d;
+            static constexpr size_t WIDTH = 2u;
+
+            static TReg load(const double* p) { return _mm_loadu_pd(p); }
+            static void store(double* p, TReg v) { _mm_storeu_pd(p, v); }
+            static TReg zero() { return _mm_setzero_pd(); }
+            static TReg broadcast(double v) { return _mm_set1_pd(v); }
+            static TReg add(TReg a, TReg b) { return _mm_add_pd(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_pd(a, b); }
+            static TReg mul(TReg a, TReg b) { return _mm_mul_pd(a, b); }
+            static TReg reverse(TReg a) { return _mm_shuffle_pd(a, a, 0x1); }
+            static void store_widened(std::complex<double>* p, TReg v) {
+                double* fp = reinterpret_cast<double*>(p);
+                _mm_storeu_pd(fp, _mm_unpacklo_pd(v, _mm_setzero_pd()));
+                _mm_storeu_pd(fp + 2, _mm_unpackhi_pd(v, _mm_setzero_pd()));
+            }
+            /// @brief Same as RealPack<float>::store_blocks().
+            template<size_t VStride>
+                requires(VStride == 1u)
+            static void store_blocks(double* p, const TReg (&v)[4]) {
+                _mm_storeu_pd(p, _mm_unpacklo_pd(v[0], v[1]));
+                _mm_storeu_pd(p + 2, _mm_unpacklo_pd(v[2], v[3]));
+                _mm_storeu_pd(p + 4, _mm_unpackhi_pd(v[0], v[1]));
+                _mm_storeu_pd(p + 6, _mm_unpackhi_pd(v[2], v[3]));
+            }
+        };
+
+#endif
+
+        /**
+         * @brief The bit layout of float-point types used by fast_log10().
+         * @details
+         * The primary template is for the types whose layout is unknown,
+         * and fast_log10() will fall back to \c std::log10 for them.
+         */
+        template<typename TFloat>
+        struct FastLogTraits {
+            static constexpr bool SUPPORTED = false;
+        };
+
+        template<>
+        struct FastLogTraits<float> {
+            static constexpr bool SUPPORTED = true;
+            using TBits = std::int32_t;
+            static constexpr int MANTISSA_BITS = 23;
+            /// @brief The bit pattern of 2/3.
+            static constexpr TBits TWO_THIRDS = 0x3F2AAAAB;
+        };
+
+        template<>
+        struct FastLogTraits<double> {
+            static constexpr bool SUPPORTED = true;
+            using TBits = std::int64_t;
+            static constexpr int MANTISSA_BITS = 52;
+            /// @brief The bit pattern of 2/3.
+            static constexpr TBits TWO_THIRDS = 0x3FE5555555555555;
+        };
+
+        // NOTE:
+        // The fast logarithm splits x into 2^e * m with m in [2/3, 4/3) by integer arithmetic on the bit pattern of x:
+        // subtracting the bit pattern of 2/3 and shifting out the mantissa gives e (arithmetic shift rounds it down),
+        // and subtracting e from the exponent field gives m.
+        // Then ln(m) = 2 * atanh(t) = 2 * (t + t^3/3 + t^5/5 + t^7/7 + ...) where t = (m - 1) / (m + 1) lies in [-1/5, 1/7).
+        // The truncated tail of this series is below 2 * (1/5)^9 / 9 / (1 - 1/25) < 1.2e-7 in natural logarithm,
+        // that is, 5.2e-8 in common logarithm (2.6e-7 dB for amplitude computed from power by 5 * log10), for both types.
+        // For float, it is in the same order as the rounding error of float itself (epsilon is 1.2e-7),
+        // so the result is nearly as accurate as std::log10 in float.
+        // For double, it is far above the rounding error of double, so the approximation error dominates,
+        // which is still far below any difference visible in decibel.
+        //
+        // The input is clamped to the smallest positive normal number first,
+        // so zero and denormal numbers produce a finite floor (-37.93 for float, -307.65 for double) rather than negative infinity.
+        // Infinity and NaN are not supported.
+
+        /**
+         * @brief Compute the approximation of common logarithm without calling \c std::log10.
+         * @details See the note above for its algorithm and accuracy.
+         * @param[in] x The number to compute.
+         * @return The approximation of <TT>log10(max(x, numeric_limits<TFloat>::min()))</TT>.
+         */
+        template<typename TFloat>
+        TFloat fast_log10(TFloat x) {
+            using TTraits = FastLogTraits<TFloat>;
+            x = std::max(x, std::numeric_limits<TFloat>::min());
+            if constexpr (!TTraits::SUPPORTED) {
+                return std::log10(x);
+            } else {
+                using TBits = typename TTraits::TBits;
+                constexpr TFloat ONE = static_cast<TFloat>(1);
+                constexpr TFloat LOG10_2 = std::numbers::ln2_v<TFloat> * std::numbers::log10e_v<TFloat>;
+                constexpr TFloat TWO_LOG10_E = static_cast<TFloat>(2) * std::numbers::log10e_v<TFloat>;
+
+                TBits bits = std::bit_cast<TBits>(x);
+                TBits e = (bits - TTraits::TWO_THIRDS) >> TTraits::MANTISSA_BITS;
+                TFloat m = std::bit_cast<TFloat>(bits - (e << TTraits::MANTISSA_BITS));
+                TFloat t = (m - ONE) / (m + ONE);
+                TFloat t2 = t * t;
+                TFloat series = ONE + t2 * (ONE / 3 + t2 * (ONE / 5 + t2 * (ONE / 7)));
+                return static_cast<TFloat>(e) * LOG10_2 + t * series * TWO_LOG10_E;
+            }
+        }
+
+        /**
+         * @brief The SIMD abstraction for converting complex numbers into power and logarithm.
+         * @details
+         * This primary template is the portable scalar fallback.
+         * Specializations for \c float use SSE2 or AVX2 registers according to the compile flags.
+         * \c double uses this fallback because SSE2 and AVX2 lack the 64-bit arithmetic shift which fast_log10() requires.
+         */
+        template<typename TFloat>
+        struct PowerPack {
+            using TReg = TFloat;
+            static constexpr size_t WIDTH = 1u;
+
+            /// @brief Load WIDTH complex numbers and compute their squared magnitude.
+            static TReg load_power(const std::complex<TFloat>* p) { return p->real() * p->real() + p->imag() * p->imag(); }
+            static TReg load(const TFloat* p) { return *p; }
+            static void store(TFloat* p, TReg v) { *p = v; }
+            static TReg zero() { return static_cast<TFloat>(0); }
+            static TReg add(TReg a, TReg b) { return a + b; }
+            static TReg sub(TReg a, TReg b) { return a - b; }
+            static TReg max(TReg a, TReg b) { return std::max(a, b); }
+            static TReg scale(TReg v, TFloat s) { return v * s; }
+            /// @brief Same as fast_log10().
+            static TReg log10(TReg v) { return fast_log10(v); }
+        };
+
+#if defined(YYCC_FFT_SIMD_AVX2)
+
+        template<>
+        struct PowerPack<float> {
+            using TReg = __m256;
+            static constexpr size_t WIDTH = 8u;
+
+            static TReg load_power(const std::complex<float>* p) {
+                const float* fp = reinterpret_cast<const float*>(p);
+                TReg a = _mm256_loadu_ps(fp);
+                TReg b = _mm256_loadu_ps(fp + 8);
+                // In-lane shuffle gives items in order (0, 1, 4, 5 | 2, 3, 6, 7),
+                // then the 64-bit blocks are permuted back into natural order.
+                TReg re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                TReg im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                TReg power = _mm256_fmadd_ps(re, re, _mm256_mul_ps(im, im));
+                return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(power), _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+            static TReg load(const float* p) { return _mm256_loadu_ps(p); }
+            static void store(float* p, TReg v) { _mm256_storeu_ps(p, v); }
+            static TReg zero() { return _mm256_setzero_ps(); }
+            static TReg add(TReg a, TReg b) { return _mm256_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm256_sub_ps(a, b); }
+            static TReg max(TReg a, TReg b) { return _mm256_max_ps(a, b); }
+            static TReg scale(TReg v, float s) { return _mm256_mul_ps(v, _mm256_set1_ps(s)); }
+            static TReg log10(TReg v) {
+                using TTraits = FastLogTraits<float>;
+                constexpr float LOG10_2 = std::numbers::ln2_v<float> * std::numbers::log10e_v<float>;
+                constexpr float TWO_LOG10_E = 2.0f * std::numbers::log10e_v<float>;
+                const TReg one = _mm256_set1_ps(1.0f);
+
+                v = _mm256_max_ps(v, _mm256_set1_ps(std::numeric_limits<float>::min()));
+                __m256i bits = _mm256_castps_si256(v);
+                __m256i e = _mm256_srai_epi32(_mm256_sub_epi32(bits, _mm256_set1_epi32(TTraits::TWO_THIRDS)), TTraits::MANTISSA_BITS);
+                TReg m = _mm256_castsi256_ps(_mm256_sub_epi32(bits, _mm256_slli_epi32(e, TTraits::MANTISSA_BITS)));
+                TReg t = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+                TReg t2 = _mm256_mul_ps(t, t);
+                TReg series = _mm256_fmadd_ps(t2, _mm256_set1_ps(1.0f / 7.0f), _mm256_set1_ps(1.0f / 5.0f));
+                series = _mm256_fmadd_ps(t2, series, _mm256_set1_ps(1.0f / 3.0f));
+                series = _mm256_fmadd_ps(t2, series, one);
+                TReg mantissa_log = _mm256_mul_ps(_mm256_mul_ps(t, series), _mm256_set1_ps(TWO_LOG10_E));
+                return _mm256_fmadd_ps(_mm256_cvtepi32_ps(e), _mm256_set1_ps(LOG10_2), mantissa_log);
+            }
+        };
+
+#elif defined(YYCC_FFT_SIMD_SSE2)
+
+        template<>
+        struct PowerPack<float> {
+            using TReg = __m128;
+            static constexpr size_t WIDTH = 4u;
+
+            static TReg load_power(const std::complex<float>* p) {
+                const float* fp = reinterpret_cast<const float*>(p);
+                TReg a = _mm_loadu_ps(fp);
+                TReg b = _mm_loadu_ps(fp + 4);
+                TReg re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                TReg im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                return _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+            }
+            static TReg load(const float* p) { return _mm_loadu_ps(p); }
+            static void store(float* p, TReg v) { _mm_storeu_ps(p, v); }
+            static TReg zero() { return _mm_setzero_ps(); }
+            static TReg add(TReg a, TReg b) { return _mm_add_ps(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_ps(a, b); }
+            static TReg max(TReg a, TReg b) { return _mm_max_ps(a, b); }
+            static TReg scale(TReg v, float s) { return _mm_mul_ps(v, _mm_set1_ps(s)); }
+            static TReg log10(TReg v) {
+                using TTraits = FastLogTraits<float>;
+                constexpr float LOG10_2 = std::numbers::ln2_v<float> * std::numbers::log10e_v<float>;
+                constexpr float TWO_LOG10_E = 2.0f * std::numbers::log10e_v<float>;
+                const TReg one = _mm_set1_ps(1.0f);
+
+                v = _mm_max_ps(v, _mm_set1_ps(std::numeric_limits<float>::min()));
+                __m128i bits = _mm_castps_si128(v);
+                __m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(TTraits::TWO_THIRDS)), TTraits::MANTISSA_BITS);
+                TReg m = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, TTraits::MANTISSA_BITS)));
+                TReg t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+                TReg t2 = _mm_mul_ps(t, t);
+                TReg series = _mm_add_ps(_mm_mul_ps(t2, _mm_set1_ps(1.0f / 7.0f)), _mm_set1_ps(1.0f / 5.0f));
+                series = _mm_add_ps(_mm_mul_ps(t2, series), _mm_set1_ps(1.0f / 3.0f));
+                series = _mm_add_ps(_mm_mul_ps(t2, series), one);
+                TReg mantissa_log = _mm_mul_ps(_mm_mul_ps(t, series), _mm_set1_ps(TWO_LOG10_E));
+                return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(e), _mm_set1_ps(LOG10_2)), mantissa_log);
+            }
+        };
+
+#endif
+
+        /**
+         * @brief The SIMD abstraction of a pack of fixed-point complex numbers used by FixedFft.
+         * @details
+         * This primary template means there is no SIMD implementation (WIDTH is 1), and FixedFft uses its scalar code.
+         * The specialization for Q15 (\c std::int16_t) uses SSE2 or AVX2 registers according to the compile flags.
+         * All operations produce exactly the same result as the scalar code of FixedFft.
+         */
+        template<typename TFixed>
+        struct FixedPack {
+            /// @brief The placeholder type which is never used.
+            using TReg = std::nullptr_t;
+            static constexpr size_t WIDTH = 1u;
+        };
+
+#if defined(YYCC_FFT_SIMD_AVX2) || defined(YYCC_FFT_SIMD_SSE2)
+
+        // NOTE:
+        // The complex multiplication of Q15 numbers uses PMADDWD instruction,
+        // which multiplies adjacent 16-bit pairs and adds the products into one 32-bit number exactly.
+        // With twiddle factor arranged as (wr, -wi) and (wi, wr), it gives (br * wr - bi * wi) and (br * wi + bi * wr) respectively.
+        // The first twiddle factor of each group is exactly 1 which can not be represented in Q format,
+        // so the product of first complex number is replaced by the multiplicand, like the scalar code.
+        // The rounded arithmetic shift (v + 2^(s-1)) >> s may overflow 16-bit integer,
+        // so it is computed as ((v >> (s - 1)) + 1) >> 1 which gives the same result.
+
+#if defined(YYCC_FFT_SIMD_AVX2)
+
+        template<>
+        struct FixedPack<std::int16_t> {
+            using TComplex = CompactComplex<std::int16_t>;
+            using TReg = __m256i;
+            static constexpr size_t WIDTH = 8u;
+            /// @brief The twiddle factor arranged for PMADDWD, producing real part and imaginary part respectively.
+            struct TTwiddle {
+                TReg real_part;
+                TReg imag_part;
+            };
+
+            static TReg load(const TComplex* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static void store(TComplex* p, TReg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+            static TReg zero() { return _mm256_setzero_si256(); }
+            static TReg add(TReg a, TReg b) { return _mm256_add_epi16(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm256_sub_epi16(a, b); }
+            /// @brief Arithmetic shift right with rounding to nearest. \p shift must be >= 1.
+            static TReg scale(TReg v, int shift) {
+                TReg half = _mm256_sra_epi16(v, _mm_cvtsi32_si128(shift - 1));
+                return _mm256_srai_epi16(_mm256_add_epi16(half, _mm256_set1_epi16(1)), 1);
+            }
+            /// @brief Build twiddle factor pair (wr, -wi) and (wi, wr), or (wr, wi) and (-wi, wr) for backward transform.
+            template<bool VBackward>
+            static TTwiddle twiddle(const TComplex* p) {
+                TReg w = load(p);
+                TReg swapped = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+                TReg mask = VBackward ? _mm256_set1_epi32(0x0000FFFF) : _mm256_set1_epi32(static_cast<int>(0xFFFF0000u));
+                if constexpr (VBackward) return {w, _mm256_sub_epi16(_mm256_xor_si256(swapped, mask), mask)};
+                else return {_mm256_sub_epi16(_mm256_xor_si256(w, mask), mask), swapped};
+            }
+            static TReg mul(TReg b, const TTwiddle& w) {
+                const TReg rounding = _mm256_set1_epi32(1 << 14);
+                TReg re = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(b, w.real_part), rounding), 15);
+                TReg im = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(b, w.imag_part), rounding), 15);
+                return _mm256_blend_epi16(re, _mm256_slli_epi32(im, 16), 0xAA);
+            }
+            /// @brief Replace the first complex number of \p t by the one of \p b, for the twiddle factor which is exactly 1.
+            static TReg keep_first(TReg t, TReg b) { return _mm256_blend_epi32(t, b, 0x01); }
+            /**
+             * @brief Execute all butterflies of a stage whose half size \p VHalf is smaller than WIDTH within one pack.
+             * @param[in] v The pack holding WIDTH / (2 * VHalf) butterfly groups.
+             * @param[in] w The twiddle factor built from a pack whose upper half of each group holds W^k.
+             */
+            template<size_t VHalf>
+            static TReg butterfly_within(TReg v, const TTwiddle& w) {
+                // Masks of 32-bit lanes (one complex number): the upper half of each group, and the first item of upper half.
+                constexpr int UPPER = VHalf == 1u ? 0xAA : (VHalf == 2u ? 0xCC : 0xF0);
+                constexpr int FIRST_UPPER = VHalf == 1u ? 0xAA : (VHalf == 2u ? 0x44 : 0x10);
+                const auto swap = [](TReg x) -> TReg {
+                    if constexpr (VHalf == 1u) return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+                    else if constexpr (VHalf == 2u) return _mm256_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+                    else return _mm256_permute2x128_si256(x, x, 0x01);
+                };
+                TReg t = VHalf == 1u ? v : _mm256_blend_epi32(mul(v, w), v, FIRST_UPPER);
+                return _mm256_blend_epi32(add(v, swap(t)), sub(swap(v), t), UPPER);
+            }
+            /// @brief Accumulate magnitudes by bitwise OR, like FixedFft::magnitude().
+            static TReg accumulate(TReg acc, TReg v) { return _mm256_or_si256(acc, _mm256_xor_si256(v, _mm256_srai_epi16(v, 15))); }
+            static std::int32_t reduce(TReg acc) {
+                __m128i v = _mm_or_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+                v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+                v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+                v = _mm_or_si128(v, _mm_srli_si128(v, 2));
+                return static_cast<std::int32_t>(_mm_cvtsi128_si32(v) & 0xFFFF);
+            }
+        };
+
+#else
+
+        template<>
+        struct FixedPack<std::int16_t> {
+            using TComplex = CompactComplex<std::int16_t>;
+            using TReg = __m128i;
+            static constexpr size_t WIDTH = 4u;
+            /// @brief The twiddle factor arranged for PMADDWD, producing real part and imaginary part respectively.
+            struct TTwiddle {
+                TReg real_part;
+                TReg imag_part;
+            };
+
+            static TReg load(const TComplex* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static void store(TComplex* p, TReg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+            static TReg zero() { return _mm_setzero_si128(); }
+            static TReg add(TReg a, TReg b) { return _mm_add_epi16(a, b); }
+            static TReg sub(TReg a, TReg b) { return _mm_sub_epi16(a, b); }
+            /// @brief Arithmetic shift right with rounding to nearest. \p shift must be >= 1.
+            static TReg scale(TReg v, int shift) {
+                TReg half = _mm_sra_epi16(v, _mm_cvtsi32_si128(shift - 1));
+                return _mm_srai_epi16(_mm_add_epi16(half, _mm_set1_epi16(1)), 1);
+            }
+            /// @brief Build twiddle factor pair (wr, -wi) and (wi, wr), or (wr, wi) and (-wi, wr) for backward transform.
+            template<bool VBackward>
+            static TTwiddle twiddle(const TComplex* p) {
+                TReg w = load(p);
+                TReg swapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+                TReg mask = VBackward ? _mm_set1_epi32(0x0000FFFF) : _mm_set1_epi32(static_cast<int>(0xFFFF0000u));
+                if constexpr (VBackward) return {w, _mm_sub_epi16(_mm_xor_si128(swapped, mask), mask)};
+                else return {_mm_sub_epi16(_mm_xor_si128(w, mask), mask), swapped};
+            }
+            static TReg mul(TReg b, const TTwiddle& w) {
+                const TReg rounding = _mm_set1_epi32(1 << 14);
+                TReg re = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(b, w.real_part), rounding), 15);
+                TReg im = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(b, w.imag_part), rounding), 15);
+                return _mm_or_si128(_mm_and_si128(re, _mm_set1_epi32(0x0000FFFF)), _mm_slli_epi32(im, 16));
+            }
+            /// @brief Select 32-bit lanes from \p b where \p mask is set, otherwise from \p a.
+            static TReg select(TReg mask, TReg a, TReg b) { return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a)); }
+            /// @brief Replace the first complex number of \p t by the one of \p b, for the twiddle factor which is exactly 1.
+            static TReg keep_first(TReg t, TReg b) { return select(_mm_setr_epi32(-1, 0, 0, 0), t, b); }
+            /**
+             * @brief Execute all butterflies of a stage whose half size \p VHalf is smaller than WIDTH within one pack.
+             * @param[in] v The pack holding WIDTH / (2 * VHalf) butterfly groups.
+             * @param[in] w The twiddle factor built from a pack whose upper half of each group holds W^k.
+             */
+            template<size_t VHalf>
+            static TReg butterfly_within(TReg v, const TTwiddle& w) {
+                if constexpr (VHalf == 1u) {
+                    TReg swapped = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+                    return select(_mm_setr_epi32(0, -1, 0, -1), add(v, swapped), sub(swapped, v));
+                } else {
+                    TReg t = select(_mm_setr_epi32(0, 0, -1, 0), mul(v, w), v);
+                    return select(_mm_setr_epi32(0, 0, -1, -1),
+                                  add(v, _mm_shuffle_epi32(t, _MM_SHUFFLE(1, 0, 3, 2))),
+                                  sub(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)), t));
+                }
+            }
+            /// @brief Accumulate magnitudes by bitwise OR, like FixedFft::magnitude().
+            static TReg accumulate(TReg acc, TReg v) { return _mm_or_si128(acc, _mm_xor_si128(v, _mm_srai_epi16(v, 15))); }
+            static std::int32_t reduce(TReg acc) {
+                TReg v = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+                v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+                v = _mm_or_si128(v, _mm_srli_si128(v, 2));
+                return static_cast<std::int32_t>(_mm_cvtsi128_si32(v) & 0xFFFF);
+            }
+        };
+
+#endif
+#endif
+
+        /**
+         * @brief Multiply real-number sequence with window function in one pass.
+         * @details
+         * The output item i is <TT>src[i] * win[i]</TT>, or <TT>src[n - 1 - i] * win[i]</TT> if \p VReverse is true.
+         * If output is complex sequence, the products are widened into complex numbers with zero imaginary part.
+         * @param[in] src The source sequence with length N.
+         * @param[in] win The window function data with length N.
+         * @param[out] dst
+         * The sequence receiving result, which can be float-point or complex sequence.
+         * It can be the same one with \p src only if it is float-point sequence and \p VReverse is false.
+         * @param[in] n The length of all sequences.
+         * @tparam VReverse True for reading source in reversed order.
+         */
+        template<bool VReverse, typename TIndex, typename TFloat, typename TOut>
+        void window_multiply(const TFloat* src, const TFloat* win, TOut* dst, TIndex n) {
+            using TPack = RealPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr bool WIDEN = std::is_same_v<TOut, std::complex<TFloat>>;
+            static_assert(WIDEN || std::is_same_v<TOut, TFloat>, "unexpected output type of window multiplication");
+
+            // The length may not be a multiple of WIDTH (e.g. a part of ring buffer), so remains are processed one by one.
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            for (; i < packed; i += WIDTH) {
+                auto v = VReverse ? TPack::reverse(TPack::load(src + (n - i - WIDTH))) : TPack::load(src + i);
+                v = TPack::mul(v, TPack::load(win + i));
+                if constexpr (WIDEN) TPack::store_widened(dst + i, v);
+                else TPack::store(dst + i, v);
+            }
+            for (; i < n; ++i) {
+                TFloat v = (VReverse ? src[n - static_cast<TIndex>(1) - i] : src[i]) * win[i];
+                if constexpr (WIDEN) dst[i] = std::complex<TFloat>(v);
+                else dst[i] = v;
+            }
+        }
+
+        // NOTE:
+        // Our FFT engine is a decimation-in-time radix-4 FFT.
+        // Every radix-4 pass fuses 2 adjacent radix-2 stages of classic Cooley-Tukey FFT,
+        // so that the whole buffer is walked only half times and 1/4 complex multiplications are saved.
+        // If the exponent of N is odd, one extra trivial radix-2 pass (without any multiplication) is executed first.
+        //
+        // For each radix-4 pass with quarter size Q (the size of butterfly is 4Q),
+        // its twiddle factors are stored continuously as 3 blocks with length Q:
+        // W1[j] = W(2Q)^j, W2[j] = W(4Q)^j and W3[j] = W(4Q)^(3j) where j in [0, Q).
+        // All passes are stored in execution order.
+        // So that the twiddle factors can be loaded sequentially (and vectorized) in each pass.
+
+        /**
+         * @brief Get the first quarter size of radix-4 passes for given N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @return The quarter size of the first radix-4 pass.
+         */
+        template<typename TIndex>
+        constexpr TIndex radix4_first_quarter(TIndex n) {
+            // If the exponent of N is odd, there is an extra radix-2 pass before first radix-4 pass.
+            return ((std::bit_width<TIndex>(n) - 1) % 2 == 0) ? static_cast<TIndex>(1) : static_cast<TIndex>(2);
+        }
+
+        /**
+         * @brief Get the count of twiddle factors used by all radix-4 passes of given N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @return The count of complex twiddle factors.
+         */
+        template<typename TIndex>
+        constexpr TIndex radix4_twiddle_count(TIndex n) {
+            TIndex count = 0;
+            for (TIndex q = radix4_first_quarter<TIndex>(n); (q << 2) <= n; q <<= 2) {
+                count += static_cast<TIndex>(3) * q;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Fill twiddle factors used by all radix-4 passes of given N.
+         * @param[out] dst The buffer receiving twiddle factors.
+         * Its length must be radix4_twiddle_count() with the same N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] backward True for backward (inverse) transform whose twiddle factors are conjugated.
+         */
+        template<typename TIndex, typename TFloat>
+        void fill_radix4_twiddles(std::complex<TFloat>* dst, TIndex n, bool backward = false) {
+            // All twiddle factors are picked from W(N)^P, so that they are exactly the same one with radix-2 FFT.
+            auto wnp = [n, backward](TIndex p) -> std::complex<TFloat> {
+                TFloat angle = tau_v<TFloat> * static_cast<TFloat>(p) / static_cast<TFloat>(n);
+                // e^(-jx) = cosx - j sinx, and e^(jx) = cosx + j sinx for backward transform.
+                return std::complex<TFloat>(std::cos(angle), backward ? std::sin(angle) : -std::sin(angle));
+            };
+
+            for (TIndex q = radix4_first_quarter<TIndex>(n); (q << 2) <= n; q <<= 2) {
+                TIndex stride = n / (q << 2);
+                for (TIndex j = 0; j < q; ++j) {
+                    dst[j] = wnp(static_cast<TIndex>(2) * j * stride);
+                    dst[q + j] = wnp(j * stride);
+                    dst[q + q + j] = wnp(static_cast<TIndex>(3) * j * stride);
+                }
+                dst += static_cast<TIndex>(3) * q;
+            }
+        }
+
+        // NOTE:
+        // Bit-reversed reordering is stored as a list of swapped index pairs,
+        // so that permutation is a plain table-driven pass without any self-mapped index or I > J check.
+        // Pairs are grouped into cache blocks:
+        // split the bits of index into high (B bits), middle and low (B bits) part,
+        // then the bit-reversed index of (high, middle, low) is (rev(low), rev(middle), rev(high)).
+        // All pairs with the same middle part only touch 2^B runs of 2^B continuous items on both sides,
+        // so we emit them together, and each cache line is loaded once instead of once per item.
+
+        /// @brief The bit count of high and low part in cache blocked bit-reversed swap list.
+        inline constexpr unsigned BIT_REVERSE_BLOCK_BITS = 4u;
+
+        /**
+         * @brief Reverse the lowest \p bits bits of given value.
+         * @param[in] value The value to be reversed. Its bits higher than \p bits must be zero.
+         * @param[in] bits The count of bits to be reversed.
+         * @return The reversed value.
+         */
+        template<typename TIndex>
+        constexpr TIndex reverse_bits(TIndex value, unsigned bits) {
+            TIndex rv = 0;
+            for (unsigned i = 0u; i < bits; ++i) {
+                rv = (rv << 1) | (value & static_cast<TIndex>(1));
+                value >>= 1;
+            }
+            return rv;
+        }
+
+        /**
+         * @brief Get the count of swapped pairs in bit-reversed reordering of given N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @return The count of swapped pairs.
+         */
+        template<typename TIndex>
+        constexpr TIndex bit_reverse_swap_count(TIndex n) {
+            // Only the indices which are not palindrome in binary are swapped.
+            // The count of M-bit palindrome is 2^ceil(M / 2).
+            const unsigned m = static_cast<unsigned>(std::bit_width<TIndex>(n) - 1);
+            return (n - (static_cast<TIndex>(1) << ((m + 1u) / 2u))) / static_cast<TIndex>(2);
+        }
+
+        /**
+         * @brief Fill cache blocked bit-reversed swap list of given N.
+         * @param[out] dst
+         * The buffer receiving swapped pairs, stored as (I, J) one by one.
+         * Its length must be 2 * bit_reverse_swap_count() with the same N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         */
+        template<typename TIndex>
+        void fill_bit_reverse_swaps(TIndex* dst, TIndex n) {
+            const unsigned m = static_cast<unsigned>(std::bit_width<TIndex>(n) - 1);
+            // Small sequence fits in cache entirely, so it is not blocked (the middle part has all bits).
+            const unsigned b = m > 2u * BIT_REVERSE_BLOCK_BITS ? BIT_REVERSE_BLOCK_BITS : 0u;
+            const unsigned mid_bits = m - 2u * b;
+            const TIndex block = static_cast<TIndex>(1) << b;
+            const TIndex mid_count = static_cast<TIndex>(1) << mid_bits;
+
+            for (TIndex mid = 0; mid < mid_count; ++mid) {
+                const TIndex rev_mid = reverse_bits<TIndex>(mid, mid_bits);
+                // The block of (middle, rev(middle)) is emitted once with the smaller one.
+                if (rev_mid < mid) continue;
+                for (TIndex hi = 0; hi < block; ++hi) {
+                    const TIndex rev_hi = reverse_bits<TIndex>(hi, b);
+                    for (TIndex lo = 0; lo < block; ++lo) {
+                        const TIndex I = (((hi << mid_bits) | mid) << b) | lo;
+                        const TIndex J = (((reverse_bits<TIndex>(lo, b) << mid_bits) | rev_mid) << b) | rev_hi;
+                        // Palindrome middle part maps the block to itself, so only take half of it.
+                        if (rev_mid == mid && I >= J) continue;
+                        *(dst++) = I;
+                        *(dst++) = J;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Reorder given sequence by bit-reversed index in place.
+         * @param[in,out] data The sequence with length N.
+         * @param[in] swaps The swap list filled by fill_bit_reverse_swaps() with the same N.
+         * @param[in] swap_count The count of swapped pairs.
+         */
+        template<typename TIndex, typename TItem>
+        void bit_reverse_permute(TItem* data, const TIndex* swaps, TIndex swap_count) {
+            const TIndex* end = swaps + swap_count * static_cast<TIndex>(2);
+            for (; swaps != end; swaps += 2) {
+                std::swap(data[swaps[0]], data[swaps[1]]);
+            }
+        }
+
+        /**
+         * @brief Execute one radix-4 butterfly for given pack type on registers in place.
+         * @details
+         * Input are 4 bit-reversed ordered sub-sequence values with distance Q,
+         * and twiddle factors W1, W2, W3 described in radix-4 pass layout.
+         * For backward transform, the rotation of W(4)^1 = -j becomes its conjugation +j.
+         */
+        template<typename TPack, bool VBackward>
+        inline void radix4_butterfly(typename TPack::TReg (&x)[4],
+                                     typename TPack::TReg w1,
+                                     typename TPack::TReg w2,
+                                     typename TPack::TReg w3) {
+            auto a0 = x[0];
+            auto c1 = TPack::mul(x[1], w1);
+            auto c2 = TPack::mul(x[2], w2);
+            auto c3 = TPack::mul(x[3], w3);
+
+            auto b0 = TPack::add(a0, c1);
+            auto b1 = TPack::sub(a0, c1);
+            auto s = TPack::add(c2, c3);
+            auto d = VBackward ? TPack::mul_pos_i(TPack::sub(c2, c3)) : TPack::mul_neg_i(TPack::sub(c2, c3));
+
+            x[0] = TPack::add(b0, s);
+            x[1] = TPack::add(b1, d);
+            x[2] = TPack::sub(b0, s);
+            x[3] = TPack::sub(b1, d);
+        }
+
+        /**
+         * @brief Execute one radix-4 butterfly for given pack type on memory.
+         */
+        template<typename TPack, bool VBackward, typename TComplex>
+        inline void radix4_butterfly(TComplex* p0,
+                                     TComplex* p1,
+                                     TComplex* p2,
+                                     TComplex* p3,
+                                     typename TPack::TReg w1,
+                                     typename TPack::TReg w2,
+                                     typename TPack::TReg w3) {
+            typename TPack::TReg x[4]{TPack::load(p0), TPack::load(p1), TPack::load(p2), TPack::load(p3)};
+            radix4_butterfly<TPack, VBackward>(x, w1, w2, w3);
+            TPack::store(p0, x[0]);
+            TPack::store(p1, x[1]);
+            TPack::store(p2, x[2]);
+            TPack::store(p3, x[3]);
+        }
+
+        /**
+         * @brief Execute one radix-4 butterfly for given pack type, with twiddle factors loaded from radix-4 pass layout.
+         */
+        template<typename TPack, bool VBackward, typename TComplex>
+        inline void radix4_butterfly(TComplex* p0, TComplex* p1, TComplex* p2, TComplex* p3, const TComplex* tw, size_t q) {
+            radix4_butterfly<TPack, VBackward>(p0, p1, p2, p3, TPack::load(tw), TPack::load(tw + q), TPack::load(tw + q + q));
+        }
+
+        /**
+         * @brief Execute all butterfly passes on bit-reversed ordered complex sequence.
+         * @param[in,out] data The bit-reversed ordered complex sequence with length N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] twiddles The twiddle factors filled by fill_radix4_twiddles() with the same N and direction.
+         * @tparam VBackward True for backward (inverse) transform.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward = false>
+        void radix4_butterflies(std::complex<TFloat>* data, TIndex n, const std::complex<TFloat>* twiddles) {
+            using TComplex = std::complex<TFloat>;
+            using TPack = ComplexPack<TFloat>;
+            using THalfPack = HalfComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+
+            TIndex q = radix4_first_quarter<TIndex>(n);
+            if (q != static_cast<TIndex>(1)) {
+                if constexpr (THalfPack::WIDTH == 2u) {
+                    // The pack of 2 complex numbers fuses extra radix-2 pass for odd exponent into the first radix-4 pass (Q = 2).
+                    // Each block of 8 items is loaded and stored only once, and all blocks share the same twiddle factors.
+                    if (n >= static_cast<TIndex>(8)) {
+                        const auto w1 = THalfPack::load(twiddles), w2 = THalfPack::load(twiddles + 2), w3 = THalfPack::load(twiddles + 4);
+                        for (TIndex k = 0; k < n; k += static_cast<TIndex>(8)) {
+                            TComplex* p = data + k;
+                            typename THalfPack::TReg x[4]{THalfPack::sum_diff(THalfPack::load(p)),
+                                                          THalfPack::sum_diff(THalfPack::load(p + 2)),
+                                                          THalfPack::sum_diff(THalfPack::load(p + 4)),
+                                                          THalfPack::sum_diff(THalfPack::load(p + 6))};
+                            radix4_butterfly<THalfPack, VBackward>(x, w1, w2, w3);
+                            THalfPack::store(p, x[0]);
+                            THalfPack::store(p + 2, x[1]);
+                            THalfPack::store(p + 4, x[2]);
+                            THalfPack::store(p + 6, x[3]);
+                        }
+                        q <<= 2;
+                        twiddles += static_cast<TIndex>(6);
+                    }
+                }
+                // Extra radix-2 pass for odd exponent, if it is not fused above.
+                if (q == static_cast<TIndex>(2)) {
+                    for (TIndex k = 0; k < n; k += static_cast<TIndex>(2)) {
+                        TComplex temp = data[k + static_cast<TIndex>(1)];
+                        data[k + static_cast<TIndex>(1)] = data[k] - temp;
+                        data[k] += temp;
+                    }
+                }
+            } else {
+                // The first radix-4 pass with Q = 1 only has trivial twiddle factors (all of them are 1),
+                // so we execute it without any multiplication.
+                for (TIndex k = 0; k < n; k += static_cast<TIndex>(4)) {
+                    TComplex* p = data + k;
+                    TComplex b0 = p[0] + p[1], b1 = p[0] - p[1];
+                    TComplex s = p[2] + p[3];
+                    TComplex d = VBackward ? TScalarPack::mul_pos_i(p[2] - p[3]) : TScalarPack::mul_neg_i(p[2] - p[3]);
+                    p[0] = b0 + s;
+                    p[1] = b1 + d;
+                    p[2] = b0 - s;
+                    p[3] = b1 - d;
+                }
+                q <<= 2;
+                twiddles += static_cast<TIndex>(3);
+            }
+
+            // Radix-4 passes
+            for (; (q << 2) <= n; q <<= 2) {
+                TIndex span = q << 2;
+                for (TIndex k = 0; k < n; k += span) {
+                    TComplex* p0 = data + k;
+                    TComplex* p1 = p0 + q;
+                    TComplex* p2 = p1 + q;
+                    TComplex* p3 = p2 + q;
+
+                    TIndex j = 0;
+                    // Q and WIDTH are both power of 2, so there is no remains if Q >= WIDTH.
+                    if (q >= static_cast<TIndex>(TPack::WIDTH)) {
+                        for (; j < q; j += static_cast<TIndex>(TPack::WIDTH)) {
+                            radix4_butterfly<TPack, VBackward>(p0 + j, p1 + j, p2 + j, p3 + j, twiddles + j, q);
+                        }
+                    } else {
+                        for (; j < q; ++j) {
+                            radix4_butterfly<TScalarPack, VBackward>(p0 + j, p1 + j, p2 + j, p3 + j, twiddles + j, q);
+                        }
+                    }
+                }
+                twiddles += static_cast<TIndex>(3) * q;
+            }
+        }
+
+        // NOTE:
+        // Batched FFT computes the same point FFT on multiple channels at once.
+        // Channels are interleaved (structure-of-arrays), that is, the k-th item of c-th channel is located at data[k * stride + c].
+        // So that we call the items with the same k as a "row".
+        // Every butterfly is executed on whole rows, thus one SIMD lane processes one channel,
+        // and each twiddle factor is loaded (broadcasted) only once for all channels.
+
+        /**
+         * @brief Reorder rows of batched complex sequence by bit-reversed index in place.
+         * @param[in,out] data The batched complex sequence with N rows.
+         * @param[in] swaps The swap list filled by fill_bit_reverse_swaps() with the same N.
+         * @param[in] swap_count The count of swapped pairs.
+         * @param[in] channels The count of channels.
+         * @param[in] stride The distance between adjacent rows. It must be >= channels.
+         */
+        template<typename TIndex, typename TFloat>
+        void bit_reverse_permute_batch(std::complex<TFloat>* data, const TIndex* swaps, TIndex swap_count, TIndex channels, TIndex stride) {
+            const TIndex* end = swaps + swap_count * static_cast<TIndex>(2);
+            for (; swaps != end; swaps += 2) {
+                std::complex<TFloat>* row = data + swaps[0] * stride;
+                std::swap_ranges(row, row + channels, data + swaps[1] * stride);
+            }
+        }
+
+        /**
+         * @brief Execute all butterfly passes on bit-reversed ordered batched complex sequence.
+         * @param[in,out] data The bit-reversed ordered batched complex sequence with N rows.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] twiddles The twiddle factors filled by fill_radix4_twiddles() with the same N and direction.
+         * @param[in] channels The count of channels.
+         * @param[in] stride The distance between adjacent rows. It must be >= channels.
+         * @tparam VBackward True for backward (inverse) transform.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward = false>
+        void radix4_butterflies_batch(std::complex<TFloat>* data,
+                                      TIndex n,
+                                      const std::complex<TFloat>* twiddles,
+                                      TIndex channels,
+                                      TIndex stride) {
+            using TComplex = std::complex<TFloat>;
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            // The count of channels which can be processed by SIMD pack.
+            const TIndex packed_channels = channels - channels % WIDTH;
+
+            TIndex q = radix4_first_quarter<TIndex>(n);
+            if (q != static_cast<TIndex>(1)) {
+                // Extra radix-2 pass for odd exponent.
+                for (TIndex k = 0; k < n; k += static_cast<TIndex>(2)) {
+                    TComplex* r0 = data + k * stride;
+                    TComplex* r1 = r0 + stride;
+                    TIndex c = 0;
+                    for (; c < packed_channels; c += WIDTH) {
+                        auto a = TPack::load(r0 + c), b = TPack::load(r1 + c);
+                        TPack::store(r0 + c, TPack::add(a, b));
+                        TPack::store(r1 + c, TPack::sub(a, b));
+                    }
+                    for (; c < channels; ++c) {
+                        TComplex temp = r1[c];
+                        r1[c] = r0[c] - temp;
+                        r0[c] += temp;
+                    }
+                }
+            }
+
+            // Radix-4 passes.
+            // The first pass with Q = 1 is not specialized like non-batched one,
+            // because its trivial twiddle factors are only loaded once per row.
+            for (; (q << 2) <= n; q <<= 2) {
+                TIndex span = q << 2;
+                for (TIndex k = 0; k < n; k += span) {
+                    for (TIndex j = 0; j < q; ++j) {
+                        TComplex* r0 = data + (k + j) * stride;
+                        TComplex* r1 = r0 + q * stride;
+                        TComplex* r2 = r1 + q * stride;
+                        TComplex* r3 = r2 + q * stride;
+                        const TComplex& w1 = twiddles[j];
+                        const TComplex& w2 = twiddles[q + j];
+                        const TComplex& w3 = twiddles[q + q + j];
+
+                        TIndex c = 0;
+                        if (packed_channels != static_cast<TIndex>(0)) {
+                            auto pw1 = TPack::broadcast(w1), pw2 = TPack::broadcast(w2), pw3 = TPack::broadcast(w3);
+                            for (; c < packed_channels; c += WIDTH) {
+                                radix4_butterfly<TPack, VBackward>(r0 + c, r1 + c, r2 + c, r3 + c, pw1, pw2, pw3);
+                            }
+                        }
+                        for (; c < channels; ++c) {
+                            radix4_butterfly<TScalarPack, VBackward>(r0 + c, r1 + c, r2 + c, r3 + c, w1, w2, w3);
+                        }
+                    }
+                }
+                twiddles += static_cast<TIndex>(3) * q;
+            }
+        }
+
+        // NOTE:
+        // Stockham autosort FFT is a decimation-in-frequency radix-4 FFT.
+        // Each pass reads whole sequence from one buffer and writes it into another one,
+        // and the output of last pass is already in natural order, so there is no bit-reversal pass.
+        // For the pass with sub-transform length L and stride S (L * S = N, S grows from 1),
+        // the item q of p-th butterfly is read from x[q + S * (p + i * L / 4)] and written into y[q + S * (4p + i)],
+        // so that all accesses are sequential runs with length S.
+        // If the exponent of N is odd, one extra radix-2 pass without any multiplication is executed last.
+        //
+        // For each radix-4 pass, its twiddle factors are stored continuously as 3 blocks with length L / 4:
+        // W(L)^p, W(L)^(2p) and W(L)^(3p) where p in [0, L / 4).
+        // All passes are stored in execution order.
+
+        /**
+         * @brief Get the count of passes of Stockham FFT for given N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @return The count of passes including the extra radix-2 pass.
+         */
+        template<typename TIndex>
+        constexpr TIndex stockham_pass_count(TIndex n) {
+            const TIndex m = static_cast<TIndex>(std::bit_width<TIndex>(n) - 1);
+            return (m >> 1) + (m & static_cast<TIndex>(1));
+        }
+
+        /**
+         * @brief Get the count of twiddle factors used by all radix-4 passes of Stockham FFT.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @return The count of complex twiddle factors.
+         */
+        template<typename TIndex>
+        constexpr TIndex stockham_twiddle_count(TIndex n) {
+            TIndex count = 0;
+            for (TIndex l = n; l >= static_cast<TIndex>(4); l >>= 2) {
+                count += static_cast<TIndex>(3) * (l >> 2);
+            }
+            return count;
+        }
+
+        /**
+         * @brief Fill twiddle factors used by all radix-4 passes of Stockham FFT.
+         * @param[out] dst The buffer receiving twiddle factors.
+         * Its length must be stockham_twiddle_count() with the same N.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] backward True for backward (inverse) transform whose twiddle factors are conjugated.
+         */
+        template<typename TIndex, typename TFloat>
+        void fill_stockham_twiddles(std::complex<TFloat>* dst, TIndex n, bool backward = false) {
+            // W(L)^p = W(N)^(p * N / L)
+            auto wnp = [n, backward](TIndex p) -> std::complex<TFloat> {
+                TFloat angle = tau_v<TFloat> * static_cast<TFloat>(p) / static_cast<TFloat>(n);
+                return std::complex<TFloat>(std::cos(angle), backward ? std::sin(angle) : -std::sin(angle));
+            };
+
+            for (TIndex l = n; l >= static_cast<TIndex>(4); l >>= 2) {
+                TIndex q = l >> 2;
+                TIndex stride = n / l;
+                for (TIndex p = 0; p < q; ++p) {
+                    dst[p] = wnp(p * stride);
+                    dst[q + p] = wnp(static_cast<TIndex>(2) * p * stride);
+                    dst[q + q + p] = wnp(static_cast<TIndex>(3) * p * stride);
+                }
+                dst += static_cast<TIndex>(3) * q;
+            }
+        }
+
+        /**
+         * @brief Execute one Stockham radix-4 butterfly for given pack type.
+         * @details
+         * Input are 4 items with distance L / 4 (multiplied by stride) from source buffer,
+         * and output are 4 adjacent items (multiplied by stride) in destination buffer.
+         */
+        template<typename TPack, bool VBackward, typename TComplex>
+        inline void stockham_butterfly(const TComplex* x0,
+                                       const TComplex* x1,
+                                       const TComplex* x2,
+                                       const TComplex* x3,
+                                       TComplex* y0,
+                                       TComplex* y1,
+                                       TComplex* y2,
+                                       TComplex* y3,
+                                       typename TPack::TReg w1,
+                                       typename TPack::TReg w2,
+                                       typename TPack::TReg w3) {
+            auto a = TPack::load(x0), b = TPack::load(x1), c = TPack::load(x2), d = TPack::load(x3);
+
+            auto apc = TPack::add(a, c);
+            auto amc = TPack::sub(a, c);
+            auto bpd = TPack::add(b, d);
+            auto jbmd = VBackward ? TPack::mul_pos_i(TPack::sub(b, d)) : TPack::mul_neg_i(TPack::sub(b, d));
+
+            TPack::store(y0, TPack::add(apc, bpd));
+            TPack::store(y1, TPack::mul(TPack::add(amc, jbmd), w1));
+            TPack::store(y2, TPack::mul(TPack::sub(apc, bpd), w2));
+            TPack::store(y3, TPack::mul(TPack::sub(amc, jbmd), w3));
+        }
+
+        /**
+         * @brief Execute one Stockham radix-4 pass.
+         * @param[in] x The source buffer with length N.
+         * @param[out] y The destination buffer with length N. It must not overlap with \p x.
+         * @param[in] l The length of sub-transform in this pass.
+         * @param[in] s The stride of this pass, that is N / L.
+         * @param[in] twiddles The twiddle factors of this pass.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward>
+        void stockham_radix4_pass(const std::complex<TFloat>* x, std::complex<TFloat>* y, TIndex l, TIndex s, const std::complex<TFloat>* twiddles) {
+            using TComplex = std::complex<TFloat>;
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            const TIndex q = l >> 2;
+            const TIndex span = q * s;
+            for (TIndex p = 0; p < q; ++p) {
+                const TComplex* x0 = x + p * s;
+                const TComplex* x1 = x0 + span;
+                const TComplex* x2 = x1 + span;
+                const TComplex* x3 = x2 + span;
+                TComplex* y0 = y + (p << 2) * s;
+                TComplex* y1 = y0 + s;
+                TComplex* y2 = y1 + s;
+                TComplex* y3 = y2 + s;
+                const TComplex& w1 = twiddles[p];
+                const TComplex& w2 = twiddles[q + p];
+                const TComplex& w3 = twiddles[q + q + p];
+
+                // S and WIDTH are both power of 2, so there is no remains if S >= WIDTH.
+                if (s >= WIDTH) {
+                    auto pw1 = TPack::broadcast(w1), pw2 = TPack::broadcast(w2), pw3 = TPack::broadcast(w3);
+                    for (TIndex j = 0; j < s; j += WIDTH) {
+                        stockham_butterfly<TPack, VBackward>(x0 + j, x1 + j, x2 + j, x3 + j, y0 + j, y1 + j, y2 + j, y3 + j, pw1, pw2, pw3);
+                    }
+                } else {
+                    for (TIndex j = 0; j < s; ++j) {
+                        stockham_butterfly<TScalarPack, VBackward>(x0 + j, x1 + j, x2 + j, x3 + j, y0 + j, y1 + j, y2 + j, y3 + j, w1, w2, w3);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Execute the extra Stockham radix-2 pass for odd exponent.
+         * @param[in] x The source buffer with length N.
+         * @param[out] y The destination buffer with length N. It must not overlap with \p x.
+         * @param[in] s The stride of this pass, that is N / 2.
+         */
+        template<typename TIndex, typename TFloat>
+        void stockham_radix2_pass(const std::complex<TFloat>* x, std::complex<TFloat>* y, TIndex s) {
+            using TPack = ComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            TIndex j = 0;
+            if (s >= WIDTH) {
+                for (; j < s; j += WIDTH) {
+                    auto a = TPack::load(x + j), b = TPack::load(x + s + j);
+                    TPack::store(y + j, TPack::add(a, b));
+                    TPack::store(y + s + j, TPack::sub(a, b));
+                }
+            }
+            for (; j < s; ++j) {
+                y[j] = x[j] + x[s + j];
+                y[s + j] = x[j] - x[s + j];
+            }
+        }
+
+        /**
+         * @brief Execute all passes of Stockham FFT.
+         * @details
+         * Passes ping-pong between \p dst and \p scratch,
+         * and the first pass is arranged so that the last pass is written into \p dst.
+         * If \p src is the same one with \p dst, and the count of passes is odd,
+         * source is copied into scratch buffer first, because the first pass can not be written into its source.
+         * @param[in] src The source sequence with length N in natural order.
+         * @param[out] dst The destination sequence with length N. It can be the same one with \p src.
+         * @param[in] scratch The scratch buffer with length N. It must not overlap with \p src or \p dst.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] twiddles The twiddle factors filled by fill_stockham_twiddles() with the same N and direction.
+         * @tparam VBackward True for backward (inverse) transform.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward = false>
+        void stockham_passes(const std::complex<TFloat>* src,
+                             std::complex<TFloat>* dst,
+                             std::complex<TFloat>* scratch,
+                             TIndex n,
+                             const std::complex<TFloat>* twiddles) {
+            using TComplex = std::complex<TFloat>;
+
+            const bool odd_passes = (stockham_pass_count<TIndex>(n) & static_cast<TIndex>(1)) != static_cast<TIndex>(0);
+            if (src == dst && odd_passes) {
+                std::copy_n(src, n, scratch);
+                src = scratch;
+            }
+            // The first pass is written into destination if the count of passes is odd.
+            const TComplex* x = src;
+            TComplex* y = odd_passes ? dst : scratch;
+            TComplex* other = odd_passes ? scratch : dst;
+
+            TIndex l = n, s = 1;
+            for (; l >= static_cast<TIndex>(4); l >>= 2, s <<= 2) {
+                stockham_radix4_pass<TIndex, TFloat, VBackward>(x, y, l, s, twiddles);
+                twiddles += static_cast<TIndex>(3) * (l >> 2);
+                x = y;
+                std::swap(y, other);
+            }
+            if (l == static_cast<TIndex>(2)) {
+                stockham_radix2_pass<TIndex, TFloat>(x, y, s);
+            }
+        }
+
+        /**
+         * @brief Call <TT>func(std::integral_constant<size_t, I>())</TT> for every I in [0, VCount) in order.
+         * @details
+         * The calls are expanded at compile time, so that the small arrays of SIMD registers indexed by I are kept in registers,
+         * which is not guaranteed by loop unrolling of compiler.
+         */
+        template<size_t VCount, typename TFunc>
+        inline void unrolled_for(TFunc&& func) {
+            [&func]<size_t... VI>(std::index_sequence<VI...>) {
+                (func(std::integral_constant<size_t, VI>()), ...);
+            }(std::make_index_sequence<VCount>());
+        }
+
+        // NOTE:
+        // Split-complex Stockham FFT is the same algorithm as Stockham FFT above,
+        // but real parts and imaginary parts are stored in two separate arrays.
+        // So each SIMD register holds WIDTH real parts or WIDTH imaginary parts,
+        // and complex multiplication is 4 multiplications and 2 additions of registers without any shuffle.
+        //
+        // In each radix-4 pass, butterfly i = p * S + j reads x[i + k * N / 4] for k in [0, 4),
+        // so that every pass reads its source contiguously in i.
+        // Its output y[(4p + k) * S + j] is contiguous in j.
+        // If S >= WIDTH, it is stored by SIMD directly, and twiddle factors are stored once per p like Stockham FFT.
+        // Otherwise, twiddle factors are repeated S times so that they are loaded contiguously in i,
+        // and outputs are stored into a small buffer first and scattered by blocks of S items.
+
+        /**
+         * @brief Get the repeat count of twiddle factors of a split-complex Stockham pass.
+         * @param[in] s The stride of this pass.
+         * @return S if S is less than SIMD width, otherwise 1.
+         */
+        template<typename TIndex, typename TFloat>
+        constexpr TIndex split_stockham_repeat(TIndex s) {
+            return s < static_cast<TIndex>(RealPack<TFloat>::WIDTH) ? s : static_cast<TIndex>(1);
+        }
+
+        /**
+         * @brief Get the count of twiddle factors used by all radix-4 passes of split-complex Stockham FFT.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @return The count of real parts, which is also the count of imaginary parts.
+         */
+        template<typename TIndex, typename TFloat>
+        constexpr TIndex split_stockham_twiddle_count(TIndex n) {
+            TIndex count = 0;
+            for (TIndex l = n, s = 1; l >= static_cast<TIndex>(4); l >>= 2, s <<= 2) {
+                count += static_cast<TIndex>(3) * (l >> 2) * split_stockham_repeat<TIndex, TFloat>(s);
+            }
+            return count;
+        }
+
+        /**
+         * @brief Fill twiddle factors used by all radix-4 passes of split-complex Stockham FFT.
+         * @param[out] re The buffer receiving real parts. Its length must be split_stockham_twiddle_count() with the same N.
+         * @param[out] im The buffer receiving imaginary parts with the same length.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] backward True for backward (inverse) transform whose twiddle factors are conjugated.
+         */
+        template<typename TIndex, typename TFloat>
+        void fill_split_stockham_twiddles(TFloat* re, TFloat* im, TIndex n, bool backward = false) {
+            for (TIndex l = n, s = 1; l >= static_cast<TIndex>(4); l >>= 2, s <<= 2) {
+                const TIndex q = l >> 2;
+                const TIndex repeat = split_stockham_repeat<TIndex, TFloat>(s);
+                for (TIndex k = 1; k < static_cast<TIndex>(4); ++k) {
+                    for (TIndex p = 0; p < q; ++p) {
+                        // W(L)^(kp) = W(N)^(kp * S)
+                        TFloat angle = tau_v<TFloat> * static_cast<TFloat>(k * p * s) / static_cast<TFloat>(n);
+                        std::fill_n(re, repeat, std::cos(angle));
+                        std::fill_n(im, repeat, backward ? std::sin(angle) : -std::sin(angle));
+                        re += repeat;
+                        im += repeat;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Execute one split-complex Stockham radix-4 butterfly for given pack type in place.
+         * @param[in,out] re The real parts of 4 inputs, and then 4 outputs.
+         * @param[in,out] im The imaginary parts of 4 inputs, and then 4 outputs.
+         * @param[in] wr The real parts of W^p, W^(2p) and W^(3p).
+         * @param[in] wi The imaginary parts of W^p, W^(2p) and W^(3p).
+         */
+        template<typename TPack, bool VBackward>
+        inline void split_stockham_butterfly(typename TPack::TReg (&re)[4],
+                                             typename TPack::TReg (&im)[4],
+                                             const typename TPack::TReg (&wr)[3],
+                                             const typename TPack::TReg (&wi)[3]) {
+            auto apc_r = TPack::add(re[0], re[2]), apc_i = TPack::add(im[0], im[2]);
+            auto amc_r = TPack::sub(re[0], re[2]), amc_i = TPack::sub(im[0], im[2]);
+            auto bpd_r = TPack::add(re[1], re[3]), bpd_i = TPack::add(im[1], im[3]);
+            auto bmd_r = TPack::sub(re[1], re[3]), bmd_i = TPack::sub(im[1], im[3]);
+            // -j * (b - d) for forward transform, or +j * (b - d) for backward transform.
+            auto jbmd_r = VBackward ? TPack::sub(TPack::zero(), bmd_i) : bmd_i;
+            auto jbmd_i = VBackward ? bmd_r : TPack::sub(TPack::zero(), bmd_r);
+
+            const auto twiddle = [&re, &im, &wr, &wi](size_t k, typename TPack::TReg r, typename TPack::TReg i) {
+                re[k] = TPack::sub(TPack::mul(r, wr[k - 1u]), TPack::mul(i, wi[k - 1u]));
+                im[k] = TPack::add(TPack::mul(r, wi[k - 1u]), TPack::mul(i, wr[k - 1u]));
+            };
+            re[0] = TPack::add(apc_r, bpd_r);
+            im[0] = TPack::add(apc_i, bpd_i);
+            twiddle(1u, TPack::add(amc_r, jbmd_r), TPack::add(amc_i, jbmd_i));
+            twiddle(2u, TPack::sub(apc_r, bpd_r), TPack::sub(apc_i, bpd_i));
+            twiddle(3u, TPack::sub(amc_r, jbmd_r), TPack::sub(amc_i, jbmd_i));
+        }
+
+        /**
+         * @brief Execute one split-complex Stockham radix-4 pass whose stride is less than SIMD width.
+         * @details
+         * Butterflies are computed for WIDTH consecutive i at once with repeated twiddle factors,
+         * and outputs are scattered by blocks of S items with register transposes (see RealPack::store_blocks()).
+         * @tparam VStride The stride of this pass, which must be less than SIMD width.
+         */
+        template<size_t VStride, typename TIndex, typename TFloat, bool VBackward>
+        void split_stockham_narrow_pass(const TFloat* xr, const TFloat* xi, TFloat* yr, TFloat* yi, TIndex n, TIndex l, const TFloat* wr, const TFloat* wi) {
+            using TPack = RealPack<TFloat>;
+            using TScalarPack = ScalarRealPack<TFloat>;
+            using TReg = typename TPack::TReg;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr TIndex S = static_cast<TIndex>(VStride);
+
+            const TIndex span = n >> 2;
+            const TIndex count = (l >> 2) * S;
+            TIndex i = 0;
+            // The stride which is not less than WIDTH never reaches here, but it is still instantiated.
+            if constexpr (WIDTH > S) {
+                const TIndex packed = count - count % WIDTH;
+                for (; i < packed; i += WIDTH) {
+                    TReg re[4], im[4], pwr[3], pwi[3];
+                    unrolled_for<4u>([&](auto k) {
+                        re[k] = TPack::load(xr + i + k * span);
+                        im[k] = TPack::load(xi + i + k * span);
+                    });
+                    unrolled_for<3u>([&](auto k) {
+                        pwr[k] = TPack::load(wr + k * count + i);
+                        pwi[k] = TPack::load(wi + k * count + i);
+                    });
+                    split_stockham_butterfly<TPack, VBackward>(re, im, pwr, pwi);
+
+                    // Scatter outputs by blocks of S items, which are 4 * WIDTH continuous items in total.
+                    TPack::template store_blocks<VStride>(yr + (i / S) * (S << 2), re);
+                    TPack::template store_blocks<VStride>(yi + (i / S) * (S << 2), im);
+                }
+            }
+            for (; i < count; ++i) {
+                TFloat re[4], im[4];
+                for (TIndex k = 0; k < static_cast<TIndex>(4); ++k) {
+                    re[k] = xr[i + k * span];
+                    im[k] = xi[i + k * span];
+                }
+                split_stockham_butterfly<TScalarPack, VBackward>(re, im, {wr[i], wr[count + i], wr[count + count + i]},
+                                                                 {wi[i], wi[count + i], wi[count + count + i]});
+                TFloat* block_r = yr + (i / S) * (S << 2) + i % S;
+                TFloat* block_i = yi + (i / S) * (S << 2) + i % S;
+                for (TIndex k = 0; k < static_cast<TIndex>(4); ++k) {
+                    block_r[k * S] = re[k];
+                    block_i[k * S] = im[k];
+                }
+            }
+        }
+
+        /**
+         * @brief Execute one split-complex Stockham radix-4 pass.
+         * @param[in] xr,xi The real parts and imaginary parts of source buffer with length N.
+         * @param[out] yr,yi The real parts and imaginary parts of destination buffer with length N. They must not overlap with source.
+         * @param[in] n The point of FFT.
+         * @param[in] l The length of sub-transform in this pass.
+         * @param[in] s The stride of this pass, that is N / L.
+         * @param[in] wr,wi The real parts and imaginary parts of twiddle factors of this pass.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward>
+        void split_stockham_radix4_pass(const TFloat* xr,
+                                        const TFloat* xi,
+                                        TFloat* yr,
+                                        TFloat* yi,
+                                        TIndex n,
+                                        TIndex l,
+                                        TIndex s,
+                                        const TFloat* wr,
+                                        const TFloat* wi) {
+            using TPack = RealPack<TFloat>;
+            using TReg = typename TPack::TReg;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            // S is a power of 4, and SIMD width is at most 8, so that the stride less than width is 1 or 4.
+            if (s < WIDTH) {
+                if (s == static_cast<TIndex>(1)) split_stockham_narrow_pass<1u, TIndex, TFloat, VBackward>(xr, xi, yr, yi, n, l, wr, wi);
+                else split_stockham_narrow_pass<4u, TIndex, TFloat, VBackward>(xr, xi, yr, yi, n, l, wr, wi);
+                return;
+            }
+
+            // S and WIDTH are both power of 2, so there is no remains.
+            const TIndex q = l >> 2;
+            const TIndex span = n >> 2;
+            for (TIndex p = 0; p < q; ++p) {
+                TReg pwr[3], pwi[3];
+                unrolled_for<3u>([&](auto k) {
+                    pwr[k] = TPack::broadcast(wr[k * q + p]);
+                    pwi[k] = TPack::broadcast(wi[k * q + p]);
+                });
+                const TFloat* src_r = xr + p * s;
+                const TFloat* src_i = xi + p * s;
+                TFloat* dst_r = yr + (p << 2) * s;
+                TFloat* dst_i = yi + (p << 2) * s;
+                for (TIndex j = 0; j < s; j += WIDTH) {
+                    TReg re[4], im[4];
+                    unrolled_for<4u>([&](auto k) {
+                        re[k] = TPack::load(src_r + j + k * span);
+                        im[k] = TPack::load(src_i + j + k * span);
+                    });
+                    split_stockham_butterfly<TPack, VBackward>(re, im, pwr, pwi);
+                    unrolled_for<4u>([&](auto k) {
+                        TPack::store(dst_r + j + k * s, re[k]);
+                        TPack::store(dst_i + j + k * s, im[k]);
+                    });
+                }
+            }
+        }
+
+        /**
+         * @brief Execute the extra split-complex Stockham radix-2 pass for odd exponent.
+         * @param[in] xr,xi The real parts and imaginary parts of source buffer with length N.
+         * @param[out] yr,yi The real parts and imaginary parts of destination buffer with length N. They must not overlap with source.
+         * @param[in] s The stride of this pass, that is N / 2.
+         */
+        template<typename TIndex, typename TFloat>
+        void split_stockham_radix2_pass(const TFloat* xr, const TFloat* xi, TFloat* yr, TFloat* yi, TIndex s) {
+            using TPack = RealPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            TIndex j = 0;
+            if (s >= WIDTH) {
+                for (; j < s; j += WIDTH) {
+                    auto ar = TPack::load(xr + j), ai = TPack::load(xi + j);
+                    auto br = TPack::load(xr + s + j), bi = TPack::load(xi + s + j);
+                    TPack::store(yr + j, TPack::add(ar, br));
+                    TPack::store(yi + j, TPack::add(ai, bi));
+                    TPack::store(yr + s + j, TPack::sub(ar, br));
+                    TPack::store(yi + s + j, TPack::sub(ai, bi));
+                }
+            }
+            for (; j < s; ++j) {
+                const TFloat ar = xr[j], ai = xi[j], br = xr[s + j], bi = xi[s + j];
+                yr[j] = ar + br;
+                yi[j] = ai + bi;
+                yr[s + j] = ar - br;
+                yi[s + j] = ai - bi;
+            }
+        }
+
+        /**
+         * @brief Execute all passes of split-complex Stockham FFT in place.
+         * @details
+         * Passes ping-pong between data and scratch buffers like stockham_passes(),
+         * and the last pass is written into data buffers.
+         * @param[in,out] re,im The real parts and imaginary parts of sequence with length N in natural order.
+         * @param[in] scratch_re,scratch_im The scratch buffers with length N. They must not overlap with data.
+         * @param[in] n The point of FFT which must be a power of 2.
+         * @param[in] wr,wi The twiddle factors filled by fill_split_stockham_twiddles() with the same N and direction.
+         * @tparam VBackward True for backward (inverse) transform.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward = false>
+        void split_stockham_passes(TFloat* re, TFloat* im, TFloat* scratch_re, TFloat* scratch_im, TIndex n, const TFloat* wr, const TFloat* wi) {
+            // The data is also the source of first pass, so that it is copied into scratch if the count of passes is odd.
+            const bool odd_passes = (stockham_pass_count<TIndex>(n) & static_cast<TIndex>(1)) != static_cast<TIndex>(0);
+            const TFloat *xr = re, *xi = im;
+            TFloat *yr = scratch_re, *yi = scratch_im, *other_r = re, *other_i = im;
+            if (odd_passes) {
+                std::copy_n(re, n, scratch_re);
+                std::copy_n(im, n, scratch_im);
+                xr = scratch_re;
+                xi = scratch_im;
+                std::swap(yr, other_r);
+                std::swap(yi, other_i);
+            }
+
+            TIndex l = n, s = 1;
+            for (; l >= static_cast<TIndex>(4); l >>= 2, s <<= 2) {
+                split_stockham_radix4_pass<TIndex, TFloat, VBackward>(xr, xi, yr, yi, n, l, s, wr, wi);
+                const TIndex count = static_cast<TIndex>(3) * (l >> 2) * split_stockham_repeat<TIndex, TFloat>(s);
+                wr += count;
+                wi += count;
+                xr = yr;
+                xi = yi;
+                std::swap(yr, other_r);
+                std::swap(yi, other_i);
+            }
+            if (l == static_cast<TIndex>(2)) {
+                split_stockham_radix2_pass<TIndex, TFloat>(xr, xi, yr, yi, s);
+            }
+        }
+
+        /**
+         * @brief Split given point into the radices of mixed-radix Stockham passes.
+         * @details
+         * Radix 4 is taken as many as possible, then at most one radix 2, and then radix 3, 5 and 7.
+         * So that the passes with odd radix have the stride of a multiple of 4 (if N is), which fits SIMD width.
+         * @param[in] n The point of FFT.
+         * @return The radices in pass order, or empty sequence if \p n has any prime factor larger than 7.
+         */
+        template<typename TIndex>
+        std::vector<TIndex> mixed_radix_factors(TIndex n) {
+            std::vector<TIndex> radices;
+            for (TIndex radix : {static_cast<TIndex>(4), static_cast<TIndex>(2), static_cast<TIndex>(3), static_cast<TIndex>(5), static_cast<TIndex>(7)}) {
+                while (n % radix == static_cast<TIndex>(0)) {
+                    radices.emplace_back(radix);
+                    n /= radix;
+                }
+            }
+            if (n != static_cast<TIndex>(1)) radices.clear();
+            return radices;
+        }
+
+        /**
+         * @brief Get the count of twiddle factors used by all mixed-radix Stockham passes.
+         * @param[in] n The point of FFT.
+         * @param[in] radices The radices produced by mixed_radix_factors() with the same N.
+         * @return The count of complex twiddle factors.
+         */
+        template<typename TIndex>
+        TIndex mixed_radix_twiddle_count(TIndex n, const std::vector<TIndex>& radices) {
+            TIndex count = 0;
+            for (TIndex radix : radices) {
+                count += (radix - static_cast<TIndex>(1)) * (n / radix);
+                n /= radix;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Fill twiddle factors used by all mixed-radix Stockham passes.
+         * @details
+         * For the pass whose sub-transform length is L and radix is R,
+         * the R - 1 twiddle factors <TT>W(L)^(j * p)</TT> (j from 1 to R - 1) of each butterfly p are stored adjacently.
+         * @param[out] dst The buffer receiving twiddle factors. Its length must be mixed_radix_twiddle_count() with the same arguments.
+         * @param[in] n The point of FFT.
+         * @param[in] radices The radices produced by mixed_radix_factors() with the same N.
+         * @param[in] backward True for backward (inverse) transform whose twiddle factors are conjugated.
+         */
+        template<typename TIndex, typename TFloat>
+        void fill_mixed_radix_twiddles(std::complex<TFloat>* dst, TIndex n, const std::vector<TIndex>& radices, bool backward = false) {
+            // W(L)^e = W(N)^(e * N / L), and the exponent is reduced by N before converting to angle.
+            auto wnp = [n, backward](TIndex p) -> std::complex<TFloat> {
+                TFloat angle = tau_v<TFloat> * static_cast<TFloat>(p % n) / static_cast<TFloat>(n);
+                return std::complex<TFloat>(std::cos(angle), backward ? std::sin(angle) : -std::sin(angle));
+            };
+
+            TIndex l = n;
+            for (TIndex radix : radices) {
+                const TIndex q = l / radix;
+                const TIndex stride = n / l;
+                for (TIndex p = 0; p < q; ++p) {
+                    for (TIndex j = 1; j < radix; ++j) {
+                        *(dst++) = wnp(j * p * stride);
+                    }
+                }
+                l = q;
+            }
+        }
+
+        /**
+         * @brief Get the coefficients of odd radix DFT kernel.
+         * @details
+         * The table depends on R only, so one copy per radix and float type is shared by the kernels of every plan.
+         * @return The table with length 2 * R. The first R items are <TT>cos(2pi * m / R)</TT> and the rest are <TT>sin(2pi * m / R)</TT>.
+         */
+        template<size_t VRadix, typename TFloat>
+        const TFloat* odd_radix_coefficients() {
+            static const std::array<TFloat, VRadix * 2u> table = []() {
+                std::array<TFloat, VRadix * 2u> rv{};
+                for (size_t m = 0u; m < VRadix; ++m) {
+                    const double angle = tau_v<double> * static_cast<double>(m) / static_cast<double>(VRadix);
+                    rv[m] = static_cast<TFloat>(std::cos(angle));
+                    rv[VRadix + m] = static_cast<TFloat>(std::sin(angle));
+                }
+                return rv;
+            }();
+            return table.data();
+        }
+
+        /**
+         * @brief Compute small DFT with radix 2, 3, 4, 5 or 7 on packs.
+         * @details
+         * Odd radix is computed by pairing item k and R - k, so that only (R - 1) / 2 rotations are needed.
+         * @param[in,out] a The input items, which are overwritten by output items.
+         * @param[in] coefficients The coefficients of odd radix broadcast into packs (the layout of odd_radix_coefficients()).
+         * Unused for radix 2 and 4.
+         * @tparam VBackward True for backward (inverse) transform.
+         */
+        template<size_t VRadix, typename TPack, bool VBackward>
+        inline void small_dft(typename TPack::TReg (&a)[VRadix], const typename TPack::TReg* coefficients) {
+            using TReg = typename TPack::TReg;
+            auto rotate = [](TReg v) -> TReg { return VBackward ? TPack::mul_pos_i(v) : TPack::mul_neg_i(v); };
+
+            if constexpr (VRadix == 2u) {
+                TReg sum = TPack::add(a[0], a[1]);
+                a[1] = TPack::sub(a[0], a[1]);
+                a[0] = sum;
+            } else if constexpr (VRadix == 4u) {
+                TReg apc = TPack::add(a[0], a[2]);
+                TReg amc = TPack::sub(a[0], a[2]);
+                TReg bpd = TPack::add(a[1], a[3]);
+                TReg jbmd = rotate(TPack::sub(a[1], a[3]));
+                a[0] = TPack::add(apc, bpd);
+                a[1] = TPack::add(amc, jbmd);
+                a[2] = TPack::sub(apc, bpd);
+                a[3] = TPack::sub(amc, jbmd);
+            } else {
+                static_assert(VRadix % 2u == 1u, "unexpected radix of small DFT");
+                constexpr size_t HALF = VRadix / 2u;
+                const TReg* cosine = coefficients;
+                const TReg* sine = coefficients + VRadix;
+
+                // X[j] = a0 + sum(cos(2pi * j * k / R) * (a[k] + a[R - k])) -/+ j * sum(sin(2pi * j * k / R) * (a[k] - a[R - k]))
+                TReg sums[HALF], diffs[HALF];
+                TReg dc = a[0];
+                unrolled_for<HALF>([&](auto i) {
+                    constexpr size_t K = decltype(i)::value + 1u;
+                    sums[K - 1u] = TPack::add(a[K], a[VRadix - K]);
+                    diffs[K - 1u] = TPack::sub(a[K], a[VRadix - K]);
+                    dc = TPack::add(dc, sums[K - 1u]);
+                });
+                unrolled_for<HALF>([&](auto i) {
+                    constexpr size_t J = decltype(i)::value + 1u;
+                    TReg even = a[0];
+                    TReg odd = TPack::mul_parts(diffs[0], sine[J % VRadix]);
+                    unrolled_for<HALF>([&](auto h) {
+                        constexpr size_t K = decltype(h)::value + 1u;
+                        constexpr size_t M = (J * K) % VRadix;
+                        even = TPack::add(even, TPack::mul_parts(sums[K - 1u], cosine[M]));
+                        if constexpr (K > 1u) odd = TPack::add(odd, TPack::mul_parts(diffs[K - 1u], sine[M]));
+                    });
+                    odd = rotate(odd);
+                    // a[j] and a[R - j] are not read anymore, because a[0] and sums are used.
+                    a[J] = TPack::add(even, odd);
+                    a[VRadix - J] = TPack::sub(even, odd);
+                });
+                a[0] = dc;
+            }
+        }
+
+        /**
+         * @brief Execute one mixed-radix Stockham butterfly for given pack type.
+         * @details
+         * Input are R items with distance L / R (multiplied by stride) from source buffer,
+         * and output are R adjacent items (multiplied by stride) in destination buffer.
+         */
+        template<size_t VRadix, typename TPack, bool VBackward, typename TIndex, typename TComplex>
+        inline void mixed_radix_butterfly(const TComplex* x,
+                                          TIndex span,
+                                          TComplex* y,
+                                          TIndex s,
+                                          const typename TPack::TReg* twiddles,
+                                          const typename TPack::TReg* coefficients) {
+            typename TPack::TReg a[VRadix];
+            unrolled_for<VRadix>([&](auto i) { a[i] = TPack::load(x + static_cast<TIndex>(i) * span); });
+            small_dft<VRadix, TPack, VBackward>(a, coefficients);
+            TPack::store(y, a[0]);
+            unrolled_for<VRadix - 1u>([&](auto i) {
+                constexpr size_t J = decltype(i)::value + 1u;
+                TPack::store(y + static_cast<TIndex>(J) * s, TPack::mul(a[J], twiddles[J - 1u]));
+            });
+        }
+
+        /**
+         * @brief Execute one mixed-radix Stockham pass.
+         * @param[in] x The source buffer with length N.
+         * @param[out] y The destination buffer with length N. It must not overlap with \p x.
+         * @param[in] l The length of sub-transform in this pass.
+         * @param[in] s The stride of this pass, that is N / L.
+         * @param[in] twiddles The twiddle factors of this pass.
+         */
+        template<size_t VRadix, typename TIndex, typename TFloat, bool VBackward>
+        void mixed_radix_pass(const std::complex<TFloat>* x, std::complex<TFloat>* y, TIndex l, TIndex s, const std::complex<TFloat>* twiddles) {
+            using TComplex = std::complex<TFloat>;
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr size_t COEFFICIENT_COUNT = VRadix % 2u == 1u ? VRadix * 2u : 1u;
+
+            // Broadcast the coefficients of odd radix into packs once for all butterflies.
+            typename TPack::TReg coefficients[COEFFICIENT_COUNT];
+            typename TScalarPack::TReg scalar_coefficients[COEFFICIENT_COUNT];
+            if constexpr (VRadix % 2u == 1u) {
+                const TFloat* table = odd_radix_coefficients<VRadix, TFloat>();
+                for (size_t i = 0u; i < COEFFICIENT_COUNT; ++i) {
+                    coefficients[i] = TPack::broadcast(TComplex(table[i], table[i]));
+                    scalar_coefficients[i] = TComplex(table[i], table[i]);
+                }
+            }
+
+            const TIndex q = l / static_cast<TIndex>(VRadix);
+            const TIndex span = q * s;
+            for (TIndex p = 0; p < q; ++p) {
+                const TComplex* xp = x + p * s;
+                TComplex* yp = y + p * static_cast<TIndex>(VRadix) * s;
+                const TComplex* w = twiddles + p * static_cast<TIndex>(VRadix - 1u);
+
+                TIndex j = 0;
+                if (s >= WIDTH) {
+                    typename TPack::TReg pw[VRadix - 1u];
+                    for (size_t k = 0u; k < VRadix - 1u; ++k) pw[k] = TPack::broadcast(w[k]);
+                    for (; j + WIDTH <= s; j += WIDTH) {
+                        mixed_radix_butterfly<VRadix, TPack, VBackward>(xp + j, span, yp + j, s, pw, coefficients);
+                    }
+                }
+                for (; j < s; ++j) {
+                    mixed_radix_butterfly<VRadix, TScalarPack, VBackward>(xp + j, span, yp + j, s, w, scalar_coefficients);
+                }
+            }
+        }
+
+        /**
+         * @brief Execute all passes of mixed-radix Stockham FFT.
+         * @details
+         * Passes ping-pong between \p dst and \p scratch in the same way as stockham_passes().
+         * @param[in] src The source sequence with length N in natural order.
+         * @param[out] dst The destination sequence with length N. It can be the same one with \p src.
+         * @param[in] scratch The scratch buffer with length N. It must not overlap with \p src or \p dst.
+         * @param[in] n The point of FFT.
+         * @param[in] radices The radices produced by mixed_radix_factors() with the same N.
+         * @param[in] twiddles The twiddle factors filled by fill_mixed_radix_twiddles() with the same N and direction.
+         * @tparam VBackward True for backward (inverse) transform.
+         */
+        template<typename TIndex, typename TFloat, bool VBackward = false>
+        void mixed_radix_passes(const std::complex<TFloat>* src,
+                                std::complex<TFloat>* dst,
+                                std::complex<TFloat>* scratch,
+                                TIndex n,
+                                const std::vector<TIndex>& radices,
+                                const std::complex<TFloat>* twiddles) {
+            using TComplex = std::complex<TFloat>;
+
+            const bool odd_passes = (radices.size() & 1u) != 0u;
+            if (src == dst && odd_passes) {
+                std::copy_n(src, n, scratch);
+                src = scratch;
+            }
+            // The first pass is written into destination if the count of passes is odd.
+            const TComplex* x = src;
+            TComplex* y = odd_passes ? dst : scratch;
+            TComplex* other = odd_passes ? scratch : dst;
+
+            TIndex l = n, s = 1;
+            for (TIndex radix : radices) {
+                switch (radix) {
+                    case 2u:
+                        mixed_radix_pass<2u, TIndex, TFloat, VBackward>(x, y, l, s, twiddles);
+                        break;
+                    case 3u:
+                        mixed_radix_pass<3u, TIndex, TFloat, VBackward>(x, y, l, s, twiddles);
+                        break;
+                    case 4u:
+                        mixed_radix_pass<4u, TIndex, TFloat, VBackward>(x, y, l, s, twiddles);
+                        break;
+                    case 5u:
+                        mixed_radix_pass<5u, TIndex, TFloat, VBackward>(x, y, l, s, twiddles);
+                        break;
+                    case 7u:
+                        mixed_radix_pass<7u, TIndex, TFloat, VBackward>(x, y, l, s, twiddles);
+                        break;
+                    default:
+                        throw std::invalid_argument("unexpected radix of mixed-radix FFT");
+                }
+                twiddles += (radix - static_cast<TIndex>(1)) * (l / radix);
+                l /= radix;
+                s *= radix;
+                x = y;
+                std::swap(y, other);
+            }
+        }
+
+        /**
+         * @brief Get the scratch buffer owned by current thread.
+         * @details
+         * The buffer grows on demand and is never shrunk,
+         * so it only allocates when larger buffer is requested first time in current thread.
+         * @param[in] n The required length of buffer.
+         * @return The pointer to scratch buffer with at least given length.
+         */
+        template<typename TFloat>
+        std::complex<TFloat>* thread_scratch(size_t n) {
+            thread_local std::vector<std::complex<TFloat>> scratch;
+            if (scratch.size() < n) scratch.resize(n);
+            return scratch.data();
+        }
+
+        /**
+         * @brief Convert half-precision complex sequence into single precision.
+         * @param[in] src The half-precision complex sequence.
+         * @param[out] dst The single precision complex sequence.
+         * @param[in] n The length of both sequences.
+         */
+        template<typename TIndex, typename THalf>
+        void widen_compact(const CompactComplex<THalf>* src, std::complex<float>* dst, TIndex n) {
+            const THalf* from = reinterpret_cast<const THalf*>(src);
+            float* to = reinterpret_cast<float*>(dst);
+            const TIndex count = n * static_cast<TIndex>(2);
+            TIndex i = 0;
+#if defined(YYCC_FFT_SIMD_AVX2) && defined(YYCC_FFT_HAS_FLOAT16) && defined(__F16C__)
+            if constexpr (std::is_same_v<THalf, _Float16>) {
+                for (; i + 8u <= count; i += 8u) {
+                    _mm256_storeu_ps(to + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i))));
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                to[i] = static_cast<float>(from[i]);
+            }
+        }
+
+        /**
+         * @brief Convert single precision complex sequence into half-precision with rounding to nearest even.
+         * @param[in] src The single precision complex sequence.
+         * @param[out] dst The half-precision complex sequence.
+         * @param[in] n The length of both sequences.
+         */
+        template<typename TIndex, typename THalf>
+        void narrow_compact(const std::complex<float>* src, CompactComplex<THalf>* dst, TIndex n) {
+            const float* from = reinterpret_cast<const float*>(src);
+            THalf* to = reinterpret_cast<THalf*>(dst);
+            const TIndex count = n * static_cast<TIndex>(2);
+            TIndex i = 0;
+#if defined(YYCC_FFT_SIMD_AVX2) && defined(YYCC_FFT_HAS_FLOAT16) && defined(__F16C__)
+            if constexpr (std::is_same_v<THalf, _Float16>) {
+                for (; i + 8u <= count; i += 8u) {
+                    __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(from + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i), packed);
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                to[i] = static_cast<THalf>(from[i]);
+            }
+        }
+
+        /**
+         * @brief Multiply two complex sequences item by item.
+         * @param[out] dst The sequence receiving result. It can be the same one with \p a or \p b.
+         * @param[in] a, b The complex sequences for multiplication.
+         * @param[in] n The length of all sequences.
+         */
+        template<typename TIndex, typename TFloat>
+        void spectrum_multiply(std::complex<TFloat>* dst, const std::complex<TFloat>* a, const std::complex<TFloat>* b, TIndex n) {
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            TIndex i = 0;
+            for (; i + WIDTH <= n; i += WIDTH) {
+                TPack::store(dst + i, TPack::mul(TPack::load(a + i), TPack::load(b + i)));
+            }
+            for (; i < n; ++i) {
+                dst[i] = TScalarPack::mul(a[i], b[i]);
+            }
+        }
+
+        /**
+         * @brief Multiply two complex sequences item by item and accumulate the result.
+         * @param[in,out] dst The sequence accumulating result.
+         * @param[in] a, b The complex sequences for multiplication.
+         * @param[in] n The length of all sequences.
+         */
+        template<typename TIndex, typename TFloat>
+        void spectrum_multiply_add(std::complex<TFloat>* dst, const std::complex<TFloat>* a, const std::complex<TFloat>* b, TIndex n) {
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            TIndex i = 0;
+            for (; i + WIDTH <= n; i += WIDTH) {
+                TPack::store(dst + i, TPack::add(TPack::load(dst + i), TPack::mul(TPack::load(a + i), TPack::load(b + i))));
+            }
+            for (; i < n; ++i) {
+                dst[i] += TScalarPack::mul(a[i], b[i]);
+            }
+        }
+
+        /**
+         * @brief Split WIDTH pairs (k, N/2 - k) of packed spectrum into real spectrum. See real_fft_split().
+         */
+        template<typename TPack, typename TIndex, typename TComplex>
+        inline void real_fft_split_step(TComplex* data, TIndex half_point, TIndex k, const TComplex* table) {
+            // The mirrored items N/2 - k - WIDTH + 1, ..., N/2 - k are loaded and stored in reversed order.
+            TComplex* mirror = data + (half_point - k - static_cast<TIndex>(TPack::WIDTH - 1u));
+            const auto half = TPack::broadcast(TComplex(static_cast<typename TComplex::value_type>(0.5),
+                                                        static_cast<typename TComplex::value_type>(0.5)));
+            const auto a = TPack::load(data + k);
+            const auto b = TPack::conj(TPack::reverse(TPack::load(mirror)));
+            const auto even = TPack::mul_parts(TPack::add(a, b), half);
+            const auto odd = TPack::mul_parts(TPack::mul_neg_i(TPack::sub(a, b)), half);
+            const auto rot = TPack::mul(TPack::load(table + k), odd);
+            TPack::store(data + k, TPack::add(even, rot));
+            TPack::store(mirror, TPack::reverse(TPack::conj(TPack::sub(even, rot))));
+        }
+
+        /**
+         * @brief Split the packed spectrum Z of real FFT into real spectrum X in place, except item 0 and N/4.
+         * @details
+         * <TT>Xe[k] = (Z[k] + conj(Z[N/2 - k])) / 2</TT>, <TT>Xo[k] = -j(Z[k] - conj(Z[N/2 - k])) / 2</TT>,
+         * <TT>X[k] = Xe[k] + W(N)^k * Xo[k]</TT> and <TT>X[N/2 - k] = conj(Xe[k] - W(N)^k * Xo[k])</TT>.
+         * So pairs (k, N/2 - k) are processed together, and WIDTH pairs are processed at once by SIMD pack.
+         * @param[in,out] data The packed spectrum with length N / 2.
+         * @param[in] half_point The half of N.
+         * @param[in] end The end of k, that is, <TT>(N / 2 + 1) / 2</TT>, so that each pair is processed once.
+         * @param[in] table The W(N)^k table whose length is at least \p end.
+         */
+        template<typename TIndex, typename TFloat>
+        void real_fft_split(std::complex<TFloat>* data, TIndex half_point, TIndex end, const std::complex<TFloat>* table) {
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            // Items of k and mirrored items never overlap in one step, because k + WIDTH <= end.
+            TIndex k = static_cast<TIndex>(1);
+            for (; k + WIDTH <= end; k += WIDTH) {
+                real_fft_split_step<TPack>(data, half_point, k, table);
+            }
+            for (; k < end; ++k) {
+                real_fft_split_step<TScalarPack>(data, half_point, k, table);
+            }
+        }
+
+        /**
+         * @brief Merge WIDTH pairs (k, N/2 - k) of real spectrum into packed spectrum. See real_fft_merge().
+         */
+        template<typename TPack, typename TIndex, typename TComplex>
+        inline void real_fft_merge_step(
+            const TComplex* src, TComplex* dst, TIndex half_point, TIndex k, const TComplex* table, typename TPack::TReg scale) {
+            const TIndex mirror = half_point - k - static_cast<TIndex>(TPack::WIDTH - 1u);
+            const auto a = TPack::load(src + k);
+            const auto b = TPack::conj(TPack::reverse(TPack::load(src + mirror)));
+            const auto even = TPack::add(a, b);
+            const auto odd = TPack::mul_pos_i(TPack::mul(TPack::conj(TPack::load(table + k)), TPack::sub(a, b)));
+            TPack::store(dst + k, TPack::mul_parts(TPack::add(even, odd), scale));
+            TPack::store(dst + mirror, TPack::reverse(TPack::conj(TPack::mul_parts(TPack::sub(even, odd), scale))));
+        }
+
+        /**
+         * @brief Merge the real spectrum X of real FFT into packed spectrum Z, except item 0 and N/4.
+         * @details
+         * This is the reverse of real_fft_split().
+         * <TT>Xe[k] = X[k] + conj(X[N/2 - k])</TT>, <TT>Xo[k] = conj(W(N)^k) * (X[k] - conj(X[N/2 - k]))</TT>,
+         * <TT>Z[k] = (Xe[k] + j * Xo[k]) * scale</TT> and <TT>Z[N/2 - k] = conj(Xe[k] - j * Xo[k]) * scale</TT>.
+         * @param[in] src The real spectrum with length N / 2 + 1.
+         * @param[out] dst The packed spectrum with length N / 2. It can be the same one with \p src.
+         * @param[in] half_point The half of N.
+         * @param[in] end The end of k, the same as real_fft_split().
+         * @param[in] table The W(N)^k table whose length is at least \p end.
+         * @param[in] scale The real scale applied to result.
+         */
+        template<typename TIndex, typename TFloat>
+        void real_fft_merge(const std::complex<TFloat>* src,
+                            std::complex<TFloat>* dst,
+                            TIndex half_point,
+                            TIndex end,
+                            const std::complex<TFloat>* table,
+                            TFloat scale) {
+            using TPack = ComplexPack<TFloat>;
+            using TScalarPack = ScalarComplexPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            TIndex k = static_cast<TIndex>(1);
+            const auto packed_scale = TPack::broadcast(std::complex<TFloat>(scale, scale));
+            for (; k + WIDTH <= end; k += WIDTH) {
+                real_fft_merge_step<TPack>(src, dst, half_point, k, table, packed_scale);
+            }
+            for (; k < end; ++k) {
+                real_fft_merge_step<TScalarPack>(src, dst, half_point, k, table, std::complex<TFloat>(scale, scale));
+            }
+        }
+
+        /**
+         * @brief Compute the squared magnitude of complex spectrum, that is, its power.
+         * @param[in] src The complex spectrum.
+         * @param[out] dst The sequence receiving power.
+         * @param[in] n The length of both sequences.
+         */
+        template<typename TIndex, typename TFloat>
+        void power_spectrum(const std::complex<TFloat>* src, TFloat* dst, TIndex n) {
+            using TPack = PowerPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            for (; i < packed; i += WIDTH) {
+                TPack::store(dst + i, TPack::load_power(src + i));
+            }
+            for (; i < n; ++i) {
+                dst[i] = src[i].real() * src[i].real() + src[i].imag() * src[i].imag();
+            }
+        }
+
+        /**
+         * @brief Convert complex spectrum into amplitude in decibel used by FriendlyFft.
+         * @details
+         * The result is <TT>10 * log10(abs(src[i]))</TT>, which is evaluated as <TT>5 * log10(power)</TT>
+         * so that no square root is computed, and the logarithm is computed by fast_log10().
+         * The absolute error against \c std::log10 is below 1e-4 dB for \c float and 1e-6 dB for \c double.
+         * Zero amplitude produces the finite floor value explained in fast_log10().
+         * @param[in] src The complex spectrum.
+         * @param[out] dst The sequence receiving amplitude in decibel.
+         * @param[in] n The length of both sequences.
+         */
+        template<typename TIndex, typename TFloat>
+        void amplitude_db(const std::complex<TFloat>* src, TFloat* dst, TIndex n) {
+            using TPack = PowerPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr TFloat FACTOR = static_cast<TFloat>(5);
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            for (; i < packed; i += WIDTH) {
+                TPack::store(dst + i, TPack::scale(TPack::log10(TPack::load_power(src + i)), FACTOR));
+            }
+            for (; i < n; ++i) {
+                dst[i] = FACTOR * fast_log10(src[i].real() * src[i].real() + src[i].imag() * src[i].imag());
+            }
+        }
+
+        /**
+         * @brief Accumulate the power of complex spectrum into accumulator.
+         * @details
+         * If \p VExponential is false, the result is <TT>acc[i] + abs(src[i])^2</TT>.
+         * Otherwise, it is exponential moving average <TT>acc[i] + weight * (abs(src[i])^2 - acc[i])</TT>.
+         * @param[in] src The complex spectrum.
+         * @param[in,out] acc The accumulated power.
+         * @param[in] n The length of both sequences.
+         * @param[in] weight The weight of new power in exponential moving average. It is ignored if \p VExponential is false.
+         * @tparam VExponential True for exponential moving average.
+         */
+        template<bool VExponential, typename TIndex, typename TFloat>
+        void accumulate_power(const std::complex<TFloat>* src, TFloat* acc, TIndex n, TFloat weight) {
+            using TPack = PowerPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            for (; i < packed; i += WIDTH) {
+                auto old = TPack::load(acc + i);
+                auto power = TPack::load_power(src + i);
+                if constexpr (VExponential) TPack::store(acc + i, TPack::add(old, TPack::scale(TPack::sub(power, old), weight)));
+                else TPack::store(acc + i, TPack::add(old, power));
+            }
+            for (; i < n; ++i) {
+                TFloat power = src[i].real() * src[i].real() + src[i].imag() * src[i].imag();
+                if constexpr (VExponential) acc[i] += weight * (power - acc[i]);
+                else acc[i] += power;
+            }
+        }
+
+        /**
+         * @brief Convert power into decibel.
+         * @details
+         * The result is <TT>10 * log10(src[i])</TT> computed by fast_log10(),
+         * with the same accuracy and floor value as amplitude_db().
+         * @param[in] src The power sequence.
+         * @param[out] dst The sequence receiving decibel. It can be the same one with \p src.
+         * @param[in] n The length of both sequences.
+         */
+        template<typename TIndex, typename TFloat>
+        void power_db(const TFloat* src, TFloat* dst, TIndex n) {
+            using TPack = PowerPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr TFloat FACTOR = static_cast<TFloat>(10);
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            for (; i < packed; i += WIDTH) {
+                TPack::store(dst + i, TPack::scale(TPack::log10(TPack::load(src + i)), FACTOR));
+            }
+            for (; i < n; ++i) {
+                dst[i] = FACTOR * fast_log10(src[i]);
+            }
+        }
+
+        /**
+         * @brief Convert power into amplitude in decibel used by FriendlyFft.
+         * @details
+         * The result is <TT>5 * log10(src[i])</TT>, which is the same as amplitude_db() of the complex spectrum producing this power.
+         * @param[in] src The power sequence.
+         * @param[out] dst The sequence receiving amplitude in decibel. It can be the same one with \p src.
+         * @param[in] n The length of both sequences.
+         */
+        template<typename TIndex, typename TFloat>
+        void amplitude_db(const TFloat* src, TFloat* dst, TIndex n) {
+            using TPack = PowerPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr TFloat FACTOR = static_cast<TFloat>(5);
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            for (; i < packed; i += WIDTH) {
+                TPack::store(dst + i, TPack::scale(TPack::log10(TPack::load(src + i)), FACTOR));
+            }
+            for (; i < n; ++i) {
+                dst[i] = FACTOR * fast_log10(src[i]);
+            }
+        }
+
+        /**
+         * @brief Pool the power of a run of bins by maximum or summation.
+         * @details The power is pooled in SIMD lanes, and lanes are pooled at the end.
+         * @param[in] src
+         * The run of bins. If it is complex spectrum, its power is computed on the fly.
+         * Otherwise it is power spectrum.
+         * @param[in] n The length of run.
+         * @return The maximum or the sum of power in run. It is zero if the run is empty.
+         * @tparam VMax True for maximum, false for summation.
+         */
+        template<bool VMax, typename TIndex, typename TFloat, typename TSource>
+        TFloat pool_power(const TSource* src, TIndex n) {
+            using TPack = PowerPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+            constexpr bool IS_COMPLEX = std::is_same_v<TSource, std::complex<TFloat>>;
+            const auto pool = [](auto a, auto b) {
+                if constexpr (VMax) return TPack::max(a, b);
+                else return TPack::add(a, b);
+            };
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            TFloat rv = static_cast<TFloat>(0);
+            if (packed != static_cast<TIndex>(0)) {
+                auto acc = TPack::zero();
+                for (; i < packed; i += WIDTH) {
+                    if constexpr (IS_COMPLEX) acc = pool(acc, TPack::load_power(src + i));
+                    else acc = pool(acc, TPack::load(src + i));
+                }
+                TFloat lanes[TPack::WIDTH];
+                TPack::store(lanes, acc);
+                for (TFloat lane : lanes) rv = VMax ? std::max(rv, lane) : rv + lane;
+            }
+            for (; i < n; ++i) {
+                TFloat power;
+                if constexpr (IS_COMPLEX) power = src[i].real() * src[i].real() + src[i].imag() * src[i].imag();
+                else power = src[i];
+                rv = VMax ? std::max(rv, power) : rv + power;
+            }
+            return rv;
+        }
+
+        /**
+         * @brief Compute the dot product of two real sequences.
+         * @details The products are accumulated in SIMD lanes, and lanes are summed at the end.
+         * @param[in] a The first sequence.
+         * @param[in] b The second sequence.
+         * @param[in] n The length of both sequences.
+         * @return The sum of <TT>a[i] * b[i]</TT>.
+         */
+        template<typename TIndex, typename TFloat>
+        TFloat dot_product(const TFloat* a, const TFloat* b, TIndex n) {
+            using TPack = RealPack<TFloat>;
+            constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+            const TIndex packed = n - n % WIDTH;
+            TIndex i = 0;
+            TFloat sum = static_cast<TFloat>(0);
+            if (packed != static_cast<TIndex>(0)) {
+                auto acc = TPack::zero();
+                for (; i < packed; i += WIDTH) {
+                    acc = TPack::add(acc, TPack::mul(TPack::load(a + i), TPack::load(b + i)));
+                }
+                TFloat lanes[TPack::WIDTH];
+                TPack::store(lanes, acc);
+                for (TFloat lane : lanes) sum += lane;
+            }
+            for (; i < n; ++i) {
+                sum += a[i] * b[i];
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Compute the phase of given bin after given count of samples, in cycles.
+         * @details
+         * The result is the fraction of <TT>bin * time / n</TT>.
+         * The integral part of bin is multiplied by time in integer arithmetic,
+         * whose overflow is harmless because n is a power of 2,
+         * so that the precision is not lost even if the product is much larger than the mantissa of float-point number.
+         * @param[in] bin The bin which may be fractional, negative, or not less than n.
+         * @param[in] time The count of samples.
+         * @param[in] n The point of DFT which must be a power of 2.
+         * @return The phase in range [0, 1).
+         */
+        template<typename TIndex, typename TFloat>
+        TFloat bin_cycles(TFloat bin, TIndex time, TIndex n) {
+            const TFloat point = static_cast<TFloat>(n);
+            // Wrap bin into [0, n) which does not change the phase.
+            bin -= std::floor(bin / point) * point;
+            const TFloat whole = std::floor(bin);
+            const TIndex wrapped = (static_cast<TIndex>(whole) * time) & (n - static_cast<TIndex>(1));
+            const TFloat cycles = (static_cast<TFloat>(wrapped) + (bin - whole) * static_cast<TFloat>(time)) / point;
+            return cycles - std::floor(cycles);
+        }
+
+        /**
+         * @brief The thread safe cache of tables which are built from parameters and shared by instances.
+         * @details
+         * The cache only holds weak references, and instances own tables by shared pointers.
+         * So a table is freed once no instance uses it, rather than living until program exits,
+         * and using many different parameters does not leak their tables.
+         * Entries of freed tables are removed whenever a new table is built,
+         * so the count of entries is bounded by the count of alive tables.
+         * @tparam TKey The type of parameters building table, which must be comparable by <TT>operator<</TT>.
+         * @tparam TTable The type of table.
+         */
+        template<typename TKey, typename TTable>
+        class SharedTableCache {
+        public:
+            using TTablePtr = std::shared_ptr<const TTable>;
+
+            SharedTableCache() : mutex(), entries() {}
+            YYCC_DELETE_COPY_MOVE(SharedTableCache)
+
+        private:
+            std::mutex mutex;
+            std::map<TKey, std::weak_ptr<const TTable>> entries;
+
+        public:
+            /**
+             * @brief Get the table of given parameters, and build it if it does not exist or has been freed.
+             * @param[in] key The parameters of table.
+             * @param[in] builder The function building table, which returns TTablePtr. It is called with cache locked.
+             * @return The shared table.
+             */
+            template<typename TBuilder>
+            TTablePtr get(const TKey& key, TBuilder&& builder) {
+                std::lock_guard<std::mutex> locker(mutex);
+                auto finder = entries.find(key);
+                if (finder != entries.end()) {
+                    TTablePtr rv = finder->second.lock();
+                    if (rv != nullptr) return rv;
+                }
+
+                TTablePtr rv = builder();
+                std::erase_if(entries, [](const auto& entry) { return entry.second.expired(); });
+                entries.insert_or_assign(key, rv);
+                return rv;
+            }
+
+            /**
+             * @brief Get the count of cached entries, which is mainly used for testing.
+             * @return The count of entries, including the entries of freed tables which are not removed yet.
+             */
+            size_t get_entry_count() {
+                std::lock_guard<std::mutex> locker(mutex);
+                return entries.size();
+            }
+        };
+
+    } // namespace util
+
+#pragma region Window
+
+    /// @brief The type of window function.
+    enum class WindowType {
+        HanningWindow,        ///< Hann window.
+        HammingWindow,        ///< Hamming window.
+        BlackmanWindow,       ///< Classic 3-term Blackman window.
+        BlackmanHarrisWindow, ///< 4-term Blackman-Harris window with -92dB side lobe.
+        KaiserWindow,         ///< Kaiser window whose shape is decided by parameter beta.
+        FlatTopWindow,        ///< Flat-top window for accurate amplitude measurement.
+        CustomWindow,         ///< Window function data supplied by user.
+    };
+
+    /**
+     * @brief The window function applied to data before FFT.
+     * @details
+     * Window function data of built-in types are computed once per window type (and beta for Kaiser window),
+     * float point type and N, and they are shared by all instances.
+     * So constructing window is only a cache lookup while another instance with the same type is alive, and copying window is cheap.
+     * The data is freed when the last instance using it is destroyed, so that using many Kaiser betas does not leak memory.
+     *
+     * All window functions are symmetric, that is, the denominator of phase is N - 1.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The length of window which must be >= 2.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN>
+    class Window {
+    private:
+        static constexpr TIndex N = VN;
+        using TComplex = std::complex<TFloat>;
+        using TWindowData = std::shared_ptr<const TFloat[]>;
+
+    public:
+        /// @brief The default beta of Kaiser window, whose side lobe is about -90dB.
+        static constexpr TFloat DEFAULT_KAISER_BETA = static_cast<TFloat>(8.6);
+
+        /**
+         * @brief Construct built-in window function.
+         * @param[in] win_type The type of window function. It can not be WindowType::CustomWindow.
+         * @param[in] kaiser_beta The beta of Kaiser window. It must be finite and non-negative. It is ignored by other types.
+         * @exception std::invalid_argument Invalid window type or beta.
+         */
+        Window(WindowType win_type, TFloat kaiser_beta = DEFAULT_KAISER_BETA) :
+            window_type(win_type), window_data(get_shared_data(win_type, kaiser_beta)) {}
+        /**
+         * @brief Construct window function with data supplied by user.
+         * @param[in] custom_data The window function data with length N. It is copied into this instance.
+         * @exception std::invalid_argument Given data is nullptr.
+         */
+        explicit Window(const TFloat* custom_data) : window_type(WindowType::CustomWindow), window_data(nullptr) {
+            if (custom_data == nullptr) {
+                throw std::invalid_argument("nullptr data is not allowed for custom window.");
+            }
+            auto data = std::make_shared<TFloat[]>(N);
+            std::copy_n(custom_data, N, data.get());
+            window_data = std::move(data);
+        }
+
+    private:
+        WindowType window_type;
+        TWindowData window_data;
+
+        using TCacheKey = std::pair<WindowType, TFloat>;
+        using TCache = util::SharedTableCache<TCacheKey, TFloat[]>;
+
+        /**
+         * @brief Get the cache of built-in window function data.
+         */
+        static TCache& get_cache() {
+            static TCache cache;
+            return cache;
+        }
+
+        /**
+         * @brief Fetch the shared data of built-in window function, and compute it if it is not computed.
+         */
+        static TWindowData get_shared_data(WindowType win_type, TFloat kaiser_beta) {
+            if (win_type == WindowType::KaiserWindow) {
+                if (!std::isfinite(kaiser_beta) || kaiser_beta < static_cast<TFloat>(0)) {
+                    throw std::invalid_argument("beta of Kaiser window must be finite and non-negative.");
+                }
+            } else {
+                kaiser_beta = static_cast<TFloat>(0);
+            }
+
+            return get_cache().get(std::make_pair(win_type, kaiser_beta), [win_type, kaiser_beta]() -> TWindowData {
+                auto data = std::make_shared<TFloat[]>(N);
+                compute_data(data.get(), win_type, kaiser_beta);
+                return data;
+            });
+        }
+
+    public:
+        /**
+         * @brief Get the count of cached built-in window function data of this TFloat and N.
+         * @details It is mainly used for testing. The data is freed when no instance uses it.
+         * @return The count of cache entries.
+         */
+        static size_t get_cache_size() { return get_cache().get_entry_count(); }
+
+    private:
+
+        /**
+         * @brief Compute the data of built-in window function.
+         */
+        static void compute_data(TFloat* data, WindowType win_type, TFloat kaiser_beta) {
+            switch (win_type) {
+                case WindowType::HanningWindow:
+                case WindowType::HammingWindow:
+                case WindowType::BlackmanWindow:
+                case WindowType::BlackmanHarrisWindow:
+                case WindowType::FlatTopWindow: {
+                    // Generalized cosine window: a0 - a1 * cos(x) + a2 * cos(2x) - a3 * cos(3x) + a4 * cos(4x)
+                    const auto coeffs = get_cosine_sum_coefficients(win_type);
+                    for (TIndex i = 0u; i < N; ++i) {
+                        const TFloat x = util::tau_v<TFloat> * static_cast<TFloat>(i) / static_cast<TFloat>(N - static_cast<TIndex>(1));
+                        TFloat sum = static_cast<TFloat>(0), sign = static_cast<TFloat>(1);
+                        for (size_t k = 0u; k < coeffs.size(); ++k) {
+                            sum += sign * coeffs[k] * std::cos(static_cast<TFloat>(k) * x);
+                            sign = -sign;
+                        }
+                        data[i] = sum;
+                    }
+                    break;
+                }
+                case WindowType::KaiserWindow: {
+                    // I0(beta * sqrt(1 - (2i / (N - 1) - 1)^2)) / I0(beta)
+                    const TFloat denominator = bessel_i0(kaiser_beta);
+                    for (TIndex i = 0u; i < N; ++i) {
+                        const TFloat r = static_cast<TFloat>(2) * static_cast<TFloat>(i) / static_cast<TFloat>(N - static_cast<TIndex>(1))
+                                         - static_cast<TFloat>(1);
+                        const TFloat arg = kaiser_beta * std::sqrt(std::max(static_cast<TFloat>(0), static_cast<TFloat>(1) - r * r));
+                        data[i] = bessel_i0(arg) / denominator;
+                    }
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("invalid window function type");
+            }
+        }
+
+        /**
+         * @brief Compute zeroth order modified Bessel function of the first kind by its power series.
+         */
+        static TFloat bessel_i0(TFloat x) {
+            // I0(x) = sum of ((x / 2)^k / k!)^2
+            const TFloat half_x = x / static_cast<TFloat>(2);
+            TFloat sum = static_cast<TFloat>(1), term = static_cast<TFloat>(1);
+            for (int k = 1; k < 64; ++k) {
+                term *= half_x / static_cast<TFloat>(k);
+                const TFloat item = term * term;
+                sum += item;
+                if (item < sum * std::numeric_limits<TFloat>::epsilon()) break;
+            }
+            return sum;
+        }
+
+    public:
+        /**
+         * @brief Get the coefficients of generalized cosine window.
+         * @details
+         * The window of such types is <TT>a0 - a1 * cos(x) + a2 * cos(2x) - a3 * cos(3x) + ...</TT>
+         * where <TT>x = 2 * pi * i / (N - 1)</TT>.
+         * Because it is the sum of a few sinusoids, it can be applied in frequency domain,
+         * which is used by SlidingDft.
+         * @param[in] win_type The type of window function.
+         * @return The coefficients from a0, or empty span if given type is not a generalized cosine window.
+         */
+        static std::span<const TFloat> get_cosine_sum_coefficients(WindowType win_type) {
+            static constexpr TFloat HANNING[] = {static_cast<TFloat>(0.5), static_cast<TFloat>(0.5)};
+            static constexpr TFloat HAMMING[] = {static_cast<TFloat>(0.54), static_cast<TFloat>(0.46)};
+            static constexpr TFloat BLACKMAN[] = {static_cast<TFloat>(0.42), static_cast<TFloat>(0.5), static_cast<TFloat>(0.08)};
+            static constexpr TFloat BLACKMAN_HARRIS[] = {static_cast<TFloat>(0.35875),
+                                                         static_cast<TFloat>(0.48829),
+                                                         static_cast<TFloat>(0.14128),
+                                                         static_cast<TFloat>(0.01168)};
+            static constexpr TFloat FLAT_TOP[] = {static_cast<TFloat>(0.21557895),
+                                                  static_cast<TFloat>(0.41663158),
+                                                  static_cast<TFloat>(0.277263158),
+                                                  static_cast<TFloat>(0.083578947),
+                                                  static_cast<TFloat>(0.006947368)};
+            switch (win_type) {
+                case WindowType::HanningWindow:
+                    return HANNING;
+                case WindowType::HammingWindow:
+                    return HAMMING;
+                case WindowType::BlackmanWindow:
+                    return BLACKMAN;
+                case WindowType::BlackmanHarrisWindow:
+                    return BLACKMAN_HARRIS;
+                case WindowType::FlatTopWindow:
+                    return FLAT_TOP;
+                default:
+                    return {};
+            }
+        }
+
+        /**
+         * @brief Get the type of this window function.
+         * @return The type of window function.
+         */
+        WindowType get_window_type() const { return window_type; }
+
+        /**
+		 * @brief Apply window function to given data sequence.
+		 * @param[in,out] data 
+		 * The float-point data sequence for applying window function.
+		 * The length of this sequence must be N.
+		*/
+        void apply_window(TFloat* data) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for applying window.");
+            }
+            util::window_multiply<false, TIndex, TFloat>(data, window_data.get(), data, N);
+        }
+        /**
+		 * @brief Apply window function while copying data sequence.
+		 * @details The copy, the optional reversal and the multiplication are fused in one vectorized pass.
+		 * @param[in] src The float-point data sequence with length N.
+		 * @param[out] dst The float-point sequence with length N receiving windowed data. It must not overlap with \p src.
+		 * @param[in] reversed True for reading \p src in reversed order, that is, the i-th output is <TT>src[N - 1 - i] * w[i]</TT>.
+		*/
+        void apply_window(const TFloat* src, TFloat* dst, bool reversed = false) const {
+            if (src == nullptr || dst == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for applying window.");
+            }
+            if (reversed) util::window_multiply<true, TIndex, TFloat>(src, window_data.get(), dst, N);
+            else util::window_multiply<false, TIndex, TFloat>(src, window_data.get(), dst, N);
+        }
+        /**
+		 * @brief Apply window function while widening data sequence into complex sequence.
+		 * @details
+		 * The copy, the optional reversal, the multiplication and the widening are fused in one vectorized pass.
+		 * It is useful for preparing the input of complex Fft.
+		 * @param[in] src The float-point data sequence with length N.
+		 * @param[out] dst The complex sequence with length N receiving windowed data with zero imaginary parts.
+		 * @param[in] reversed True for reading \p src in reversed order, that is, the i-th output is <TT>src[N - 1 - i] * w[i]</TT>.
+		*/
+        void apply_window(const TFloat* src, TComplex* dst, bool reversed = false) const {
+            if (src == nullptr || dst == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for applying window.");
+            }
+            if (reversed) util::window_multiply<true, TIndex, TFloat>(src, window_data.get(), dst, N);
+            else util::window_multiply<false, TIndex, TFloat>(src, window_data.get(), dst, N);
+        }
+        /**
+		 * @brief Get underlying window function data for custom applying.
+		 * @return 
+		 * The pointer to the start address of underlying window function data sequence.
+		 * The length of this sequence is N.
+		 * For built-in window functions, it is shared by all instances with the same type.
+		*/
+        const TFloat* get_window_data() const { return window_data.get(); }
+    };
+
+#pragma endregion
+
+#pragma region FFT Plan
+
+    /// @brief The direction of FFT.
+    enum class FftDirection {
+        Forward,  ///< Forward transform with kernel e^(-j2πkn/N).
+        Backward, ///< Backward (inverse) transform with kernel e^(j2πkn/N). The result is not normalized.
+    };
+
+    /// @brief The normalization of inverse FFT.
+    enum class FftNormalization {
+        ByN,  ///< Divide result by N, so that inverse transform is the exact inverse of forward transform.
+        None, ///< Keep N times result. It saves one pass if the scale has been folded into data.
+    };
+
+    /// @brief The algorithm used by FFT computation.
+    enum class FftAlgorithm {
+        CooleyTukey, ///< In place radix-4 Cooley-Tukey FFT with a bit-reversal pass. It needs no scratch buffer.
+        Stockham,    ///< Stockham autosort radix-4 FFT. It ping-pongs with a scratch buffer in purely sequential access, without bit-reversal pass.
+        /**
+         * @brief Not an algorithm but a planner mode.
+         * @details
+         * FftPlanner measures all algorithms above for the point and direction when they are first requested,
+         * and the faster one is used. See FftPlanner for details.
+         * It is accepted by FftPlanCache and classes built on it, but not by FftPlan constructor.
+         */
+        Measure,
+    };
+
+    /**
+     * @brief The FFT plan whose point is decided at runtime.
+     * @details
+     * The plan holds immutable tables for specific point, direction and algorithm.
+     * For Cooley-Tukey algorithm, they are twiddle factors and bit-reversed swap list,
+     * and the computation is the same radix-4 engine used by Fft.
+     * For Stockham algorithm, they are only twiddle factors.
+     *
+     * The point can also be any integer >= 2 which is not a power of 2, and then the algorithm is ignored:
+     * \li If it only has prime factors 2, 3, 5 and 7, it is computed by mixed-radix Stockham passes.
+     * \li Otherwise it is computed by Bluestein algorithm, which turns it into a convolution
+     * computed by two FFTs whose point is the smallest power of 2 not less than <TT>2 * N - 1</TT>.
+     *
+     * Because the plan is immutable after construction, it is safe to compute with one plan in different threads simultaneously.
+     * Usually you should fetch plan from FftPlanCache, instead of constructing it by yourself,
+     * so that the plans with the same key are shared in the whole process.
+     * @tparam TIndex The index type used by FFT which must be an unsigned integral type.
+     * @tparam TFloat The float point type used by FFT.
+     */
+    template<typename TIndex, typename TFloat>
+        requires util::validate_plan_args_v<TIndex, TFloat>
+    class FftPlan {
+    public:
+        using TComplex = std::complex<TFloat>;
+
+    public:
+        /**
+         * @brief Build FFT plan for given point, direction and algorithm.
+         * @param[in] n The point of FFT which must be >= 2.
+         * @param[in] direction The direction of FFT.
+         * @param[in] algorithm The algorithm of FFT. It is ignored if given point is not a power of 2.
+         * @exception std::invalid_argument Given point is less than 2.
+         */
+        FftPlan(TIndex n, FftDirection direction = FftDirection::Forward, FftAlgorithm algorithm = FftAlgorithm::CooleyTukey) :
+            n(n), direction(direction), algorithm(algorithm), engine(Engine::PowerOfTwo), twiddles(nullptr), bit_reverse_swaps(nullptr),
+            bit_reverse_swap_count(0), radices(), bluestein_size(0), bluestein_forward(nullptr), bluestein_backward(nullptr), bluestein_chirp(),
+            bluestein_kernel(), split_state(nullptr) {
+            if (n < static_cast<TIndex>(2)) {
+                throw std::invalid_argument("the point of FFT plan must be >= 2");
+            }
+            if (algorithm != FftAlgorithm::CooleyTukey && algorithm != FftAlgorithm::Stockham) {
+                throw std::invalid_argument("invalid FFT algorithm");
+            }
+
+            const bool backward = direction == FftDirection::Backward;
+            if (!std::has_single_bit<TIndex>(n)) {
+                radices = util::mixed_radix_factors<TIndex>(n);
+                if (!radices.empty()) {
+                    engine = Engine::MixedRadix;
+                    twiddles = std::make_unique<TComplex[]>(util::mixed_radix_twiddle_count<TIndex>(n, radices));
+                    util::fill_mixed_radix_twiddles<TIndex, TFloat>(twiddles.get(), n, radices, backward);
+                } else {
+                    engine = Engine::Bluestein;
+                    build_bluestein(backward);
+                }
+                return;
+            }
+
+            split_state = std::make_unique<SplitState>();
+            switch (algorithm) {
+                case FftAlgorithm::CooleyTukey:
+                    twiddles = std::make_unique<TComplex[]>(util::radix4_twiddle_count<TIndex>(n));
+                    util::fill_radix4_twiddles<TIndex, TFloat>(twiddles.get(), n, backward);
+                    bit_reverse_swap_count = util::bit_reverse_swap_count<TIndex>(n);
+                    bit_reverse_swaps = std::make_unique<TIndex[]>(bit_reverse_swap_count * static_cast<TIndex>(2));
+                    util::fill_bit_reverse_swaps<TIndex>(bit_reverse_swaps.get(), n);
+                    break;
+                case FftAlgorithm::Stockham:
+                    twiddles = std::make_unique<TComplex[]>(util::stockham_twiddle_count<TIndex>(n));
+                    util::fill_stockham_twiddles<TIndex, TFloat>(twiddles.get(), n, backward);
+                    break;
+                default:
+                    throw std::invalid_argument("invalid FFT algorithm");
+            }
+        }
+
+    private:
+        TIndex n;
+        FftDirection direction;
+        FftAlgorithm algorithm;
+
+        /// @brief The way computing this plan, which is decided by point.
+        enum class Engine {
+            PowerOfTwo, ///< Radix-4 Cooley-Tukey or Stockham engine decided by algorithm.
+            MixedRadix, ///< Mixed-radix Stockham passes.
+            Bluestein,  ///< Bluestein algorithm.
+        };
+        Engine engine;
+
+        std::unique_ptr<TComplex[]> twiddles;
+        /// @brief The cache blocked bit-reversed swap list, stored as (I, J) pairs.
+        std::unique_ptr<TIndex[]> bit_reverse_swaps;
+        TIndex bit_reverse_swap_count;
+        /// @brief The radices of mixed-radix Stockham passes in pass order.
+        std::vector<TIndex> radices;
+
+        /// @brief The point of the FFTs computing convolution in Bluestein algorithm.
+        TIndex bluestein_size;
+        /**
+         * @brief The plans of the FFTs computing convolution in Bluestein algorithm.
+         * @details They are owned by this plan instead of fetched from FftPlanCache, because this plan may be built while cache is locked.
+         */
+        std::unique_ptr<FftPlan> bluestein_forward, bluestein_backward;
+        /// @brief The chirp <TT>exp(-/+ j * pi * k^2 / N)</TT> with length N.
+        std::vector<TComplex> bluestein_chirp;
+        /// @brief The spectrum of convolution kernel with the normalization of inverse FFT folded in.
+        std::vector<TComplex> bluestein_kernel;
+
+        /**
+         * @brief The lazily built twiddle factors of split-complex Stockham passes.
+         * @details
+         * They are built when split-complex computing is first requested, so that other plans do not pay for them.
+         * The state lives in heap because std::once_flag can not be moved, and it keeps the plan movable.
+         */
+        struct SplitState {
+            std::once_flag once;
+            /// @brief All real parts followed by all imaginary parts.
+            std::unique_ptr<TFloat[]> twiddles;
+        };
+        /// @brief The split-complex state which only exists for power-of-2 points.
+        std::unique_ptr<SplitState> split_state;
+
+        /**
+         * @brief Get the twiddle factors of split-complex Stockham passes, and build them if they do not exist.
+         * @return The real parts, which are followed by imaginary parts.
+         */
+        const TFloat* get_split_twiddles() const {
+            SplitState& state = *split_state;
+            std::call_once(state.once, [this, &state]() {
+                const TIndex count = util::split_stockham_twiddle_count<TIndex, TFloat>(n);
+                state.twiddles = std::make_unique<TFloat[]>(count * static_cast<TIndex>(2));
+                util::fill_split_stockham_twiddles<TIndex, TFloat>(state.twiddles.get(), state.twiddles.get() + count, n,
+                                                                   direction == FftDirection::Backward);
+            });
+            return state.twiddles.get();
+        }
+
+        /**
+         * @brief Build the tables of Bluestein algorithm.
+         * @details
+         * <TT>X[m] = c(m) * sum(x[k] * c(k) * conj(c(m - k)))</TT> where <TT>c(k) = exp(-/+ j * pi * k^2 / N)</TT>,
+         * that is, a circular convolution with kernel <TT>conj(c(k))</TT> for k in (-N, N).
+         */
+        void build_bluestein(bool backward) {
+            bluestein_size = std::bit_ceil<TIndex>(n * static_cast<TIndex>(2) - static_cast<TIndex>(1));
+            bluestein_forward = std::make_unique<FftPlan>(bluestein_size, FftDirection::Forward);
+            bluestein_backward = std::make_unique<FftPlan>(bluestein_size, FftDirection::Backward);
+
+            // k^2 is reduced by 2N in integer arithmetic, and the angle is computed in double,
+            // because the phase grows with the square of index.
+            const std::uint64_t period = static_cast<std::uint64_t>(n) * 2u;
+            bluestein_chirp.resize(n);
+            for (TIndex k = 0; k < n; ++k) {
+                const std::uint64_t square = (static_cast<std::uint64_t>(k) * static_cast<std::uint64_t>(k)) % period;
+                const double angle = std::numbers::pi * static_cast<double>(square) / static_cast<double>(n);
+                const double sine = std::sin(angle);
+                bluestein_chirp[k] = TComplex(static_cast<TFloat>(std::cos(angle)), static_cast<TFloat>(backward ? sine : -sine));
+            }
+
+            const TFloat scale = static_cast<TFloat>(1) / static_cast<TFloat>(bluestein_size);
+            bluestein_kernel.assign(bluestein_size, TComplex(0));
+            for (TIndex k = 0; k < n; ++k) {
+                const TComplex value = std::conj(bluestein_chirp[k]);
+                bluestein_kernel[k] = TComplex(value.real() * scale, value.imag() * scale);
+                if (k != static_cast<TIndex>(0)) bluestein_kernel[bluestein_size - k] = bluestein_kernel[k];
+            }
+            bluestein_forward->compute(bluestein_kernel.data());
+        }
+
+        /**
+         * @brief Compute FFT by Bluestein algorithm.
+         * @param[in] src The source sequence with length N.
+         * @param[out] dst The destination sequence with length N. It can be the same one with \p src.
+         * @param[in] work The work buffer with length of Bluestein convolution.
+         */
+        void compute_bluestein(const TComplex* src, TComplex* dst, TComplex* work) const {
+            util::spectrum_multiply<TIndex, TFloat>(work, src, bluestein_chirp.data(), n);
+            std::fill(work + n, work + bluestein_size, TComplex(0));
+            bluestein_forward->compute(work);
+            util::spectrum_multiply<TIndex, TFloat>(work, work, bluestein_kernel.data(), bluestein_size);
+            bluestein_backward->compute(work);
+            util::spectrum_multiply<TIndex, TFloat>(dst, work, bluestein_chirp.data(), n);
+        }
+
+    public:
+        /**
+         * @brief Get the point of this plan.
+         * @return The point of FFT.
+         */
+        TIndex get_size() const { return n; }
+        /**
+         * @brief Get the direction of this plan.
+         * @return The direction of FFT.
+         */
+        FftDirection get_direction() const { return direction; }
+        /**
+         * @brief Get the algorithm of this plan.
+         * @return The algorithm of FFT.
+         */
+        FftAlgorithm get_algorithm() const { return algorithm; }
+        /**
+         * @brief Get the length of scratch buffer required by this plan.
+         * @return
+         * The count of complex numbers.
+         * If the point is a power of 2, it is N for Stockham algorithm, and zero for Cooley-Tukey algorithm.
+         * Otherwise, it is N for mixed-radix passes,
+         * and the smallest power of 2 not less than <TT>2 * N - 1</TT> for Bluestein algorithm.
+         */
+        TIndex get_scratch_size() const {
+            switch (engine) {
+                case Engine::MixedRadix:
+                    return n;
+                case Engine::Bluestein:
+                    return bluestein_size;
+                default:
+                    return algorithm == FftAlgorithm::Stockham ? n : static_cast<TIndex>(0);
+            }
+        }
+
+        /**
+         * @brief Compute FFT for given complex sequence in place.
+         * @details If this plan requires scratch buffer, the scratch buffer owned by current thread is used.
+         * @param[in,out] data
+         * The complex sequence for computing.
+         * The length of this sequence must be the point of this plan.
+         */
+        void compute(TComplex* data) const { compute(data, data); }
+
+        /**
+         * @brief Compute FFT from source sequence into destination sequence.
+         * @details
+         * For Stockham algorithm and mixed-radix passes, the passes are directly executed between source, destination and scratch buffer,
+         * and source is never written.
+         * For Cooley-Tukey algorithm, source is copied into destination and computed in place.
+         * For Bluestein algorithm, the scratch buffer is the work buffer of convolution.
+         * @param[in] src
+         * The complex sequence for computing.
+         * The length of this sequence must be the point of this plan.
+         * @param[out] dst
+         * The computed complex sequence with the same length.
+         * It can be the same one with \p src, otherwise they must not overlap.
+         * @param[in] scratch
+         * The scratch buffer whose length is get_scratch_size().
+         * It must not overlap with \p src or \p dst.
+         * If it is nullptr, the scratch buffer owned by current thread is used.
+         */
+        void compute(const TComplex* src, TComplex* dst, TComplex* scratch = nullptr) const {
+            if (src == nullptr || dst == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            if (engine == Engine::MixedRadix) {
+                if (scratch == nullptr) scratch = util::thread_scratch<TFloat>(n);
+                if (direction == FftDirection::Forward) {
+                    util::mixed_radix_passes<TIndex, TFloat, false>(src, dst, scratch, n, radices, twiddles.get());
+                } else {
+                    util::mixed_radix_passes<TIndex, TFloat, true>(src, dst, scratch, n, radices, twiddles.get());
+                }
+                return;
+            }
+            if (engine == Engine::Bluestein) {
+                if (scratch == nullptr) scratch = util::thread_scratch<TFloat>(bluestein_size);
+                compute_bluestein(src, dst, scratch);
+                return;
+            }
+
+            if (algorithm == FftAlgorithm::Stockham) {
+                if (scratch == nullptr) scratch = util::thread_scratch<TFloat>(n);
+                if (direction == FftDirection::Forward) {
+                    util::stockham_passes<TIndex, TFloat, false>(src, dst, scratch, n, twiddles.get());
+                } else {
+                    util::stockham_passes<TIndex, TFloat, true>(src, dst, scratch, n, twiddles.get());
+                }
+                return;
+            }
+
+            if (src != dst) std::copy_n(src, n, dst);
+            // Construct butterfly structure
+            util::bit_reverse_permute<TIndex, TComplex>(dst, bit_reverse_swaps.get(), bit_reverse_swap_count);
+            // Calculate butterfly
+            if (direction == FftDirection::Forward) {
+                util::radix4_butterflies<TIndex, TFloat, false>(dst, n, twiddles.get());
+            } else {
+                util::radix4_butterflies<TIndex, TFloat, true>(dst, n, twiddles.get());
+            }
+        }
+
+        /**
+         * @brief Compute FFT for given split-complex sequence in place.
+         * @details
+         * The real parts and imaginary parts are stored in two separate arrays.
+         * If the point is a power of 2, it is computed by split-complex Stockham passes directly on these arrays,
+         * with the scratch buffer owned by current thread, no matter which algorithm this plan is.
+         * Otherwise, the sequence is interleaved into the scratch buffer owned by current thread, computed, and split back.
+         * @param[in,out] re The real parts with length of the point of this plan.
+         * @param[in,out] im The imaginary parts with the same length. It must not overlap with \p re.
+         */
+        void compute(TFloat* re, TFloat* im) const {
+            if (re == nullptr || im == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            if (engine != Engine::PowerOfTwo) {
+                TComplex* buffer = util::thread_scratch<TFloat>(n + get_scratch_size());
+                for (TIndex i = 0; i < n; ++i) {
+                    buffer[i] = TComplex(re[i], im[i]);
+                }
+                compute(buffer, buffer, buffer + n);
+                for (TIndex i = 0; i < n; ++i) {
+                    re[i] = buffer[i].real();
+                    im[i] = buffer[i].imag();
+                }
+                return;
+            }
+
+            // The scratch buffer of N complex numbers is reinterpreted as two float-point arrays with length N.
+            const TFloat* wr = get_split_twiddles();
+            const TFloat* wi = wr + util::split_stockham_twiddle_count<TIndex, TFloat>(n);
+            TFloat* scratch = reinterpret_cast<TFloat*>(util::thread_scratch<TFloat>(n));
+            if (direction == FftDirection::Forward) {
+                util::split_stockham_passes<TIndex, TFloat, false>(re, im, scratch, scratch + n, n, wr, wi);
+            } else {
+                util::split_stockham_passes<TIndex, TFloat, true>(re, im, scratch, scratch + n, n, wr, wi);
+            }
+        }
+
+        /**
+         * @brief Compute FFT for multiple channels at once in place.
+         * @details
+         * Channels are interleaved (structure-of-arrays layout),
+         * that is, the k-th item of c-th channel is located at <TT>data[k * stride + c]</TT>.
+         * Each butterfly is executed on all channels by SIMD, so that one SIMD lane processes one channel,
+         * and twiddle factors are loaded only once for all channels.
+         *
+         * Only Cooley-Tukey algorithm with the point of a power of 2 supports batched computing.
+         * @param[in,out] data
+         * The batched complex sequence for computing.
+         * Its length must be at least <TT>(N - 1) * stride + channels</TT>.
+         * @param[in] channels The count of channels.
+         * @param[in] stride The distance between the k-th and (k+1)-th item of the same channel. It must be >= channels.
+         * @exception std::invalid_argument Invalid arguments, or this plan is not Cooley-Tukey algorithm with the point of a power of 2.
+         */
+        void compute_batch(TComplex* data, TIndex channels, TIndex stride) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+            if (stride < channels) [[unlikely]] {
+                throw std::invalid_argument("the stride of batched FFT must not be less than channel count.");
+            }
+            if (algorithm != FftAlgorithm::CooleyTukey || engine != Engine::PowerOfTwo) [[unlikely]] {
+                throw std::invalid_argument("batched FFT only supports Cooley-Tukey algorithm with the point of a power of 2.");
+            }
+
+            // Construct butterfly structure
+            util::bit_reverse_permute_batch<TIndex, TFloat>(data, bit_reverse_swaps.get(), bit_reverse_swap_count, channels, stride);
+            // Calculate butterfly
+            if (direction == FftDirection::Forward) {
+                util::radix4_butterflies_batch<TIndex, TFloat, false>(data, n, twiddles.get(), channels, stride);
+            } else {
+                util::radix4_butterflies_batch<TIndex, TFloat, true>(data, n, twiddles.get(), channels, stride);
+            }
+        }
+    };
+
+    template<typename TIndex, typename TFloat>
+        requires util::validate_plan_args_v<TIndex, TFloat>
+    class FftPlanner;
+
+    /**
+     * @brief The process-wide cache of FFT plans.
+     * @details
+     * Plans are keyed by their point, direction and algorithm.
+     * Each template instance of this class (different index and float point type) has its own storage.
+     * All requests for the same key share the same immutable plan.
+     *
+     * All functions of this class are thread safe.
+     * @tparam TIndex The index type used by FFT which must be an unsigned integral type.
+     * @tparam TFloat The float point type used by FFT.
+     */
+    template<typename TIndex, typename TFloat>
+        requires util::validate_plan_args_v<TIndex, TFloat>
+    class FftPlanCache {
+    public:
+        using TPlan = FftPlan<TIndex, TFloat>;
+        using TPlanPtr = std::shared_ptr<const TPlan>;
+
+    public:
+        FftPlanCache() = delete;
+
+    private:
+        using TKey = std::tuple<TIndex, FftDirection, FftAlgorithm>;
+        static inline std::mutex cache_mutex;
+        static inline std::map<TKey, TPlanPtr> cache;
+
+    public:
+        /**
+         * @brief Fetch the plan of given point, direction and algorithm.
+         * @details The plan will be built and stored if it is not in cache.
+         * @param[in] n The point of FFT which must be >= 2.
+         * @param[in] direction The direction of FFT.
+         * @param[in] algorithm
+         * The algorithm of FFT. It is ignored if given point is not a power of 2.
+         * If it is FftAlgorithm::Measure, it is replaced by the algorithm chosen by FftPlanner,
+         * so that the plan is shared with the requests of chosen algorithm.
+         * @return The shared pointer to immutable plan.
+         * @exception std::invalid_argument Given point is less than 2.
+         */
+        static TPlanPtr get(TIndex n, FftDirection direction = FftDirection::Forward, FftAlgorithm algorithm = FftAlgorithm::CooleyTukey) {
+            // Resolve planner mode before locking, because planner fetches its candidate plans from this cache.
+            if (algorithm == FftAlgorithm::Measure) algorithm = FftPlanner<TIndex, TFloat>::choose(n, direction);
+
+            std::lock_guard<std::mutex> locker(cache_mutex);
+            auto key = std::make_tuple(n, direction, algorithm);
+            auto finder = cache.find(key);
+            if (finder != cache.end()) return finder->second;
+
+            auto plan = std::make_shared<const TPlan>(n, direction, algorithm);
+            cache.emplace(key, plan);
+            return plan;
+        }
+
+        /**
+         * @brief Remove all plans from cache.
+         * @details
+         * The plans held by others are still alive until they are released.
+         * Note that Fft holds the plans of its point forever once they are used.
+         * It is useful for releasing the memory occupied by plans which will not be used anymore.
+         */
+        static void clear() {
+            std::lock_guard<std::mutex> locker(cache_mutex);
+            cache.clear();
+        }
+    };
+
+    /**
+     * @brief The process-wide planner choosing the fastest FFT algorithm for this machine.
+     * @details
+     * Which algorithm is faster depends on the point, the cache and the instruction set of the machine.
+     * When the algorithm of a point and direction is first requested by choose() (or FftAlgorithm::Measure),
+     * this class computes FFT with every algorithm on the plans from FftPlanCache for a while,
+     * and remembers the faster one in memory as "wisdom".
+     * The point which is not a power of 2 ignores algorithm, so it is never measured.
+     *
+     * The wisdom can be saved into a file by binstore and loaded in later processes,
+     * so that they use the fastest algorithm without measuring again.
+     * The version of wisdom file contains the size of TFloat and the SIMD instruction set of this build,
+     * so that the file written by other float point type or other build is rejected.
+     * Each template instance of this class (different index and float point type) has its own wisdom,
+     * so use different files for different float point types.
+     *
+     * All functions of this class are thread safe.
+     * @tparam TIndex The index type used by FFT which must be an unsigned integral type.
+     * @tparam TFloat The float point type used by FFT.
+     */
+    template<typename TIndex, typename TFloat>
+        requires util::validate_plan_args_v<TIndex, TFloat>
+    class FftPlanner {
+    public:
+        using TPlanCache = FftPlanCache<TIndex, TFloat>;
+        using TComplex = std::complex<TFloat>;
+
+    public:
+        FftPlanner() = delete;
+
+    private:
+        using TKey = std::pair<TIndex, FftDirection>;
+        using TWisdom = std::map<TKey, FftAlgorithm>;
+        static inline std::mutex wisdom_mutex;
+        static inline TWisdom wisdom;
+        /// @brief The keys being measured without lock, so that other requests for them wait instead of measuring again.
+        static inline std::set<TKey> pending;
+        /// @brief Notified when a measurement finishes, whether it succeeds or not.
+        static inline std::condition_variable pending_cond;
+
+        /// @brief The algorithms competing in measurement. The former one wins ties, because it needs no scratch buffer.
+        static constexpr std::array<FftAlgorithm, 2> CANDIDATES{FftAlgorithm::CooleyTukey, FftAlgorithm::Stockham};
+        /// @brief The count of points computed in each trial, so that small point is repeated enough for the timer.
+        static constexpr TIndex TRIAL_POINTS = static_cast<TIndex>(65536);
+        /// @brief The count of trials for each algorithm. The fastest trial is taken to reject interference.
+        static constexpr size_t TRIAL_COUNT = 5u;
+
+        /// @brief The identifier of SIMD instruction set used by FFT butterflies.
+        static constexpr std::uint64_t SIMD_ISA =
+#if defined(YYCC_FFT_SIMD_AVX2)
+            2u;
+#elif defined(YYCC_FFT_SIMD_SSE2)
+            1u;
+#else
+            0u;
+#endif
+        /// @brief The version of wisdom file, which consists of file format, SIMD instruction set and the size of TFloat.
+        static constexpr binstore::types::VersionIdentifier WISDOM_VERSION = (UINT64_C(1) << 32) | (SIMD_ISA << 16)
+                                                                             | static_cast<std::uint64_t>(sizeof(TFloat));
+
+        /**
+         * @brief The binstore SerDes of wisdom.
+         * @details
+         * The wisdom is stored as the count of entries followed by entries,
+         * and each entry is the point, direction and algorithm in order. All of them are 64-bit unsigned integers.
+         * Any invalid entry fails the whole deserialization.
+         */
+        struct WisdomSerDes {
+            using ValueType = TWisdom;
+            using FieldType = std::uint64_t;
+            static constexpr size_t FIELD_SIZE = sizeof(FieldType);
+            static constexpr size_t ENTRY_SIZE = FIELD_SIZE * 3u;
+
+            std::optional<binstore::types::ByteArray> serialize(const ValueType& value) const {
+                binstore::types::ByteArray ba;
+                ba.resize_data(FIELD_SIZE + ENTRY_SIZE * value.size());
+
+                FieldType count = value.size();
+                std::memcpy(ba.get_data_ptr(), &count, FIELD_SIZE);
+                size_t offset = FIELD_SIZE;
+                for (const auto& [key, algorithm] : value) {
+                    const FieldType fields[3]{static_cast<FieldType>(key.first),
+                                              static_cast<FieldType>(key.second),
+                                              static_cast<FieldType>(algorithm)};
+                    std::memcpy(ba.get_data_ptr(offset), fields, ENTRY_SIZE);
+                    offset += ENTRY_SIZE;
+                }
+                return ba;
+            }
+
+            std::optional<ValueType> deserialize(const binstore::types::ByteArray& ba) const {
+                const size_t ba_size = ba.get_data_size();
+                if (ba_size < FIELD_SIZE) return std::nullopt;
+                FieldType count;
+                std::memcpy(&count, ba.get_data_ptr(), FIELD_SIZE);
+                if (count != (ba_size - FIELD_SIZE) / ENTRY_SIZE || (ba_size - FIELD_SIZE) % ENTRY_SIZE != 0u) return std::nullopt;
+
+                ValueType value;
+                size_t offset = FIELD_SIZE;
+                for (FieldType i = 0; i < count; ++i) {
+                    FieldType fields[3];
+                    std::memcpy(fields, ba.get_data_ptr(offset), ENTRY_SIZE);
+                    offset += ENTRY_SIZE;
+
+                    // Only power of 2 points are measured, and direction and algorithm must be valid enumeration values.
+                    if (fields[0] < 2u || !std::has_single_bit(fields[0]) || fields[0] > std::numeric_limits<TIndex>::max()) return std::nullopt;
+                    if (fields[1] > static_cast<FieldType>(FftDirection::Backward)) return std::nullopt;
+                    if (fields[2] > static_cast<FieldType>(FftAlgorithm::Stockham)) return std::nullopt;
+                    value.insert_or_assign(std::make_pair(static_cast<TIndex>(fields[0]), static_cast<FftDirection>(fields[1])),
+                                           static_cast<FftAlgorithm>(fields[2]));
+                }
+                return value;
+            }
+
+            binstore::types::ByteArray reset() const { return this->serialize(ValueType()).value(); }
+        };
+
+        /**
+         * @brief Build the binstore storage of wisdom file.
+         * @return The storage and the token of wisdom setting in it.
+         */
+        static std::pair<binstore::storage::Storage, binstore::types::Token> build_storage() {
+            binstore::setting::SettingCollection settings;
+            auto token = settings.add_setting(binstore::setting::Setting(u8"fft-wisdom"));
+            binstore::storage::Storage storage(binstore::configuration::Configuration(WISDOM_VERSION, std::move(settings)));
+            return std::make_pair(std::move(storage), token);
+        }
+
+        /**
+         * @brief Measure all candidate algorithms and return the fastest one.
+         * @details
+         * Each trial restores the same source data before every computation, so that values never overflow,
+         * and the cost of restoring is the same for all algorithms.
+         * Trials of different algorithms are interleaved, so that the drift of clock frequency affects all of them.
+         */
+        static FftAlgorithm measure(TIndex n, FftDirection direction) {
+            std::array<typename TPlanCache::TPlanPtr, CANDIDATES.size()> plans;
+            for (size_t i = 0; i < CANDIDATES.size(); ++i) {
+                plans[i] = TPlanCache::get(n, direction, CANDIDATES[i]);
+            }
+
+            std::vector<TComplex> source(n), data(n);
+            for (TIndex i = 0; i < n; ++i) {
+                source[i] = TComplex(static_cast<TFloat>(i % 7u) - static_cast<TFloat>(3), static_cast<TFloat>(i % 5u) - static_cast<TFloat>(2));
+            }
+
+            const TIndex repeat = std::max<TIndex>(TRIAL_POINTS / n, static_cast<TIndex>(1));
+            std::array<std::chrono::steady_clock::duration, CANDIDATES.size()> best;
+            best.fill(std::chrono::steady_clock::duration::max());
+            for (size_t trial = 0; trial < TRIAL_COUNT; ++trial) {
+                for (size_t i = 0; i < CANDIDATES.size(); ++i) {
+                    const auto start = std::chrono::steady_clock::now();
+                    for (TIndex r = 0; r < repeat; ++r) {
+                        std::copy_n(source.data(), n, data.data());
+                        plans[i]->compute(data.data());
+                    }
+                    best[i] = std::min(best[i], std::chrono::steady_clock::now() - start);
+                }
+            }
+
+            return CANDIDATES[static_cast<size_t>(std::distance(best.begin(), std::min_element(best.begin(), best.end())))];
+        }
+
+    public:
+        /**
+         * @brief Choose the fastest algorithm for given point and direction.
+         * @details
+         * If there is no wisdom for them, all algorithms are measured and the result is remembered.
+         * Measurement takes some milliseconds and is done without lock,
+         * so only the threads requesting the same point and direction wait for it.
+         * If wisdom for them is loaded during measurement, the loaded one is kept and returned.
+         * @param[in] n The point of FFT which must be >= 2.
+         * @param[in] direction The direction of FFT.
+         * @return The chosen algorithm. It is always FftAlgorithm::CooleyTukey if given point is not a power of 2.
+         * @exception std::invalid_argument Given point is less than 2.
+         */
+        static FftAlgorithm choose(TIndex n, FftDirection direction = FftDirection::Forward) {
+            if (n < static_cast<TIndex>(2)) [[unlikely]] {
+                throw std::invalid_argument("the point of FFT plan must be >= 2");
+            }
+            if (!std::has_single_bit<TIndex>(n)) return FftAlgorithm::CooleyTukey;
+
+            std::unique_lock<std::mutex> locker(wisdom_mutex);
+            auto key = std::make_pair(n, direction);
+            while (true) {
+                auto finder = wisdom.find(key);
+                if (finder != wisdom.end()) return finder->second;
+                if (!pending.contains(key)) break;
+                pending_cond.wait(locker);
+            }
+
+            // Measure without lock, because it fetches plans from cache and takes long time.
+            pending.insert(key);
+            locker.unlock();
+            FftAlgorithm algorithm;
+            try {
+                algorithm = measure(n, direction);
+            } catch (...) {
+                // Let one of waiting threads measure again.
+                locker.lock();
+                pending.erase(key);
+                pending_cond.notify_all();
+                throw;
+            }
+
+            locker.lock();
+            pending.erase(key);
+            pending_cond.notify_all();
+            return wisdom.try_emplace(key, algorithm).first->second;
+        }
+
+        /**
+         * @brief Find the wisdom of given point and direction without measuring.
+         * @param[in] n The point of FFT.
+         * @param[in] direction The direction of FFT.
+         * @return The remembered algorithm, or \c std::nullopt if there is no wisdom for them.
+         */
+        static std::optional<FftAlgorithm> find(TIndex n, FftDirection direction = FftDirection::Forward) {
+            std::lock_guard<std::mutex> locker(wisdom_mutex);
+            auto finder = wisdom.find(std::make_pair(n, direction));
+            if (finder == wisdom.end()) return std::nullopt;
+            return finder->second;
+        }
+
+        /**
+         * @brief Forget all wisdom.
+         * @details The plans which have been fetched with FftAlgorithm::Measure are not affected.
+         */
+        static void clear() {
+            std::lock_guard<std::mutex> locker(wisdom_mutex);
+            wisdom.clear();
+        }
+
+        /**
+         * @brief Load wisdom from given stream.
+         * @details The loaded wisdom is merged into memory, and it overrides the existing wisdom with the same point and direction.
+         * @param[in] s The input stream to load from.
+         * @return
+         * Nothing if success, otherwise the error of binstore.
+         * BinstoreError::BadVersion means that the wisdom is written by other float point type or other build.
+         * Invalid wisdom data is ignored and nothing is loaded.
+         */
+        static binstore::types::BinstoreResult<void> load_wisdom(std::istream& s) {
+            auto [storage, token] = build_storage();
+            auto rv = storage.load(s, binstore::storage::LoadStrategy::OnlyCurrent);
+            if (!rv.has_value()) return rv;
+            merge_wisdom(storage.get_value<WisdomSerDes>(token));
+            return {};
+        }
+
+        /**
+         * @brief Load wisdom from given file.
+         * @details See load_wisdom(std::istream&) for details.
+         * @param[in] fpath Path to the file to load from.
+         * @return Nothing if success, otherwise the error of binstore.
+         */
+        static binstore::types::BinstoreResult<void> load_wisdom(const std::filesystem::path& fpath) {
+            auto [storage, token] = build_storage();
+            auto rv = storage.load_from_file(fpath, binstore::storage::LoadStrategy::OnlyCurrent);
+            if (!rv.has_value()) return rv;
+            merge_wisdom(storage.get_value<WisdomSerDes>(token));
+            return {};
+        }
+
+        /**
+         * @brief Save all wisdom into given stream.
+         * @param[in] s The output stream to save to.
+         * @return Nothing if success, otherwise the error of binstore.
+         */
+        static binstore::types::BinstoreResult<void> save_wisdom(std::ostream& s) {
+            auto [storage, token] = build_storage();
+            storage.set_value<WisdomSerDes>(token, copy_wisdom());
+            return storage.save(s);
+        }
+
+        /**
+         * @brief Save all wisdom into given file.
+         * @param[in] fpath Path to the file to save to.
+         * @return Nothing if success, otherwise the error of binstore.
+         */
+        static binstore::types::BinstoreResult<void> save_wisdom(const std::filesystem::path& fpath) {
+            auto [storage, token] = build_storage();
+            storage.set_value<WisdomSerDes>(token, copy_wisdom());
+            return storage.save_into_file(fpath);
+        }
+
+    private:
+        static void merge_wisdom(const TWisdom& loaded) {
+            std::lock_guard<std::mutex> locker(wisdom_mutex);
+            for (const auto& [key, algorithm] : loaded) {
+                wisdom.insert_or_assign(key, algorithm);
+            }
+        }
+
+        static TWisdom copy_wisdom() {
+            std::lock_guard<std::mutex> locker(wisdom_mutex);
+            return wisdom;
+        }
+    };
+
+#pragma endregion
+
+#pragma region Thread Pool
+
+    /**
+     * @brief The fixed-size thread pool used by multi-threaded FFT engines.
+     * @details
+     * The pool executes one group of indexed tasks at once, and the calling thread also takes part in executing them.
+     * Workers sleep when there is no task, and they are joined when the pool is destroyed.
+     *
+     * All functions of this class are thread safe.
+     * If parallel_for() is called in different threads simultaneously, they are executed one by one.
+     */
+    class FftThreadPool {
+    public:
+        /**
+         * @brief Create thread pool.
+         * @param[in] thread_count
+         * The count of threads executing tasks, including the thread calling parallel_for().
+         * So there are <TT>thread_count - 1</TT> worker threads created.
+         * Zero is treated as 1, that is, all tasks are executed in calling thread.
+         */
+        explicit FftThreadPool(size_t thread_count = std::thread::hardware_concurrency()) :
+            workers(), job_mutex(), state_mutex(), job_cond(), done_cond(), generation(0), stopping(false), task(nullptr),
+            task_count(0), next_task(0), busy_workers(0), error(nullptr) {
+            if (thread_count > 1u) {
+                workers.reserve(thread_count - 1u);
+                try {
+                    for (size_t i = 1u; i < thread_count; ++i) {
+                        workers.emplace_back([this]() { worker_main(); });
+                    }
+                } catch (...) {
+                    // Destroying joinable threads terminates program, so created workers must be joined first.
+                    stop_workers();
+                    throw;
+                }
+            }
+        }
+        ~FftThreadPool() { stop_workers(); }
+        YYCC_DELETE_COPY_MOVE(FftThreadPool)
+
+    private:
+        std::vector<std::thread> workers;
+        /// @brief The mutex serializing parallel_for() callers.
+        std::mutex job_mutex;
+        /// @brief The mutex protecting the state shared with workers.
+        std::mutex state_mutex;
+        std::condition_variable job_cond;
+        std::condition_variable done_cond;
+        /// @brief The sequence number of current group of tasks. Workers wake up when it is changed.
+        size_t generation;
+        bool stopping;
+        const std::function<void(size_t)>* task;
+        size_t task_count;
+        std::atomic<size_t> next_task;
+        /// @brief The count of workers which have not finished current group of tasks.
+        size_t busy_workers;
+        /// @brief The first exception thrown by tasks.
+        std::exception_ptr error;
+
+    public:
+        /**
+         * @brief Get the count of threads executing tasks, including the thread calling parallel_for().
+         * @return The count of threads.
+         */
+        size_t get_thread_count() const { return workers.size() + 1u; }
+
+        /**
+         * @brief Execute <TT>task(i)</TT> for every i in [0, count) and wait for all of them.
+         * @details
+         * Tasks are claimed by threads one by one in index order, so that they are balanced automatically.
+         * If any task throws exception, the rest of tasks are still executed, and the first exception is rethrown here.
+         *
+         * If it is called by a task of this pool (nested call), all tasks are executed in calling thread one by one,
+         * because the other threads are occupied by outer tasks.
+         * @param[in] count The count of tasks.
+         * @param[in] task The task function receiving task index.
+         */
+        void parallel_for(size_t count, const std::function<void(size_t)>& task) {
+            if (count == 0u) return;
+            if (workers.empty() || count == 1u || get_running_pool() == this) {
+                std::exception_ptr rv_error;
+                for (size_t i = 0u; i < count; ++i) {
+                    try {
+                        task(i);
+                    } catch (...) {
+                        if (!rv_error) rv_error = std::current_exception();
+                    }
+                }
+                if (rv_error) std::rethrow_exception(rv_error);
+                return;
+            }
+
+            std::lock_guard<std::mutex> job_locker(job_mutex);
+            {
+                std::lock_guard<std::mutex> locker(state_mutex);
+                this->task = &task;
+                task_count = count;
+                next_task.store(0u, std::memory_order_relaxed);
+                busy_workers = workers.size();
+                error = nullptr;
+                ++generation;
+            }
+            job_cond.notify_all();
+
+            // Calling thread also executes tasks.
+            run_tasks();
+
+            std::exception_ptr rv_error;
+            {
+                std::unique_lock<std::mutex> locker(state_mutex);
+                done_cond.wait(locker, [this]() { return busy_workers == 0u; });
+                this->task = nullptr;
+                rv_error = error;
+                error = nullptr;
+            }
+            if (rv_error) std::rethrow_exception(rv_error);
+        }
+
+    private:
+        /**
+         * @brief Get the pool whose tasks are being executed by current thread.
+         * @return The reference to the pointer of pool, which is nullptr if current thread is not executing tasks.
+         */
+        static const FftThreadPool*& get_running_pool() {
+            thread_local const FftThreadPool* pool = nullptr;
+            return pool;
+        }
+
+        void stop_workers() {
+            {
+                std::lock_guard<std::mutex> locker(state_mutex);
+                stopping = true;
+            }
+            job_cond.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        void worker_main() {
+            size_t seen_generation = 0u;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> locker(state_mutex);
+                    job_cond.wait(locker, [this, seen_generation]() { return stopping || generation != seen_generation; });
+                    if (stopping) return;
+                    seen_generation = generation;
+                }
+
+                run_tasks();
+
+                std::lock_guard<std::mutex> locker(state_mutex);
+                if (--busy_workers == 0u) done_cond.notify_one();
+            }
+        }
+
+        void run_tasks() {
+            // Tasks never leak exception, so the running pool can be restored without guard.
+            const FftThreadPool* outer_pool = std::exchange(get_running_pool(), this);
+            while (true) {
+                size_t index = next_task.fetch_add(1u, std::memory_order_relaxed);
+                if (index >= task_count) break;
+                try {
+                    (*task)(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> locker(state_mutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+            get_running_pool() = outer_pool;
+        }
+    };
+
+#pragma endregion
+
+#pragma region FFT
+
+    /**
+     * @brief The properties shared by all FFT classes whose point is decided at compile time.
+     * @details
+     * Besides float-point types, TValue can be compact number types used by FixedFft and HalfFft,
+     * whose complex number type is CompactComplex.
+     */
+    template<typename TIndex, typename TValue, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TValue, VN> || util::validate_compact_args_v<TIndex, TValue, VN>
+    struct FftProperties {
+    public:
+        using TComplex = std::conditional_t<util::validate_compact_args_v<TIndex, TValue, VN>, CompactComplex<TValue>, std::complex<TValue>>;
+        static constexpr TIndex N = static_cast<TIndex>(VN);
+        static constexpr TIndex M = static_cast<TIndex>(std::bit_width<TIndex>(N) - 1);
+        static constexpr TIndex HALF_POINT = N >> static_cast<TIndex>(1);
+    };
+
+    /**
+     * @brief The core FFT class.
+     * @details
+     * The core class implementing FFT algorithm.
+     * If N is a power of 2, it is computed by radix-4 engine.
+     * Otherwise, it is computed by mixed-radix Stockham passes if N only has prime factors 2, 3, 5 and 7,
+     * or by Bluestein algorithm. See FftPlan for details.
+     * @tparam TIndex 
+     * @tparam TFloat 
+     * @tparam N The point of FFT which must be >= 2.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN>
+    class Fft {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex M = TProperties::M;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+
+        using TPlanCache = FftPlanCache<TIndex, TFloat>;
+        using TPlan = TPlanCache::TPlan;
+
+    public:
+        /**
+         * @brief Construct FFT instance.
+         * @details
+         * Twiddle factors and bit-reversed swap list are stored once per TFloat and N,
+         * and they are shared by all instances.
+         * So constructing instance is free and instance occupies no memory.
+         */
+        Fft() = default;
+
+    private:
+        /**
+         * @brief Get the shared plan of given direction and algorithm.
+         * @details
+         * The plan is fetched from FftPlanCache by the first call,
+         * and held by this function forever, even if FftPlanCache is cleared.
+         */
+        template<FftDirection VDirection, FftAlgorithm VAlgorithm = FftAlgorithm::CooleyTukey>
+        static const TPlan& get_plan() {
+            static const typename TPlanCache::TPlanPtr plan = TPlanCache::get(N, VDirection, VAlgorithm);
+            return *plan;
+        }
+
+        /**
+         * @brief Get the shared forward plan of given algorithm.
+         */
+        static const TPlan& get_forward_plan(FftAlgorithm algorithm) {
+            switch (algorithm) {
+                case FftAlgorithm::CooleyTukey:
+                    return get_plan<FftDirection::Forward, FftAlgorithm::CooleyTukey>();
+                case FftAlgorithm::Stockham:
+                    return get_plan<FftDirection::Forward, FftAlgorithm::Stockham>();
+                case FftAlgorithm::Measure:
+                    return get_plan<FftDirection::Forward, FftAlgorithm::Measure>();
+                default:
+                    throw std::invalid_argument("invalid FFT algorithm");
+            }
+        }
+
+    public:
+        /**
+		 * @brief Compute FFT for given complex sequence.
+		 * @details
+		 * This is FFT core compute function but not suit for common user
+		 * because it order that you have enough FFT knowledge to understand what is input data and what is output data.
+		 * For convenient use, see also easy_compute().
+		 *
+		 * The computation is radix-4 decimation-in-time FFT by default.
+		 * Its butterflies are vectorized by SSE2 or AVX2 for \c float and \c double if they are enabled at compile time.
+		 * @param[in,out] data 
+		 * The complex sequence for computing.
+		 * The length of this sequence must be N.
+		 * @param[in] algorithm
+		 * The algorithm of FFT. It is ignored if N is not a power of 2.
+		 * Stockham algorithm and the point which is not a power of 2 use the scratch buffer owned by current thread.
+		 * FftAlgorithm::Measure uses the algorithm chosen by FftPlanner.
+		*/
+        void compute(TComplex* data, FftAlgorithm algorithm = FftAlgorithm::CooleyTukey) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            get_forward_plan(algorithm).compute(data);
+        }
+
+        /**
+		 * @brief Compute FFT from source sequence into destination sequence.
+		 * @details
+		 * Source sequence is never written.
+		 * With Stockham algorithm, all passes are directly executed between source, destination and scratch buffer
+		 * in purely sequential access, so that it is friendly to cache for large N.
+		 * @param[in] src
+		 * The complex sequence for computing.
+		 * The length of this sequence must be N.
+		 * @param[out] dst
+		 * The computed complex sequence with length N.
+		 * It can be the same one with \p src, otherwise they must not overlap.
+		 * @param[in] algorithm The algorithm of FFT.
+		 * @param[in] scratch
+		 * The scratch buffer which is used by Stockham algorithm and the point which is not a power of 2.
+		 * Its length must be get_scratch_size() with the same algorithm.
+		 * If it is nullptr, the scratch buffer owned by current thread is used.
+		*/
+        void compute(const TComplex* src,
+                     TComplex* dst,
+                     FftAlgorithm algorithm = FftAlgorithm::CooleyTukey,
+                     TComplex* scratch = nullptr) const {
+            get_forward_plan(algorithm).compute(src, dst, scratch);
+        }
+
+        /**
+		 * @brief Compute inverse FFT for given complex sequence.
+		 * @details The backward plan is shared with all other instances by FftPlanCache.
+		 * @param[in,out] data
+		 * The complex sequence for computing.
+		 * The length of this sequence must be N.
+		 * @param[in] normalization The normalization of result.
+		*/
+        void compute_inverse(TComplex* data, FftNormalization normalization = FftNormalization::ByN) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            get_plan<FftDirection::Backward>().compute(data);
+            if (normalization == FftNormalization::ByN) {
+                const TFloat scale = static_cast<TFloat>(1) / static_cast<TFloat>(N);
+                for (TIndex i = static_cast<TIndex>(0); i < N; ++i) {
+                    data[i] *= scale;
+                }
+            }
+        }
+
+        /**
+		 * @brief Compute inverse FFT from source sequence into destination sequence.
+		 * @param[in] src
+		 * The complex sequence for computing.
+		 * The length of this sequence must be N.
+		 * @param[out] dst
+		 * The computed complex sequence with length N.
+		 * It can be the same one with \p src, otherwise they must not overlap.
+		 * @param[in] scratch
+		 * The scratch buffer whose length is get_scratch_size().
+		 * It must not overlap with \p src or \p dst.
+		 * If it is nullptr, the scratch buffer owned by current thread is used.
+		 * @param[in] normalization The normalization of result.
+		*/
+        void compute_inverse(const TComplex* src,
+                             TComplex* dst,
+                             TComplex* scratch = nullptr,
+                             FftNormalization normalization = FftNormalization::ByN) const {
+            get_plan<FftDirection::Backward>().compute(src, dst, scratch);
+            if (normalization == FftNormalization::ByN) {
+                const TFloat scale = static_cast<TFloat>(1) / static_cast<TFloat>(N);
+                for (TIndex i = static_cast<TIndex>(0); i < N; ++i) {
+                    dst[i] *= scale;
+                }
+            }
+        }
+
+        /**
+		 * @brief Get the length of scratch buffer required by the overloads with scratch buffer.
+		 * @param[in] algorithm The algorithm of FFT.
+		 * @return The count of complex numbers. See FftPlan::get_scratch_size() for details.
+		*/
+        static TIndex get_scratch_size(FftAlgorithm algorithm = FftAlgorithm::CooleyTukey) {
+            return get_forward_plan(algorithm).get_scratch_size();
+        }
+
+        /**
+		 * @brief Compute FFT for given split-complex sequence.
+		 * @details
+		 * Real parts and imaginary parts are stored in two separate arrays,
+		 * and they are computed in place without interleaving into complex sequence.
+		 * If N is a power of 2, the computation is split-complex Stockham FFT,
+		 * whose SIMD registers hold only real parts or only imaginary parts, so that complex multiplication needs no shuffle.
+		 * See FftPlan::compute(TFloat*, TFloat*) for details.
+		 * @param[in,out] re The real parts with length N.
+		 * @param[in,out] im The imaginary parts with length N. It must not overlap with \p re.
+		*/
+        void compute(TFloat* re, TFloat* im) const {
+            get_plan<FftDirection::Forward>().compute(re, im);
+        }
+
+        /**
+		 * @brief Compute inverse FFT for given split-complex sequence.
+		 * @param[in,out] re The real parts with length N.
+		 * @param[in,out] im The imaginary parts with length N. It must not overlap with \p re.
+		 * @param[in] normalization The normalization of result.
+		*/
+        void compute_inverse(TFloat* re, TFloat* im, FftNormalization normalization = FftNormalization::ByN) const {
+            get_plan<FftDirection::Backward>().compute(re, im);
+            if (normalization == FftNormalization::ByN) {
+                const TFloat scale = static_cast<TFloat>(1) / static_cast<TFloat>(N);
+                for (TIndex i = static_cast<TIndex>(0); i < N; ++i) {
+                    re[i] *= scale;
+                    im[i] *= scale;
+                }
+            }
+        }
+
+        /**
+		 * @brief Compute FFT for multiple channels at once.
+		 * @details
+		 * Channels are interleaved (structure-of-arrays layout),
+		 * that is, the k-th item of c-th channel is located at <TT>data[k * stride + c]</TT>.
+		 * It is faster than calling compute() for each channel,
+		 * because one SIMD lane processes one channel and twiddle factors are loaded only once for all channels.
+		 * @param[in,out] data
+		 * The batched complex sequence for computing.
+		 * Its length must be at least <TT>(N - 1) * stride + channels</TT>.
+		 * @param[in] channels The count of channels.
+		 * @param[in] stride The distance between the k-th and (k+1)-th item of the same channel. It must be >= channels.
+		 * @exception std::invalid_argument N is not a power of 2.
+		*/
+        void compute_batch(TComplex* data, TIndex channels, TIndex stride) const {
+            get_plan<FftDirection::Forward>().compute_batch(data, channels, stride);
+        }
+
+        /**
+         * @brief The count of points computed by one task of parallel_compute() and parallel_compute_inverse().
+         * @details
+         * It keeps the frames of one task resident in cache, and makes the cost of claiming task negligible.
+         */
+        static constexpr TIndex PARALLEL_GRAIN = static_cast<TIndex>(16384);
+
+        /**
+         * @brief Compute FFT for many independent frames by thread pool.
+         * @details
+         * Frames are stored one after another, that is, the k-th item of i-th frame is located at <TT>data[i * N + k]</TT>.
+         * Frames are grouped into chunks of about PARALLEL_GRAIN points, and chunks are claimed by threads of the pool one by one,
+         * so that threads finishing earlier take more chunks.
+         * All threads share the same read-only plan, and each thread uses its own scratch buffer.
+         *
+         * If there is only one chunk, or the pool only has one thread, all frames are computed inline in calling thread
+         * without waking up the pool.
+         * @param[in,out] frames
+         * The frames for computing.
+         * The length of this sequence must be <TT>count * N</TT>.
+         * @param[in] count The count of frames.
+         * @param[in] pool The thread pool executing chunks.
+         * @param[in] algorithm The algorithm of FFT. See compute() for details.
+         */
+        void parallel_compute(TComplex* frames,
+                              TIndex count,
+                              FftThreadPool& pool,
+                              FftAlgorithm algorithm = FftAlgorithm::CooleyTukey) const {
+            if (frames == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            const TPlan& plan = get_forward_plan(algorithm);
+            dispatch_frames(pool, count, [&plan, frames](TIndex begin, TIndex end) {
+                for (TIndex i = begin; i < end; ++i) {
+                    plan.compute(frames + i * N);
+                }
+            });
+        }
+
+        /**
+         * @brief Compute inverse FFT for many independent frames by thread pool.
+         * @details The layout of frames and the way of splitting them are the same as parallel_compute().
+         * @param[in,out] frames
+         * The frames for computing.
+         * The length of this sequence must be <TT>count * N</TT>.
+         * @param[in] count The count of frames.
+         * @param[in] pool The thread pool executing chunks.
+         * @param[in] normalization The normalization of result.
+         */
+        void parallel_compute_inverse(TComplex* frames,
+                                      TIndex count,
+                                      FftThreadPool& pool,
+                                      FftNormalization normalization = FftNormalization::ByN) const {
+            if (frames == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            const TPlan& plan = get_plan<FftDirection::Backward>();
+            const bool normalize = normalization == FftNormalization::ByN;
+            dispatch_frames(pool, count, [&plan, frames, normalize](TIndex begin, TIndex end) {
+                const TFloat scale = static_cast<TFloat>(1) / static_cast<TFloat>(N);
+                for (TIndex i = begin; i < end; ++i) {
+                    TComplex* frame = frames + i * N;
+                    plan.compute(frame);
+                    if (normalize) {
+                        for (TIndex k = static_cast<TIndex>(0); k < N; ++k) {
+                            frame[k] *= scale;
+                        }
+                    }
+                }
+            });
+        }
+
+    private:
+        /**
+         * @brief Split frames into chunks and execute <TT>func(begin, end)</TT> for each chunk.
+         * @details
+         * Each chunk has at least PARALLEL_GRAIN points, and there are at most 4 chunks per thread for balancing.
+         * Chunks are executed inline if there is only one chunk or one thread.
+         */
+        template<typename TFunc>
+        static void dispatch_frames(FftThreadPool& pool, TIndex count, const TFunc& func) {
+            if (count == static_cast<TIndex>(0)) return;
+
+            const TIndex threads = static_cast<TIndex>(pool.get_thread_count());
+            const TIndex min_chunk = std::max(PARALLEL_GRAIN / N, static_cast<TIndex>(1));
+            const TIndex balanced_chunk = (count + threads * static_cast<TIndex>(4) - static_cast<TIndex>(1))
+                                          / (threads * static_cast<TIndex>(4));
+            const TIndex chunk = std::max(min_chunk, balanced_chunk);
+            const TIndex chunks = (count + chunk - static_cast<TIndex>(1)) / chunk;
+
+            if (threads == static_cast<TIndex>(1) || chunks == static_cast<TIndex>(1)) {
+                func(static_cast<TIndex>(0), count);
+                return;
+            }
+            pool.parallel_for(static_cast<size_t>(chunks), [&func, chunk, count](size_t index) {
+                const TIndex begin = static_cast<TIndex>(index) * chunk;
+                func(begin, std::min(begin + chunk, count));
+            });
+        }
+    };
+
+    /**
+     * @brief The FFT class for real-number input.
+     * @details
+     * This class computes N-point FFT for real-number sequence by packing N real numbers into an N/2-point complex sequence
+     * (even items as real parts and odd items as imaginary parts), computing N/2-point FFT on it,
+     * and splitting the result by an extra twiddle pass.
+     * Comparing with widening real numbers into complex numbers and computing N-point FFT,
+     * it takes about half of computation and memory traffic.
+     *
+     * Because the spectrum of real-number sequence is conjugate symmetric,
+     * only first N/2 + 1 items (from 0Hz to Nyquist frequency) are computed.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The point of FFT which must be an even number and >= 4.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4)) && (VN % static_cast<TIndex>(2) == static_cast<TIndex>(0))
+    class RealFft {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        static constexpr TIndex QUARTER_POINT = HALF_POINT >> static_cast<TIndex>(1);
+        /// @brief The end of pairs (k, N/2 - k) processed by split pass. If N/2 is even, the middle item N/4 is processed alone.
+        static constexpr TIndex SPLIT_END = (HALF_POINT + static_cast<TIndex>(1)) >> static_cast<TIndex>(1);
+        static constexpr bool HAS_MIDDLE = (HALF_POINT & static_cast<TIndex>(1)) == static_cast<TIndex>(0);
+        using UnderlyingFft = Fft<TIndex, TFloat, HALF_POINT>;
+
+    public:
+        /**
+         * @brief Construct real FFT instance.
+         * @details Like Fft, all tables are shared by all instances, so constructing instance is free.
+         */
+        RealFft() = default;
+
+    private:
+        UnderlyingFft underlying_fft;
+
+        /**
+         * @brief Get the shared W(N)^k table for split pass.
+         * @details
+         * Only first quarter is needed due to the symmetry of split pass.
+         * Like the plan in Fft, it is built by the first call and shared by all instances with the same N.
+         * @return The table with length N / 4 + 1.
+         */
+        static const TComplex* get_split_table() {
+            static const std::vector<TComplex> table = []() {
+                std::vector<TComplex> rv(QUARTER_POINT + static_cast<TIndex>(1));
+                for (TIndex k = static_cast<TIndex>(0); k <= QUARTER_POINT; ++k) {
+                    TFloat angle = util::tau_v<TFloat> * static_cast<TFloat>(k) / static_cast<TFloat>(N);
+                    rv[k] = TComplex(std::cos(angle), -std::sin(angle));
+                }
+                return rv;
+            }();
+            return table.data();
+        }
+
+    public:
+        /**
+         * @brief Compute FFT for given real-number sequence.
+         * @param[in] time_scope
+         * The real-number sequence for computing.
+         * The length of this sequence must be N.
+         * @param[out] freq_scope
+         * The computed complex spectrum.
+         * The length of this sequence must be N / 2 + 1.
+         * The first item is 0Hz and the last item is Nyquist frequency.
+         */
+        void compute(const TFloat* time_scope, TComplex* freq_scope) const {
+            if (time_scope == nullptr || freq_scope == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for real FFT computing.");
+            }
+
+            // Packing N real numbers into N/2 complex numbers is exactly the memory layout of complex array.
+            std::copy_n(time_scope, N, reinterpret_cast<TFloat*>(freq_scope));
+            compute(freq_scope);
+        }
+
+        /**
+         * @brief Compute FFT for real-number sequence in place.
+         * @details
+         * This overload is useful when caller can directly write real-number sequence into the output buffer
+         * (through reinterpreting it as float-point array), so that the extra copy is avoided.
+         * @param[in,out] data
+         * The buffer with length N / 2 + 1.
+         * Before computing, its first N float-point items (reinterpret it as float-point array) are real-number sequence.
+         * After computing, it is the complex spectrum like the other overload.
+         */
+        void compute(TComplex* data) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for real FFT computing.");
+            }
+
+            // Compute N/2 point FFT on packed sequence.
+            underlying_fft.compute(data);
+
+            // Split packed spectrum Z into real spectrum X.
+            // Pairs (k, N/2 - k) are processed together in place, and vectorized by SIMD pack.
+            const TComplex z0 = data[0];
+            data[0] = TComplex(z0.real() + z0.imag(), static_cast<TFloat>(0));
+            data[HALF_POINT] = TComplex(z0.real() - z0.imag(), static_cast<TFloat>(0));
+            util::real_fft_split<TIndex, TFloat>(data, HALF_POINT, SPLIT_END, get_split_table());
+            // X[N/4] = conj(Z[N/4]) because W(N)^(N/4) = -j.
+            if constexpr (HAS_MIDDLE) data[QUARTER_POINT] = std::conj(data[QUARTER_POINT]);
+        }
+
+        /**
+         * @brief Compute inverse FFT producing real-number sequence.
+         * @details
+         * The packed sequence is computed in the scratch buffer owned by current thread,
+         * and then copied into \p time_scope, so that \p time_scope has no requirement of complex alignment.
+         * If the extra copy matters, use the in-place overload instead.
+         * @param[in] freq_scope
+         * The complex spectrum with length N / 2 + 1, which is in the same format produced by compute().
+         * The imaginary parts of the first and the last items are ignored.
+         * @param[out] time_scope
+         * The computed real-number sequence with length N.
+         * @param[in] normalization The normalization of result.
+         */
+        void compute_inverse(const TComplex* freq_scope,
+                             TFloat* time_scope,
+                             FftNormalization normalization = FftNormalization::ByN) const {
+            if (freq_scope == nullptr || time_scope == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for real FFT computing.");
+            }
+
+            // The scratch of underlying FFT follows packed sequence, so that they never overlap.
+            TComplex* packed = util::thread_scratch<TFloat>(static_cast<size_t>(HALF_POINT + UnderlyingFft::get_scratch_size()));
+            merge(freq_scope, packed, normalization);
+            underlying_fft.compute_inverse(packed, packed, packed + HALF_POINT, FftNormalization::None);
+            // Merged N/2 complex numbers are exactly the memory layout of N real numbers.
+            std::copy_n(reinterpret_cast<const TFloat*>(packed), N, time_scope);
+        }
+
+        /**
+         * @brief Compute inverse FFT producing real-number sequence in place.
+         * @param[in,out] data
+         * The buffer with length N / 2 + 1.
+         * Before computing, it is the complex spectrum in the same format produced by compute().
+         * After computing, its first N float-point items (reinterpret it as float-point array) are real-number sequence.
+         * @param[in] normalization The normalization of result.
+         */
+        void compute_inverse(TComplex* data, FftNormalization normalization = FftNormalization::ByN) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for real FFT computing.");
+            }
+
+            merge(data, data, normalization);
+            underlying_fft.compute_inverse(data, FftNormalization::None);
+        }
+
+    private:
+        /**
+         * @brief Merge real spectrum X into packed spectrum Z for inverse computing.
+         * @details
+         * This is the reverse of split pass.
+         * Xe[k] = (X[k] + conj(X[N/2 - k])) / 2, Xo[k] = conj(W(N)^k) * (X[k] - conj(X[N/2 - k])) / 2,
+         * Z[k] = Xe[k] + j * Xo[k] and Z[N/2 - k] = conj(Xe[k] - j * Xo[k]).
+         * The scale required by normalization is folded into this pass, instead of dividing by 2.
+         * @param[in] src The real spectrum with length N / 2 + 1.
+         * @param[out] dst The packed spectrum with length N / 2. It can be the same one with \p src.
+         * @param[in] normalization The normalization of final result.
+         */
+        void merge(const TComplex* src, TComplex* dst, FftNormalization normalization) const {
+            // Backward N/2 point FFT produces N/2 times result, and we drop the half of Xe and Xo,
+            // so scale 1/N produces normalized result and scale 1 produces N times result.
+            const TFloat scale = normalization == FftNormalization::ByN ? static_cast<TFloat>(1) / static_cast<TFloat>(N)
+                                                                         : static_cast<TFloat>(1);
+
+            const TFloat x0 = src[0].real(), xn = src[HALF_POINT].real();
+            const TComplex quarter = src[QUARTER_POINT];
+            util::real_fft_merge<TIndex, TFloat>(src, dst, HALF_POINT, SPLIT_END, get_split_table(), scale);
+            dst[0] = TComplex((x0 + xn) * scale, (x0 - xn) * scale);
+            // Z[N/4] = conj(X[N/4]) and we drop the half here.
+            if constexpr (HAS_MIDDLE) dst[QUARTER_POINT] = std::conj(quarter) * (static_cast<TFloat>(2) * scale);
+        }
+    };
+
+    /**
+     * @brief User friendly FFT computation class.
+     * @details 
+     * @tparam TIndex 
+     * @tparam TFloat 
+     * @tparam N 
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4)) && (VN % static_cast<TIndex>(2) == static_cast<TIndex>(0))
+    class FriendlyFft {
+    private:
+        using UnderlyingFft = RealFft<TIndex, TFloat, VN>;
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex M = TProperties::M;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+
+    public:
+        FriendlyFft() : compute_cache(HALF_POINT + static_cast<TIndex>(1)) {}
+
+    private:
+        UnderlyingFft underlying_fft;
+        /**
+         * @brief The buffer for real FFT in place computing, whose length is N / 2 + 1.
+         * @details It is allocated once in constructor, so that easy_compute() never allocates memory.
+         */
+        std::vector<TComplex> compute_cache;
+
+    public:
+        /**
+		 * @brief Get the maximum frequency by given sample rate.
+		 * @param[in] sample_rate 
+		 * The sample rate of input stream.
+		 * Unit is Hz or SPS (sample point per second).
+		 * @return 
+		 * The last data in computed FFT drequency data represented frequency.
+		 * Unit is Hz.
+		*/
+        TFloat get_max_freq(TFloat sample_rate) {
+            // Following sample priniciple
+            return sample_rate / static_cast<TFloat>(2);
+        }
+
+        /**
+		 * @brief Compute FFT for given time scope data.
+		 * @details
+		 * This is convenient FFT compute function, comparing with compute().
+		 * This function accepts time scope data and output frequency scope data automatically.
+		 * Additionally, it order a window function instance to apply to time scope data before computing.
+		 * @param[in] time_scope The length of this data must be N.
+		 * For the time order of data, the first data should be the oldest data and the last data should be the newest data.
+		 * @param[out] freq_scope The length of this data must be N / 2.
+		 * The first data is 0Hz and the frequency of last data is decided by sample rate which can be computed by get_max_freq() function in this class.
+		 * The frequency of i-th data is i * sample_rate / N.
+		 * @param[in] window The window instance applied to data.
+		 * @remarks
+		 * The amplitude is computed by a fast approximation of logarithm.
+		 * Its absolute error is below 1e-4 dB for float and 1e-6 dB for double.
+		 * Zero amplitude produces a finite floor value (about -189.6 dB for float) rather than negative infinity.
+		 * @warning
+		 * This function is \b NOT thread-safe.
+		 * Please do NOT call this function in different thread for one instance.
+		*/
+        void easy_compute(const TFloat* time_scope, TFloat* freq_scope, const Window<TIndex, TFloat, N>& window) {
+            if (time_scope == nullptr || freq_scope == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for easy FFT computing.");
+            }
+
+            // First, we copy time scope data into cache with reversed order.
+            // because FFT order the first item should be the latest data.
+            // At the same time we multiple it with window function, in one fused pass.
+            // The cache is reinterpreted as float-point array for real FFT in place computing.
+            TFloat* real_cache = reinterpret_cast<TFloat*>(compute_cache.data());
+            window.apply_window(time_scope, real_cache, true);
+
+            // Do FFT compute
+            underlying_fft.compute(compute_cache.data());
+
+            // Compute amplitude from power directly, without square root and std::log10.
+            util::amplitude_db<TIndex, TFloat>(compute_cache.data(), freq_scope, HALF_POINT);
+        }
+    };
+
+#pragma endregion
+
+#pragma region DCT
+
+    /**
+     * @brief The fast DCT-II and its inverse DCT-III.
+     * @details
+     * DCT-II is <TT>X[k] = sum(x[n] * cos(pi * (2n + 1) * k / (2N)))</TT> without any normalization.
+     * It is computed by Makhoul's algorithm:
+     * even items in order and odd items in reversed order are rearranged into a new sequence,
+     * its spectrum is computed by RealFft (that is, one N/2-point complex FFT),
+     * and rotated by <TT>exp(-j * pi * k / (2N))</TT>.
+     * So that it runs in O(N log N) instead of O(N^2) matrix product.
+     *
+     * The underlying FFT and the rotation table are shared by all instances with the same TFloat and N.
+     * The work buffer is allocated once in constructor, so that computing never allocates memory.
+     * @tparam TIndex The index type used by DCT which must be an unsigned integral type.
+     * @tparam TFloat The float point type used by DCT.
+     * @tparam VN The point of DCT which must be an even number and >= 4.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4)) && (VN % static_cast<TIndex>(2) == static_cast<TIndex>(0))
+    class DctII {
+    private:
+        using UnderlyingFft = RealFft<TIndex, TFloat, VN>;
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+
+    public:
+        DctII() : compute_cache(HALF_POINT + static_cast<TIndex>(1)) {}
+
+    private:
+        UnderlyingFft underlying_fft;
+        /**
+         * @brief The buffer for real FFT in place computing, whose length is N / 2 + 1.
+         * @details It is allocated once in constructor, so that computing never allocates memory.
+         */
+        std::vector<TComplex> compute_cache;
+
+        /**
+         * @brief Get the shared rotation table <TT>exp(-j * pi * k / (2N))</TT>.
+         * @details Only k in [0, N / 2] is stored, because each rotated bin produces both X[k] and X[N - k].
+         * @return The table with length N / 2 + 1.
+         */
+        static const TComplex* get_rotation_table() {
+            static const std::vector<TComplex> table = []() {
+                std::vector<TComplex> rv(HALF_POINT + static_cast<TIndex>(1));
+                for (TIndex k = static_cast<TIndex>(0); k <= HALF_POINT; ++k) {
+                    const double angle = std::numbers::pi * static_cast<double>(k) / (2.0 * static_cast<double>(N));
+                    rv[k] = TComplex(static_cast<TFloat>(std::cos(angle)), static_cast<TFloat>(-std::sin(angle)));
+                }
+                return rv;
+            }();
+            return table.data();
+        }
+
+    public:
+        /**
+         * @brief Compute DCT-II for given sequence.
+         * @details
+         * For the spectrum V of rearranged sequence and <TT>W = exp(-j * pi * k / (2N)) * V[k]</TT>,
+         * <TT>X[k] = Re(W)</TT> and <TT>X[N - k] = -Im(W)</TT> for k in [0, N/2].
+         * @param[in] src The sequence for computing with length N.
+         * @param[out] dst The computed DCT-II coefficients with length N. It can be the same one with \p src.
+         */
+        void compute(const TFloat* src, TFloat* dst) {
+            if (src == nullptr || dst == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for DCT computing.");
+            }
+
+            // Rearrange x into v with v[m] = x[2m] and v[N - 1 - m] = x[2m + 1],
+            // directly in the cache reinterpreted as float-point array for real FFT in place computing.
+            TFloat* rearranged = reinterpret_cast<TFloat*>(compute_cache.data());
+            for (TIndex m = static_cast<TIndex>(0); m < HALF_POINT; ++m) {
+                rearranged[m] = src[m * static_cast<TIndex>(2)];
+                rearranged[N - static_cast<TIndex>(1) - m] = src[m * static_cast<TIndex>(2) + static_cast<TIndex>(1)];
+            }
+            underlying_fft.compute(compute_cache.data());
+
+            // Rotate spectrum. The first and the last items only produce one coefficient.
+            const TComplex* spectrum = compute_cache.data();
+            const TComplex* rotation = get_rotation_table();
+            dst[0] = spectrum[0].real();
+            for (TIndex k = static_cast<TIndex>(1); k < HALF_POINT; ++k) {
+                const TComplex v = spectrum[k], w = rotation[k];
+                dst[k] = w.real() * v.real() - w.imag() * v.imag();
+                dst[N - k] = -(w.real() * v.imag() + w.imag() * v.real());
+            }
+            dst[HALF_POINT] = rotation[HALF_POINT].real() * spectrum[HALF_POINT].real();
+        }
+
+        /**
+         * @brief Compute DCT-III, the inverse of DCT-II, for given coefficients.
+         * @details
+         * This is the reverse of compute():
+         * <TT>V[k] = exp(j * pi * k / (2N)) * (X[k] - j * X[N - k])</TT> with <TT>X[N] = 0</TT>,
+         * and the rearranged sequence is restored by inverse RealFft.
+         * @param[in] src The DCT-II coefficients with length N.
+         * @param[out] dst The computed sequence with length N. It can be the same one with \p src.
+         * @param[in] normalization
+         * The normalization of result.
+         * FftNormalization::ByN produces the exact inverse of compute().
+         * FftNormalization::None produces N times result,
+         * which is twice of DCT-III in its common definition <TT>X[0] / 2 + sum(X[k] * cos(pi * (2n + 1) * k / (2N)))</TT>.
+         */
+        void compute_inverse(const TFloat* src, TFloat* dst, FftNormalization normalization = FftNormalization::ByN) {
+            if (src == nullptr || dst == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for DCT computing.");
+            }
+
+            // Rebuild spectrum of rearranged sequence.
+            TComplex* spectrum = compute_cache.data();
+            const TComplex* rotation = get_rotation_table();
+            spectrum[0] = TComplex(src[0], static_cast<TFloat>(0));
+            for (TIndex k = static_cast<TIndex>(1); k < HALF_POINT; ++k) {
+                const TFloat a = src[k], b = src[N - k];
+                const TComplex w = rotation[k];
+                // conj(w) * (a - jb)
+                spectrum[k] = TComplex(w.real() * a - w.imag() * b, -(w.real() * b + w.imag() * a));
+            }
+            spectrum[HALF_POINT] = TComplex(static_cast<TFloat>(2) * rotation[HALF_POINT].real() * src[HALF_POINT], static_cast<TFloat>(0));
+            underlying_fft.compute_inverse(spectrum, normalization);
+
+            // Restore x from v.
+            const TFloat* rearranged = reinterpret_cast<const TFloat*>(spectrum);
+            for (TIndex m = static_cast<TIndex>(0); m < HALF_POINT; ++m) {
+                dst[m * static_cast<TIndex>(2)] = rearranged[m];
+                dst[m * static_cast<TIndex>(2) + static_cast<TIndex>(1)] = rearranged[N - static_cast<TIndex>(1) - m];
+            }
+        }
+    };
+
+    /**
+     * @brief The fast DCT-IV.
+     * @details
+     * DCT-IV is <TT>X[k] = sum(x[n] * cos(pi * (2n + 1) * (2k + 1) / (4N)))</TT> without any normalization.
+     * Even items and reversed odd items are packed into N/2 complex numbers,
+     * which are rotated by <TT>exp(-j * pi * (4n + 1) / (4N))</TT>, computed by N/2-point FFT,
+     * and rotated again by <TT>exp(-j * pi * k / N)</TT>.
+     * So that it runs in O(N log N) instead of O(N^2) matrix product.
+     * DCT-IV is its own inverse except the scale N / 2.
+     *
+     * The underlying FFT and both rotation tables are shared by all instances with the same TFloat and N.
+     * The work buffer is allocated once in constructor, so that computing never allocates memory.
+     * @tparam TIndex The index type used by DCT which must be an unsigned integral type.
+     * @tparam TFloat The float point type used by DCT.
+     * @tparam VN The point of DCT which must be an even number and >= 4.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4)) && (VN % static_cast<TIndex>(2) == static_cast<TIndex>(0))
+    class DctIV {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        using UnderlyingFft = Fft<TIndex, TFloat, HALF_POINT>;
+
+    public:
+        DctIV() : compute_cache(HALF_POINT) {}
+
+    private:
+        UnderlyingFft underlying_fft;
+        /**
+         * @brief The buffer for complex FFT in place computing, whose length is N / 2.
+         * @details It is allocated once in constructor, so that computing never allocates memory.
+         */
+        std::vector<TComplex> compute_cache;
+
+        /**
+         * @brief Get the shared rotation tables.
+         * @details Both rotations are kept in one table, so that one lookup serves the whole transform.
+         * @return
+         * The table with length N, in which the first half is <TT>exp(-j * pi * (4n + 1) / (4N))</TT> applied before FFT,
+         * and the second half is <TT>exp(-j * pi * k / N)</TT> applied after FFT.
+         */
+        static const TComplex* get_rotation_table() {
+            static const std::vector<TComplex> table = []() {
+                std::vector<TComplex> rv(N);
+                for (TIndex k = static_cast<TIndex>(0); k < HALF_POINT; ++k) {
+                    const double pre = std::numbers::pi * static_cast<double>(k * static_cast<TIndex>(4) + static_cast<TIndex>(1))
+                                       / (4.0 * static_cast<double>(N));
+                    const double post = std::numbers::pi * static_cast<double>(k) / static_cast<double>(N);
+                    rv[k] = TComplex(static_cast<TFloat>(std::cos(pre)), static_cast<TFloat>(-std::sin(pre)));
+                    rv[HALF_POINT + k] = TComplex(static_cast<TFloat>(std::cos(post)), static_cast<TFloat>(-std::sin(post)));
+                }
+                return rv;
+            }();
+            return table.data();
+        }
+
+        void compute_scaled(const TFloat* src, TFloat* dst, TFloat scale) {
+            if (src == nullptr || dst == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for DCT computing.");
+            }
+
+            // Pack x[2n] + j * x[N - 1 - 2n] and rotate it. The scale is folded into this pass.
+            const TComplex* pre = get_rotation_table();
+            const TComplex* post = pre + HALF_POINT;
+            TComplex* packed = compute_cache.data();
+            for (TIndex n = static_cast<TIndex>(0); n < HALF_POINT; ++n) {
+                const TFloat a = src[n * static_cast<TIndex>(2)] * scale;
+                const TFloat b = src[N - static_cast<TIndex>(1) - n * static_cast<TIndex>(2)] * scale;
+                const TComplex w = pre[n];
+                packed[n] = TComplex(w.real() * a - w.imag() * b, w.real() * b + w.imag() * a);
+            }
+            underlying_fft.compute(packed);
+
+            // Rotate again, and unpack X[2k] = Re and X[N - 1 - 2k] = -Im.
+            for (TIndex k = static_cast<TIndex>(0); k < HALF_POINT; ++k) {
+                const TComplex v = packed[k], w = post[k];
+                dst[k * static_cast<TIndex>(2)] = w.real() * v.real() - w.imag() * v.imag();
+                dst[N - static_cast<TIndex>(1) - k * static_cast<TIndex>(2)] = -(w.real() * v.imag() + w.imag() * v.real());
+            }
+        }
+
+    public:
+        /**
+         * @brief Compute DCT-IV for given sequence.
+         * @param[in] src The sequence for computing with length N.
+         * @param[out] dst The computed DCT-IV coefficients with length N. It can be the same one with \p src.
+         */
+        void compute(const TFloat* src, TFloat* dst) { compute_scaled(src, dst, static_cast<TFloat>(1)); }
+
+        /**
+         * @brief Compute the inverse of DCT-IV for given coefficients.
+         * @param[in] src The DCT-IV coefficients with length N.
+         * @param[out] dst The computed sequence with length N. It can be the same one with \p src.
+         * @param[in] normalization
+         * The normalization of result.
+         * FftNormalization::ByN scales result by 2 / N, so that it is the exact inverse of compute().
+         * FftNormalization::None is the same as compute().
+         */
+        void compute_inverse(const TFloat* src, TFloat* dst, FftNormalization normalization = FftNormalization::ByN) {
+            const TFloat scale = normalization == FftNormalization::ByN ? static_cast<TFloat>(2) / static_cast<TFloat>(N)
+                                                                         : static_cast<TFloat>(1);
+            compute_scaled(src, dst, scale);
+        }
+    };
+
+#pragma endregion
+
+#pragma region STFT
+
+    /**
+     * @brief Streaming short-time Fourier transform (STFT) stage.
+     * @details
+     * This class accepts a continuous stream of real-number samples,
+     * and produces one spectrum frame for every hop samples, with window function applied.
+     *
+     * Samples are written into an internal ring buffer only once when pushed.
+     * When a frame is popped, windowed samples are read from ring buffer directly into the FFT buffer,
+     * so that the overlapping history is never copied again no matter how large the overlap is.
+     * All buffers are allocated in constructor, and producing frames never allocates memory.
+     *
+     * Typical usage is pushing samples, and popping all available frames,
+     * then pushing the rest samples if not all of them are accepted.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The point of FFT (the length of frame) which must be a power of 2 and >= 4.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4))
+    class Stft {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        using UnderlyingFft = RealFft<TIndex, TFloat, VN>;
+
+    public:
+        /**
+         * @brief Construct STFT stage.
+         * @param[in] hop The count of samples between the start of adjacent frames. It must be in range [1, N].
+         * @param[in] window_type The built-in window function applied to each frame. It can not be WindowType::CustomWindow.
+         * @exception std::invalid_argument Invalid hop size or window type.
+         */
+        Stft(TIndex hop, WindowType window_type = WindowType::HanningWindow) : Stft(hop, Window<TIndex, TFloat, VN>(window_type)) {}
+        /**
+         * @brief Construct STFT stage with given window function.
+         * @param[in] hop The count of samples between the start of adjacent frames. It must be in range [1, N].
+         * @param[in] window The window function applied to each frame.
+         * @exception std::invalid_argument Invalid hop size.
+         */
+        Stft(TIndex hop, const Window<TIndex, TFloat, VN>& window) :
+            hop(hop), mask(0), write_pos(0), frame_pos(0), ring(), frame_cache(HALF_POINT + static_cast<TIndex>(1)), window(window),
+            underlying_fft() {
+            if (hop == static_cast<TIndex>(0) || hop > N) {
+                throw std::invalid_argument("hop size of STFT must be in range [1, N].");
+            }
+
+            // Ring buffer should hold a whole frame and the samples of next hop.
+            // Its capacity is rounded up to power of 2 for cheap index wrapping.
+            TIndex capacity = std::bit_ceil<TIndex>(N + hop);
+            mask = capacity - static_cast<TIndex>(1);
+            ring.resize(capacity);
+        }
+
+    private:
+        TIndex hop;
+        /// @brief The mask for wrapping position into ring buffer index.
+        TIndex mask;
+        /// @brief The position of next pushed sample. It is allowed to overflow and wrap around.
+        TIndex write_pos;
+        /// @brief The position of the first sample of next frame. It is allowed to overflow and wrap around.
+        TIndex frame_pos;
+        std::vector<TFloat> ring;
+        /// @brief The buffer for computing frame in amplitude format, whose length is N / 2 + 1.
+        std::vector<TComplex> frame_cache;
+        Window<TIndex, TFloat, VN> window;
+        UnderlyingFft underlying_fft;
+
+    public:
+        /**
+         * @brief Get the hop size of this stage.
+         * @return The count of samples between the start of adjacent frames.
+         */
+        TIndex get_hop() const { return hop; }
+        /**
+         * @brief Get the count of samples which can be pushed without popping frames.
+         * @return The count of samples.
+         */
+        TIndex get_free_space() const { return static_cast<TIndex>(ring.size()) - (write_pos - frame_pos); }
+        /**
+         * @brief Get the count of frames which can be popped.
+         * @return The count of frames.
+         */
+        TIndex get_frame_count() const {
+            TIndex buffered = write_pos - frame_pos;
+            if (buffered < N) return static_cast<TIndex>(0);
+            else return static_cast<TIndex>(1) + (buffered - N) / hop;
+        }
+
+        /**
+         * @brief Push samples into stream.
+         * @details
+         * The samples occupied by frames which are not popped can not be overwritten,
+         * so this function may accept only a part of given samples.
+         * Pop available frames and push the rest samples again in this case.
+         * @param[in] samples The samples in time order.
+         * @param[in] count The count of samples.
+         * @return The count of accepted samples.
+         */
+        TIndex push(const TFloat* samples, TIndex count) {
+            if (samples == nullptr && count != static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for STFT pushing.");
+            }
+
+            TIndex accepted = std::min(count, get_free_space());
+            // Copy samples in at most 2 continuous parts due to wrapping.
+            TIndex start = write_pos & mask;
+            TIndex first = std::min(accepted, static_cast<TIndex>(ring.size()) - start);
+            std::copy_n(samples, first, ring.data() + start);
+            std::copy_n(samples + first, accepted - first, ring.data());
+            write_pos += accepted;
+            return accepted;
+        }
+
+        /**
+         * @brief Pop the oldest available frame as complex spectrum.
+         * @details
+         * The window is applied in time order, that is, the i-th sample of frame is multiplied by the i-th item of window,
+         * so that the result is the same as RealFft::compute() on the windowed frame.
+         * @param[out] spectrum
+         * The complex spectrum of frame with length N / 2 + 1.
+         * The first item is 0Hz and the last item is Nyquist frequency.
+         * @return True if a frame is popped, otherwise false (there is no available frame).
+         */
+        bool pop_frame(TComplex* spectrum) {
+            if (spectrum == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for STFT popping.");
+            }
+            return pop_frame_into<false>(spectrum);
+        }
+
+        /**
+         * @brief Pop the oldest available frame as amplitude in decibel.
+         * @details
+         * Like FriendlyFft::easy_compute(), the frame is read in reversed order (the newest sample first) when window is applied.
+         * So that the result is exactly the same as FriendlyFft::easy_compute() on this frame, even for asymmetric custom window.
+         * For symmetric windows (all built-in windows), it is the amplitude of the complex spectrum popped by the other overload.
+         * @param[out] freq_scope
+         * The amplitude of frame with length N / 2.
+         * The format is the same one produced by FriendlyFft::easy_compute().
+         * @return True if a frame is popped, otherwise false (there is no available frame).
+         */
+        bool pop_frame(TFloat* freq_scope) {
+            if (freq_scope == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for STFT popping.");
+            }
+            if (!pop_frame_into<true>(frame_cache.data())) return false;
+
+            util::amplitude_db<TIndex, TFloat>(frame_cache.data(), freq_scope, HALF_POINT);
+            return true;
+        }
+
+        /**
+         * @brief Drop all pushed samples, as if nothing has been pushed.
+         */
+        void reset() { write_pos = frame_pos = static_cast<TIndex>(0); }
+
+    private:
+        /**
+         * @brief Pop the oldest available frame as complex spectrum with given reading order.
+         * @tparam VReverse True for reading frame in reversed order like FriendlyFft.
+         */
+        template<bool VReverse>
+        bool pop_frame_into(TComplex* spectrum) {
+            if (get_frame_count() == static_cast<TIndex>(0)) return false;
+
+            // Read windowed samples directly into output buffer and compute real FFT in place.
+            fill_windowed<VReverse>(reinterpret_cast<TFloat*>(spectrum));
+            underlying_fft.compute(spectrum);
+            frame_pos += hop;
+            return true;
+        }
+
+        /**
+         * @brief Read windowed samples of next frame from ring buffer.
+         * @param[out] dst The buffer receiving N windowed samples.
+         * @tparam VReverse True for reading frame in reversed order, that is, the i-th output is <TT>frame[N - 1 - i] * w[i]</TT>.
+         */
+        template<bool VReverse>
+        void fill_windowed(TFloat* dst) const {
+            const TFloat* win_data = window.get_window_data();
+            // Read samples in at most 2 continuous parts due to wrapping.
+            TIndex start = frame_pos & mask;
+            TIndex first = std::min(N, static_cast<TIndex>(ring.size()) - start);
+            if constexpr (VReverse) {
+                // The wrapped part is the newest one, so it comes first.
+                const TIndex second = N - first;
+                util::window_multiply<true, TIndex, TFloat>(ring.data(), win_data, dst, second);
+                util::window_multiply<true, TIndex, TFloat>(ring.data() + start, win_data + second, dst + second, first);
+            } else {
+                util::window_multiply<false, TIndex, TFloat>(ring.data() + start, win_data, dst, first);
+                util::window_multiply<false, TIndex, TFloat>(ring.data(), win_data + first, dst + first, N - first);
+            }
+        }
+    };
+
+#pragma endregion
+
+#pragma region Welch PSD
+
+    /// @brief The averaging method of WelchPsd.
+    enum class PsdAveraging {
+        FixedCount,  ///< Average each block of given count of frames with equal weight. The estimate is updated when a block is full.
+        Exponential, ///< Exponential moving average whose time constant is given count of frames. The estimate is updated by each frame.
+    };
+
+    /**
+     * @brief Streaming power spectral density (PSD) estimator by Welch's method.
+     * @details
+     * This class splits a continuous stream into overlapping windowed frames by Stft,
+     * and averages the linear power of frames.
+     * Averaging power in decibel is wrong because it averages logarithm, so decibel is only computed when estimate is read.
+     * The power of each frame is accumulated by SIMD in one pass without logarithm,
+     * and the window energy correction and the conversion into density are applied once when estimate is read.
+     *
+     * The estimate is one-sided PSD whose unit is the square of input unit per Hz,
+     * so that the integral of it over frequency is the mean power of input.
+     * All buffers are allocated in constructor, and pushing samples never allocates memory.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The point of FFT (the length of frame) which must be a power of 2 and >= 4.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4))
+    class WelchPsd {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        /// @brief The count of bins from 0Hz to Nyquist frequency.
+        static constexpr TIndex BINS = HALF_POINT + static_cast<TIndex>(1);
+        using UnderlyingStft = Stft<TIndex, TFloat, VN>;
+
+    public:
+        /**
+         * @brief Construct Welch PSD estimator.
+         * @param[in] hop The count of samples between the start of adjacent frames. It must be in range [1, N].
+         * Half of N is the common choice for Hanning window.
+         * @param[in] averaging The averaging method.
+         * @param[in] average_count The count of frames in each block, or the time constant in frames. It must not be zero.
+         * @param[in] window_type The built-in window function applied to each frame. It can not be WindowType::CustomWindow.
+         * @exception std::invalid_argument Invalid hop size, average count or window type.
+         */
+        WelchPsd(TIndex hop, PsdAveraging averaging, TIndex average_count, WindowType window_type = WindowType::HanningWindow) :
+            WelchPsd(hop, averaging, average_count, Window<TIndex, TFloat, VN>(window_type)) {}
+        /**
+         * @brief Construct Welch PSD estimator with given window function.
+         * @param[in] hop The count of samples between the start of adjacent frames. It must be in range [1, N].
+         * @param[in] averaging The averaging method.
+         * @param[in] average_count The count of frames in each block, or the time constant in frames. It must not be zero.
+         * @param[in] window The window function applied to each frame.
+         * @exception std::invalid_argument Invalid hop size or average count.
+         */
+        WelchPsd(TIndex hop, PsdAveraging averaging, TIndex average_count, const Window<TIndex, TFloat, VN>& window) :
+            averaging(averaging), average_count(average_count), frame_count(0), ready(false), window_energy(0), stft(hop, window),
+            frame_cache(BINS), accumulator(BINS, static_cast<TFloat>(0)), estimate(BINS, static_cast<TFloat>(0)) {
+            if (average_count == static_cast<TIndex>(0)) {
+                throw std::invalid_argument("average count of Welch PSD must not be zero.");
+            }
+            if (averaging != PsdAveraging::FixedCount && averaging != PsdAveraging::Exponential) {
+                throw std::invalid_argument("invalid averaging method of Welch PSD.");
+            }
+
+            // Window energy is summed in double for accuracy, because it is computed only once.
+            const TFloat* win_data = window.get_window_data();
+            double energy = 0.0;
+            for (TIndex i = 0; i < N; ++i) {
+                energy += static_cast<double>(win_data[i]) * static_cast<double>(win_data[i]);
+            }
+            window_energy = static_cast<TFloat>(energy);
+        }
+
+    private:
+        PsdAveraging averaging;
+        TIndex average_count;
+        /// @brief The count of frames accumulated in current block, or the count of all frames for exponential averaging (saturated).
+        TIndex frame_count;
+        /// @brief True if there is an estimate can be read.
+        bool ready;
+        /// @brief The sum of squared window data.
+        TFloat window_energy;
+        UnderlyingStft stft;
+        /// @brief The buffer receiving complex spectrum of frame, whose length is N / 2 + 1.
+        std::vector<TComplex> frame_cache;
+        /// @brief The accumulated power of frames, whose length is N / 2 + 1.
+        std::vector<TFloat> accumulator;
+        /// @brief The sum of power of the last full block for fixed count averaging, whose length is N / 2 + 1.
+        std::vector<TFloat> estimate;
+
+    public:
+        /**
+         * @brief Get the hop size of this estimator.
+         * @return The count of samples between the start of adjacent frames.
+         */
+        TIndex get_hop() const { return stft.get_hop(); }
+        /**
+         * @brief Check whether there is an estimate can be read.
+         * @details
+         * For fixed count averaging, it is true after the first block is full.
+         * For exponential averaging, it is true after the first frame.
+         * @return True if estimate can be read.
+         */
+        bool has_estimate() const { return ready; }
+
+        /**
+         * @brief Push samples into stream.
+         * @details
+         * All given samples are accepted, and all produced frames are accumulated immediately.
+         * @param[in] samples The samples in time order.
+         * @param[in] count The count of samples.
+         */
+        void push(const TFloat* samples, TIndex count) {
+            if (samples == nullptr && count != static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for Welch PSD pushing.");
+            }
+
+            while (count != static_cast<TIndex>(0)) {
+                TIndex accepted = stft.push(samples, count);
+                samples += accepted;
+                count -= accepted;
+                while (stft.pop_frame(frame_cache.data())) {
+                    accumulate_frame();
+                }
+            }
+        }
+
+        /**
+         * @brief Read the estimated power spectral density.
+         * @param[out] psd The one-sided PSD with length N / 2 + 1. The first item is 0Hz and the last item is Nyquist frequency.
+         * The unit is the square of input unit per Hz.
+         * @param[in] sample_rate The sample rate of input stream in Hz. It must be finite and positive.
+         * @return True if estimate is read, otherwise false (there is no estimate yet).
+         * @exception std::invalid_argument Null \p psd or invalid sample rate.
+         */
+        bool get_psd(TFloat* psd, TFloat sample_rate) const {
+            if (psd == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for Welch PSD reading.");
+            }
+            if (!std::isfinite(sample_rate) || sample_rate <= static_cast<TFloat>(0)) [[unlikely]] {
+                throw std::invalid_argument("sample rate of Welch PSD must be positive.");
+            }
+            if (!ready) return false;
+
+            // Fixed count averaging stores the sum of block, which is divided here.
+            const TFloat* power = averaging == PsdAveraging::FixedCount ? estimate.data() : accumulator.data();
+            TFloat scale = static_cast<TFloat>(1) / (sample_rate * window_energy);
+            if (averaging == PsdAveraging::FixedCount) scale /= static_cast<TFloat>(average_count);
+            // One-sided spectrum folds negative frequencies, except 0Hz and Nyquist frequency which have no mirror.
+            const TFloat folded = static_cast<TFloat>(2) * scale;
+            psd[0] = power[0] * scale;
+            for (TIndex i = 1; i < HALF_POINT; ++i) {
+                psd[i] = power[i] * folded;
+            }
+            psd[HALF_POINT] = power[HALF_POINT] * scale;
+            return true;
+        }
+
+        /**
+         * @brief Read the estimated power spectral density in decibel.
+         * @details
+         * The result is <TT>10 * log10(psd)</TT> of get_psd().
+         * The logarithm is computed by the same fast approximation used by FriendlyFft.
+         * @param[out] psd_db The one-sided PSD in decibel with length N / 2 + 1.
+         * @param[in] sample_rate The sample rate of input stream in Hz. It must be finite and positive.
+         * @return True if estimate is read, otherwise false (there is no estimate yet).
+         * @exception std::invalid_argument Null \p psd_db or invalid sample rate.
+         */
+        bool get_psd_db(TFloat* psd_db, TFloat sample_rate) const {
+            if (!get_psd(psd_db, sample_rate)) return false;
+            util::power_db<TIndex, TFloat>(psd_db, psd_db, BINS);
+            return true;
+        }
+
+        /**
+         * @brief Drop all pushed samples and estimate, as if nothing has been pushed.
+         */
+        void reset() {
+            stft.reset();
+            std::fill(accumulator.begin(), accumulator.end(), static_cast<TFloat>(0));
+            frame_count = static_cast<TIndex>(0);
+            ready = false;
+        }
+
+    private:
+        /**
+         * @brief Accumulate the power of popped frame.
+         */
+        void accumulate_frame() {
+            if (averaging == PsdAveraging::FixedCount) {
+                util::accumulate_power<false, TIndex, TFloat>(frame_cache.data(), accumulator.data(), BINS, static_cast<TFloat>(0));
+                if (++frame_count == average_count) {
+                    // Publish full block, and start next one.
+                    std::swap(accumulator, estimate);
+                    std::fill(accumulator.begin(), accumulator.end(), static_cast<TFloat>(0));
+                    frame_count = static_cast<TIndex>(0);
+                    ready = true;
+                }
+            } else {
+                // Before time constant is reached, the weight 1 / k gives the plain average of first k frames,
+                // so that the estimate is not biased toward zero at start.
+                if (frame_count < average_count) ++frame_count;
+                const TFloat weight = static_cast<TFloat>(1) / static_cast<TFloat>(frame_count);
+                util::accumulate_power<true, TIndex, TFloat>(frame_cache.data(), accumulator.data(), BINS, weight);
+                ready = true;
+            }
+        }
+    };
+
+#pragma endregion
+
+#pragma region Mel Filterbank
+
+    /**
+     * @brief Mel filterbank and MFCC stage applied to the power spectrum of real FFT.
+     * @details
+     * This class sums the power spectrum into triangular filters equally spaced on mel scale
+     * (HTK formula <TT>mel = 2595 * log10(1 + f / 700)</TT>).
+     * Each filter spans from the center of previous filter to the center of next filter, and its peak weight is 1.
+     *
+     * Each triangular filter only covers a few bins, so filters are stored as sparse runs
+     * (the first covered bin and the contiguous weights of covered bins), rather than a dense matrix full of zeros.
+     * Applying the filterbank is one SIMD dot product per filter, which touches each bin at most twice.
+     * MFCC is the orthonormal DCT-II of mel energies in decibel, computed by a precomputed cosine table.
+     *
+     * Filter runs and cosine table are built once per N, sample rate, mel count and frequency band,
+     * and shared by all instances with the same parameters. They are freed when the last instance using them is destroyed.
+     * Computing never allocates memory.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The point of FFT which must be an even number >= 4, the same as FriendlyFft.
+     * @warning
+     * Member functions computing from time scope data use internal buffers, so they are \b NOT thread-safe.
+     * Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4)) && (VN % static_cast<TIndex>(2) == static_cast<TIndex>(0))
+    class MelFilterbank {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        /// @brief The count of bins from 0Hz to Nyquist frequency.
+        static constexpr TIndex BINS = HALF_POINT + static_cast<TIndex>(1);
+        using UnderlyingFft = RealFft<TIndex, TFloat, VN>;
+
+        /// @brief The immutable tables shared by all instances with the same parameters.
+        struct Tables {
+            /// @brief The first covered bin of each filter.
+            std::vector<TIndex> starts;
+            /// @brief The count of covered bins of each filter. It is zero if the filter is narrower than bin spacing.
+            std::vector<TIndex> lengths;
+            /// @brief The offset of the weights of each filter in \c weights.
+            std::vector<TIndex> offsets;
+            /// @brief The weights of all filters one after another.
+            std::vector<TFloat> weights;
+            /// @brief The orthonormal DCT-II matrix whose row j is the j-th cosine basis, with size mel count * mel count.
+            std::vector<TFloat> dct;
+        };
+        using TTablesPtr = std::shared_ptr<const Tables>;
+
+    public:
+        /**
+         * @brief Construct mel filterbank covering from 0Hz to Nyquist frequency.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @param[in] mel_count The count of mel filters. It must not be zero.
+         * @exception std::invalid_argument Invalid sample rate or mel count.
+         */
+        MelFilterbank(TFloat sample_rate, TIndex mel_count) :
+            MelFilterbank(sample_rate, mel_count, static_cast<TFloat>(0), sample_rate / static_cast<TFloat>(2)) {}
+        /**
+         * @brief Construct mel filterbank covering given frequency band.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @param[in] mel_count The count of mel filters. It must not be zero.
+         * @param[in] min_freq The lower edge of the first filter in Hz.
+         * @param[in] max_freq The upper edge of the last filter in Hz. It must be greater than \p min_freq and <= Nyquist frequency.
+         * @exception std::invalid_argument Invalid sample rate, mel count or frequency band.
+         */
+        MelFilterbank(TFloat sample_rate, TIndex mel_count, TFloat min_freq, TFloat max_freq) :
+            mel_count(mel_count), tables(nullptr), compute_cache(BINS), power_cache(BINS), mel_cache(mel_count) {
+            if (!std::isfinite(sample_rate) || sample_rate <= static_cast<TFloat>(0)) [[unlikely]] {
+                throw std::invalid_argument("sample rate of mel filterbank must be positive.");
+            }
+            if (mel_count == static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("mel filterbank requires at least one filter.");
+            }
+            if (!(min_freq >= static_cast<TFloat>(0) && min_freq < max_freq && max_freq <= sample_rate / static_cast<TFloat>(2)))
+                [[unlikely]] {
+                throw std::invalid_argument("invalid frequency band of mel filterbank.");
+            }
+
+            tables = get_tables(sample_rate, mel_count, min_freq, max_freq);
+        }
+
+    private:
+        TIndex mel_count;
+        TTablesPtr tables;
+        UnderlyingFft underlying_fft;
+        /// @brief The buffer for real FFT in place computing, whose length is N / 2 + 1.
+        std::vector<TComplex> compute_cache;
+        /// @brief The power spectrum of computed frame, whose length is N / 2 + 1.
+        std::vector<TFloat> power_cache;
+        /// @brief The mel energies in decibel used by MFCC computing, whose length is mel count.
+        std::vector<TFloat> mel_cache;
+
+        /**
+         * @brief Get the shared tables of given parameters, and build them if they do not exist.
+         */
+        static TTablesPtr get_tables(TFloat sample_rate, TIndex mel_count, TFloat min_freq, TFloat max_freq) {
+            return get_cache().get(TCacheKey(sample_rate, mel_count, min_freq, max_freq), [=]() {
+                return build_tables(sample_rate, mel_count, min_freq, max_freq);
+            });
+        }
+
+        using TCacheKey = std::tuple<TFloat, TIndex, TFloat, TFloat>;
+        using TCache = util::SharedTableCache<TCacheKey, Tables>;
+
+        /**
+         * @brief Get the cache of tables, which only holds the tables used by alive instances.
+         */
+        static TCache& get_cache() {
+            static TCache cache;
+            return cache;
+        }
+
+    public:
+        /**
+         * @brief Get the count of cached tables of this TFloat and N.
+         * @details It is mainly used for testing. The tables are freed when no instance uses them.
+         * @return The count of cache entries.
+         */
+        static size_t get_cache_size() { return get_cache().get_entry_count(); }
+
+    private:
+
+        static TTablesPtr build_tables(TFloat sample_rate, TIndex mel_count, TFloat min_freq, TFloat max_freq) {
+            auto rv = std::make_shared<Tables>();
+            rv->starts.resize(mel_count);
+            rv->lengths.resize(mel_count);
+            rv->offsets.resize(mel_count);
+
+            // Tables are built in double, because they are built only once.
+            const auto to_mel = [](double freq) -> double { return 2595.0 * std::log10(1.0 + freq / 700.0); };
+            const auto to_freq = [](double mel) -> double { return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); };
+            const double min_mel = to_mel(static_cast<double>(min_freq));
+            const double mel_step = (to_mel(static_cast<double>(max_freq)) - min_mel) / static_cast<double>(mel_count + static_cast<TIndex>(1));
+            const double bin_width = static_cast<double>(sample_rate) / static_cast<double>(N);
+
+            for (TIndex m = static_cast<TIndex>(0); m < mel_count; ++m) {
+                const double lower = to_freq(min_mel + mel_step * static_cast<double>(m));
+                const double center = to_freq(min_mel + mel_step * static_cast<double>(m + static_cast<TIndex>(1)));
+                const double upper = to_freq(min_mel + mel_step * static_cast<double>(m + static_cast<TIndex>(2)));
+
+                rv->starts[m] = static_cast<TIndex>(0);
+                rv->offsets[m] = static_cast<TIndex>(rv->weights.size());
+                for (TIndex k = static_cast<TIndex>(0); k < BINS; ++k) {
+                    const double freq = static_cast<double>(k) * bin_width;
+                    const double weight = freq <= center ? (freq - lower) / (center - lower) : (upper - freq) / (upper - center);
+                    if (weight <= 0.0) {
+                        // Bins are visited in ascending order, so the run is finished once it has started.
+                        if (rv->weights.size() != rv->offsets[m]) break;
+                        continue;
+                    }
+                    if (rv->weights.size() == rv->offsets[m]) rv->starts[m] = k;
+                    rv->weights.emplace_back(static_cast<TFloat>(weight));
+                }
+                rv->lengths[m] = static_cast<TIndex>(rv->weights.size()) - rv->offsets[m];
+            }
+
+            // Orthonormal DCT-II: X[j] = s(j) * sum(x[m] * cos(pi * j * (m + 0.5) / M)),
+            // where s(0) = sqrt(1 / M) and s(j) = sqrt(2 / M) for others.
+            const double count = static_cast<double>(mel_count);
+            rv->dct.resize(static_cast<size_t>(mel_count) * static_cast<size_t>(mel_count));
+            for (TIndex j = static_cast<TIndex>(0); j < mel_count; ++j) {
+                const double scale = std::sqrt((j == static_cast<TIndex>(0) ? 1.0 : 2.0) / count);
+                for (TIndex m = static_cast<TIndex>(0); m < mel_count; ++m) {
+                    const double angle = std::numbers::pi * static_cast<double>(j) * (static_cast<double>(m) + 0.5) / count;
+                    rv->dct[static_cast<size_t>(j) * static_cast<size_t>(mel_count) + m] = static_cast<TFloat>(scale * std::cos(angle));
+                }
+            }
+
+            return rv;
+        }
+
+    public:
+        /**
+         * @brief Get the count of mel filters.
+         * @return The count of mel filters, which is also the maximum count of MFCC.
+         */
+        TIndex get_mel_count() const { return mel_count; }
+        /**
+         * @brief Get the bins covered by given filter.
+         * @param[in] index The index of filter which must be less than mel count.
+         * @return The first covered bin and the weights of covered bins.
+         * The span is empty if the filter is narrower than bin spacing, and its energy is always zero.
+         */
+        std::pair<TIndex, std::span<const TFloat>> get_filter(TIndex index) const {
+            if (index >= mel_count) [[unlikely]] {
+                throw std::invalid_argument("the index of mel filter is out of range.");
+            }
+            return std::make_pair(tables->starts[index], std::span<const TFloat>(tables->weights.data() + tables->offsets[index], tables->lengths[index]));
+        }
+
+        /**
+         * @brief Apply filterbank to power spectrum.
+         * @param[in] power The power spectrum with length N / 2 + 1, that is, the squared magnitude of RealFft result.
+         * @param[out] mel The linear mel energies with length of mel count.
+         */
+        void apply(const TFloat* power, TFloat* mel) const {
+            if (power == nullptr || mel == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for mel filterbank applying.");
+            }
+
+            const Tables& t = *tables;
+            for (TIndex m = static_cast<TIndex>(0); m < mel_count; ++m) {
+                mel[m] = util::dot_product<TIndex, TFloat>(t.weights.data() + t.offsets[m], power + t.starts[m], t.lengths[m]);
+            }
+        }
+
+        /**
+         * @brief Compute MFCC from power spectrum.
+         * @details
+         * Mel energies are converted into decibel by the same fast logarithm used by FriendlyFft,
+         * and MFCC is their orthonormal DCT-II.
+         * @param[in] power The power spectrum with length N / 2 + 1.
+         * @param[out] mfcc The MFCC with length \p mfcc_count. The first item is the 0-th coefficient.
+         * @param[in] mfcc_count The count of coefficients. It must be in range [1, mel count].
+         */
+        void apply_mfcc(const TFloat* power, TFloat* mfcc, TIndex mfcc_count) {
+            if (mfcc == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for MFCC computing.");
+            }
+            if (mfcc_count == static_cast<TIndex>(0) || mfcc_count > mel_count) [[unlikely]] {
+                throw std::invalid_argument("the count of MFCC must be in range [1, mel count].");
+            }
+
+            apply(power, mel_cache.data());
+            util::power_db<TIndex, TFloat>(mel_cache.data(), mel_cache.data(), mel_count);
+            const TFloat* dct = tables->dct.data();
+            for (TIndex j = static_cast<TIndex>(0); j < mfcc_count; ++j) {
+                mfcc[j] = util::dot_product<TIndex, TFloat>(dct + static_cast<size_t>(j) * static_cast<size_t>(mel_count), mel_cache.data(), mel_count);
+            }
+        }
+
+        /**
+         * @brief Compute mel energies in decibel for given time scope data.
+         * @details
+         * Like FriendlyFft::easy_compute(), window is applied, real FFT is computed and power is taken,
+         * then filterbank is applied and the result is converted into decibel.
+         * @param[in] time_scope The length of this data must be N. The first data should be the oldest data.
+         * @param[out] mel_db The mel energies in decibel with length of mel count.
+         * @param[in] window The window instance applied to data.
+         */
+        void easy_compute(const TFloat* time_scope, TFloat* mel_db, const Window<TIndex, TFloat, N>& window) {
+            compute_power(time_scope, window);
+            apply(power_cache.data(), mel_db);
+            util::power_db<TIndex, TFloat>(mel_db, mel_db, mel_count);
+        }
+
+        /**
+         * @brief Compute MFCC for given time scope data.
+         * @param[in] time_scope The length of this data must be N. The first data should be the oldest data.
+         * @param[out] mfcc The MFCC with length \p mfcc_count.
+         * @param[in] mfcc_count The count of coefficients. It must be in range [1, mel count].
+         * @param[in] window The window instance applied to data.
+         */
+        void easy_compute_mfcc(const TFloat* time_scope, TFloat* mfcc, TIndex mfcc_count, const Window<TIndex, TFloat, N>& window) {
+            compute_power(time_scope, window);
+            apply_mfcc(power_cache.data(), mfcc, mfcc_count);
+        }
+
+    private:
+        /**
+         * @brief Compute the power spectrum of windowed time scope data into power cache.
+         */
+        void compute_power(const TFloat* time_scope, const Window<TIndex, TFloat, N>& window) {
+            if (time_scope == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for mel filterbank computing.");
+            }
+
+            // Same as FriendlyFft, window is applied into the buffer of real FFT in reversed order.
+            window.apply_window(time_scope, reinterpret_cast<TFloat*>(compute_cache.data()), true);
+            underlying_fft.compute(compute_cache.data());
+            util::power_spectrum<TIndex, TFloat>(compute_cache.data(), power_cache.data(), BINS);
+        }
+    };
+
+#pragma endregion
+
+#pragma region Spectrum Binner
+
+    /// @brief The frequency axis scale of SpectrumBinner.
+    enum class SpectrumScale {
+        Linear,      ///< Columns are equally spaced in frequency.
+        Logarithmic, ///< Columns are equally spaced in the logarithm of frequency, that is, each column covers the same ratio of frequency.
+    };
+
+    /// @brief The way SpectrumBinner pools the bins covered by one column.
+    enum class SpectrumPooling {
+        Max,  ///< The maximum power of covered bins. Narrow peaks are kept.
+        Mean, ///< The mean power of covered bins. Noise floor is smoothed.
+    };
+
+    /**
+     * @brief The stage reducing the spectrum of real FFT into display columns.
+     * @details
+     * This class maps N / 2 + 1 bins into given count of columns on linear or logarithmic frequency axis.
+     * Each column covers a contiguous run of bins whose frequency is in its band.
+     * If the band of column is narrower than bin spacing (usually the low columns of logarithmic axis),
+     * it takes the bin nearest to its center frequency instead, so that there is no hole in display.
+     *
+     * Bins are pooled by maximum or mean on linear power, not on decibel, so that the result is physically correct,
+     * and only one logarithm is computed for each column.
+     * The power of complex spectrum is computed on the fly while pooling, so that the raw spectrum is turned into
+     * display-ready columns in one pass. Pooling is vectorized by SIMD.
+     * The result is in the same decibel as FriendlyFft::easy_compute(), that is, <TT>10 * log10(abs(X))</TT>.
+     *
+     * Optionally, peak-hold with decay can be applied on the result:
+     * each column shows the maximum of current value and the held value decreased by given decibel per frame.
+     *
+     * Column maps are built once per N, sample rate, column count, scale and frequency band,
+     * and shared by all instances with the same parameters. They are freed when the last instance using them is destroyed.
+     * Computing never allocates memory.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The point of FFT which must be an even number >= 4, the same as FriendlyFft.
+     * @warning
+     * Peak-hold state and internal buffers are modified when computing, so this class is \b NOT thread-safe.
+     * Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_mixed_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4)) && (VN % static_cast<TIndex>(2) == static_cast<TIndex>(0))
+    class SpectrumBinner {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        /// @brief The count of bins from 0Hz to Nyquist frequency.
+        static constexpr TIndex BINS = HALF_POINT + static_cast<TIndex>(1);
+        using UnderlyingFft = RealFft<TIndex, TFloat, VN>;
+
+        /// @brief The immutable column maps shared by all instances with the same parameters.
+        struct Tables {
+            /// @brief The first covered bin of each column.
+            std::vector<TIndex> starts;
+            /// @brief The count of covered bins of each column, which is at least 1.
+            std::vector<TIndex> lengths;
+            /// @brief The reciprocal of the count of covered bins of each column, used by mean pooling.
+            std::vector<TFloat> reciprocals;
+        };
+        using TTablesPtr = std::shared_ptr<const Tables>;
+
+    public:
+        /**
+         * @brief Construct spectrum binner covering up to Nyquist frequency.
+         * @details
+         * The lower edge is 0Hz for linear scale,
+         * and the frequency of the first bin above 0Hz for logarithmic scale, because logarithmic axis can not reach 0Hz.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @param[in] columns The count of columns. It must not be zero.
+         * @param[in] scale The scale of frequency axis.
+         * @param[in] pooling The way pooling the bins covered by one column.
+         * @exception std::invalid_argument Invalid sample rate or column count.
+         */
+        SpectrumBinner(TFloat sample_rate,
+                       TIndex columns,
+                       SpectrumScale scale = SpectrumScale::Logarithmic,
+                       SpectrumPooling pooling = SpectrumPooling::Max) :
+            SpectrumBinner(sample_rate,
+                           columns,
+                           scale,
+                           pooling,
+                           scale == SpectrumScale::Logarithmic ? sample_rate / static_cast<TFloat>(N) : static_cast<TFloat>(0),
+                           sample_rate / static_cast<TFloat>(2)) {}
+        /**
+         * @brief Construct spectrum binner covering given frequency band.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @param[in] columns The count of columns. It must not be zero.
+         * @param[in] scale The scale of frequency axis.
+         * @param[in] pooling The way pooling the bins covered by one column.
+         * @param[in] min_freq The lower edge of the first column in Hz. It must be positive for logarithmic scale.
+         * @param[in] max_freq The upper edge of the last column in Hz. It must be greater than \p min_freq and <= Nyquist frequency.
+         * @exception std::invalid_argument Invalid sample rate, column count, scale, pooling or frequency band.
+         */
+        SpectrumBinner(TFloat sample_rate, TIndex columns, SpectrumScale scale, SpectrumPooling pooling, TFloat min_freq, TFloat max_freq) :
+            columns(columns), pooling(pooling), tables(nullptr), peak_hold(false), peak_decay(static_cast<TFloat>(0)), has_held(false),
+            held_cache(columns), compute_cache(BINS) {
+            if (!std::isfinite(sample_rate) || sample_rate <= static_cast<TFloat>(0)) [[unlikely]] {
+                throw std::invalid_argument("sample rate of spectrum binner must be positive.");
+            }
+            if (columns == static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("spectrum binner requires at least one column.");
+            }
+            if (scale != SpectrumScale::Linear && scale != SpectrumScale::Logarithmic) [[unlikely]] {
+                throw std::invalid_argument("invalid scale of spectrum binner.");
+            }
+            if (pooling != SpectrumPooling::Max && pooling != SpectrumPooling::Mean) [[unlikely]] {
+                throw std::invalid_argument("invalid pooling of spectrum binner.");
+            }
+            const TFloat lowest = scale == SpectrumScale::Logarithmic ? std::numeric_limits<TFloat>::min() : static_cast<TFloat>(0);
+            if (!(min_freq >= lowest && min_freq < max_freq && max_freq <= sample_rate / static_cast<TFloat>(2))) [[unlikely]] {
+                throw std::invalid_argument("invalid frequency band of spectrum binner.");
+            }
+
+            tables = get_tables(sample_rate, columns, scale, min_freq, max_freq);
+        }
+
+    private:
+        TIndex columns;
+        SpectrumPooling pooling;
+        TTablesPtr tables;
+        bool peak_hold;
+        /// @brief The decay of held value in decibel per frame.
+        TFloat peak_decay;
+        /// @brief Whether held values are valid. It is false before the first frame after peak-hold is reset.
+        bool has_held;
+        /// @brief The held values of peak-hold, whose length is column count.
+        std::vector<TFloat> held_cache;
+        UnderlyingFft underlying_fft;
+        /// @brief The buffer for real FFT in place computing, whose length is N / 2 + 1.
+        std::vector<TComplex> compute_cache;
+
+        /**
+         * @brief Get the shared tables of given parameters, and build them if they do not exist.
+         */
+        static TTablesPtr get_tables(TFloat sample_rate, TIndex columns, SpectrumScale scale, TFloat min_freq, TFloat max_freq) {
+            return get_cache().get(TCacheKey(sample_rate, columns, scale, min_freq, max_freq), [=]() {
+                return build_tables(sample_rate, columns, scale, min_freq, max_freq);
+            });
+        }
+
+        using TCacheKey = std::tuple<TFloat, TIndex, SpectrumScale, TFloat, TFloat>;
+        using TCache = util::SharedTableCache<TCacheKey, Tables>;
+
+        /**
+         * @brief Get the cache of column maps, which only holds the maps used by alive instances.
+         */
+        static TCache& get_cache() {
+            static TCache cache;
+            return cache;
+        }
+
+    public:
+        /**
+         * @brief Get the count of cached column maps of this TFloat and N.
+         * @details It is mainly used for testing. The column maps are freed when no instance uses them.
+         * @return The count of cache entries.
+         */
+        static size_t get_cache_size() { return get_cache().get_entry_count(); }
+
+    private:
+
+        static TTablesPtr build_tables(TFloat sample_rate, TIndex columns, SpectrumScale scale, TFloat min_freq, TFloat max_freq) {
+            auto rv = std::make_shared<Tables>();
+            rv->starts.resize(columns);
+            rv->lengths.resize(columns);
+            rv->reciprocals.resize(columns);
+
+            // Tables are built in double, because they are built only once.
+            const double lower = static_cast<double>(min_freq), upper = static_cast<double>(max_freq);
+            const double bin_width = static_cast<double>(sample_rate) / static_cast<double>(N);
+            const auto edge = [&](TIndex c) -> double {
+                const double ratio = static_cast<double>(c) / static_cast<double>(columns);
+                if (scale == SpectrumScale::Logarithmic) return lower * std::pow(upper / lower, ratio);
+                else return lower + (upper - lower) * ratio;
+            };
+            // The first bin whose frequency is not less than given frequency.
+            const auto first_bin = [&](double freq) -> TIndex {
+                return static_cast<TIndex>(std::min(std::ceil(freq / bin_width), static_cast<double>(BINS)));
+            };
+
+            for (TIndex c = static_cast<TIndex>(0); c < columns; ++c) {
+                const double from = edge(c), to = edge(c + static_cast<TIndex>(1));
+                TIndex start = first_bin(from);
+                // The last column includes its upper edge, so that the bin exactly at max_freq is not dropped.
+                TIndex end = c + static_cast<TIndex>(1) == columns
+                                 ? std::min(static_cast<TIndex>(std::floor(to / bin_width)) + static_cast<TIndex>(1), BINS)
+                                 : first_bin(to);
+                if (end <= start) {
+                    const double center = scale == SpectrumScale::Logarithmic ? std::sqrt(from * to) : (from + to) / 2.0;
+                    start = std::min(static_cast<TIndex>(std::round(center / bin_width)), HALF_POINT);
+                    end = start + static_cast<TIndex>(1);
+                }
+                rv->starts[c] = start;
+                rv->lengths[c] = end - start;
+                rv->reciprocals[c] = static_cast<TFloat>(1.0 / static_cast<double>(end - start));
+            }
+
+            return rv;
+        }
+
+    public:
+        /**
+         * @brief Get the count of columns.
+         * @return The count of columns.
+         */
+        TIndex get_column_count() const { return columns; }
+        /**
+         * @brief Get the bins covered by given column.
+         * @param[in] index The index of column which must be less than column count.
+         * @return The first covered bin and the count of covered bins, which is at least 1.
+         */
+        std::pair<TIndex, TIndex> get_column(TIndex index) const {
+            if (index >= columns) [[unlikely]] {
+                throw std::invalid_argument("the index of spectrum column is out of range.");
+            }
+            return std::make_pair(tables->starts[index], tables->lengths[index]);
+        }
+
+        /**
+         * @brief Enable peak-hold with given decay.
+         * @details Held values are kept, so that changing decay does not reset display.
+         * @param[in] decay The decay of held value in decibel per frame. It must be finite and >= 0.
+         * @exception std::invalid_argument Invalid decay.
+         */
+        void enable_peak_hold(TFloat decay) {
+            if (!std::isfinite(decay) || decay < static_cast<TFloat>(0)) [[unlikely]] {
+                throw std::invalid_argument("the decay of peak-hold must be finite and >= 0.");
+            }
+            peak_hold = true;
+            peak_decay = decay;
+        }
+        /**
+         * @brief Disable peak-hold and drop held values.
+         */
+        void disable_peak_hold() {
+            peak_hold = false;
+            has_held = false;
+        }
+        /**
+         * @brief Drop held values, so that the next frame is shown as it is.
+         */
+        void reset_peak_hold() { has_held = false; }
+
+        /**
+         * @brief Reduce power spectrum into display columns.
+         * @param[in] power The power spectrum with length N / 2 + 1, that is, the squared magnitude of RealFft result.
+         * @param[out] columns_db The columns in decibel with length of column count.
+         */
+        void apply(const TFloat* power, TFloat* columns_db) { bin<TFloat>(power, columns_db); }
+
+        /**
+         * @brief Reduce complex spectrum into display columns.
+         * @details The power of each bin is computed on the fly while pooling.
+         * @param[in] spectrum The complex spectrum with length N / 2 + 1, that is, the result of RealFft.
+         * @param[out] columns_db The columns in decibel with length of column count.
+         */
+        void apply(const TComplex* spectrum, TFloat* columns_db) { bin<TComplex>(spectrum, columns_db); }
+
+        /**
+         * @brief Compute display columns for given time scope data.
+         * @details
+         * Like FriendlyFft::easy_compute(), window is applied and real FFT is computed,
+         * then the spectrum is reduced into columns.
+         * @param[in] time_scope The length of this data must be N. The first data should be the oldest data.
+         * @param[out] columns_db The columns in decibel with length of column count.
+         * @param[in] window The window instance applied to data.
+         */
+        void easy_compute(const TFloat* time_scope, TFloat* columns_db, const Window<TIndex, TFloat, N>& window) {
+            if (time_scope == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for spectrum binner computing.");
+            }
+
+            // Same as FriendlyFft, window is applied into the buffer of real FFT in reversed order.
+            window.apply_window(time_scope, reinterpret_cast<TFloat*>(compute_cache.data()), true);
+            underlying_fft.compute(compute_cache.data());
+            bin<TComplex>(compute_cache.data(), columns_db);
+        }
+
+    private:
+        template<typename TSource>
+        void bin(const TSource* src, TFloat* columns_db) {
+            if (src == nullptr || columns_db == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for spectrum binner computing.");
+            }
+
+            // Pool linear power into output buffer first, then convert it into decibel in place.
+            const Tables& t = *tables;
+            if (pooling == SpectrumPooling::Max) {
+                for (TIndex c = static_cast<TIndex>(0); c < columns; ++c) {
+                    columns_db[c] = util::pool_power<true, TIndex, TFloat>(src + t.starts[c], t.lengths[c]);
+                }
+            } else {
+                for (TIndex c = static_cast<TIndex>(0); c < columns; ++c) {
+                    columns_db[c] = util::pool_power<false, TIndex, TFloat>(src + t.starts[c], t.lengths[c]) * t.reciprocals[c];
+                }
+            }
+            util::amplitude_db<TIndex, TFloat>(columns_db, columns_db, columns);
+
+            if (peak_hold) {
+                if (has_held) {
+                    for (TIndex c = static_cast<TIndex>(0); c < columns; ++c) {
+                        columns_db[c] = std::max(columns_db[c], held_cache[c] - peak_decay);
+                    }
+                }
+                std::copy_n(columns_db, columns, held_cache.data());
+                has_held = true;
+            }
+        }
+    };
+
+#pragma endregion
+
+#pragma region Single-Bin DFT
+
+    /**
+     * @brief Goertzel evaluator for the DFT of a few arbitrary bins.
+     * @details
+     * Each bin costs one multiplication and two additions per sample,
+     * so this class is much cheaper than a whole FFT when only a few bins are interested,
+     * e.g. tone detection or monitoring some specific frequencies.
+     * The break-even point against RealFft is roughly <TT>log2(N)</TT> bins.
+     *
+     * Bins are allowed to be fractional, so the frequency of interest does not need to be aligned to <TT>sample_rate / N</TT>.
+     * The result of integral bin is exactly the same one produced by RealFft::compute() on windowed data.
+     *
+     * The recurrence of each bin is a long dependency chain.
+     * For instruction level parallelism, time scope is split into a few segments evaluated independently,
+     * and several bins are evaluated together in the inner loop.
+     * The results of segments are combined with their phases at the end.
+     * All buffers are allocated in constructor, and computing never allocates memory.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The length of evaluated time scope data which must be a power of 2 and >= 4.
+     * @remarks
+     * The rounding error of Goertzel recurrence grows with N, and is larger for the bins near 0Hz or Nyquist frequency.
+     * Use \c double for large N if high accuracy is required.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_args_v<TIndex, TFloat, VN> && (VN >= static_cast<TIndex>(4))
+    class Goertzel {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        using TPack = util::RealPack<TFloat>;
+        using TReg = TPack::TReg;
+        /// @brief The count of bins evaluated together in one pack.
+        static constexpr TIndex GROUP = static_cast<TIndex>(TPack::WIDTH);
+        /// @brief The count of independently evaluated segments of time scope.
+        static constexpr TIndex SEGMENT = static_cast<TIndex>(4);
+        /// @brief The length of each segment.
+        static constexpr TIndex SEGMENT_LEN = N / SEGMENT;
+
+    public:
+        /**
+         * @brief Construct Goertzel evaluator.
+         * @param[in] bins The bins to be evaluated. Frequency of bin \c k is <TT>k * sample_rate / N</TT>.
+         * Use get_bin() to convert frequency into bin.
+         * @param[in] count The count of bins. It must not be zero.
+         * @exception std::invalid_argument Invalid bins.
+         */
+        Goertzel(const TFloat* bins, TIndex count) :
+            bin_count(count), coeffs(), rotations(), phases(), first_states(), second_states(), windowed(N) {
+            if (bins == nullptr || count == static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("Goertzel evaluator requires at least one bin.");
+            }
+
+            // Pad bins to a multiple of group with zero coefficient, so that inner loop has no remainder.
+            TIndex padded = (count + GROUP - static_cast<TIndex>(1)) / GROUP * GROUP;
+            coeffs.resize(padded, static_cast<TFloat>(0));
+            first_states.resize(padded * SEGMENT);
+            second_states.resize(padded * SEGMENT);
+            rotations.resize(count);
+            phases.resize(count * SEGMENT);
+            for (TIndex k = 0; k < count; ++k) {
+                TFloat bin = bins[k];
+                if (!std::isfinite(bin)) [[unlikely]] {
+                    throw std::invalid_argument("bin of Goertzel evaluator must be finite.");
+                }
+                TFloat omega = util::tau_v<TFloat> * bin / static_cast<TFloat>(N);
+                coeffs[k] = static_cast<TFloat>(2) * std::cos(omega);
+                rotations[k] = TComplex(std::cos(omega), -std::sin(omega));
+                for (TIndex g = 0; g < SEGMENT; ++g) {
+                    // The time of the last sample of segment.
+                    const TIndex time = (g + static_cast<TIndex>(1)) * SEGMENT_LEN - static_cast<TIndex>(1);
+                    const TFloat angle = util::tau_v<TFloat> * util::bin_cycles<TIndex, TFloat>(bin, time, N);
+                    phases[k * SEGMENT + g] = TComplex(std::cos(angle), -std::sin(angle));
+                }
+            }
+        }
+
+    private:
+        TIndex bin_count;
+        /// @brief The coefficient <TT>2 * cos(omega)</TT> of recurrence, padded to a multiple of group.
+        std::vector<TFloat> coeffs;
+        /// @brief <TT>exp(-j * omega)</TT> for finishing recurrence.
+        std::vector<TComplex> rotations;
+        /// @brief <TT>exp(-j * omega * t)</TT> where \c t is the time of the last sample of each segment.
+        std::vector<TComplex> phases;
+        /// @brief The last state of recurrence of each segment. States of the same segment are stored together.
+        std::vector<TFloat> first_states;
+        /// @brief The second last state of recurrence of each segment.
+        std::vector<TFloat> second_states;
+        /// @brief The windowed time scope data shared by all groups of bins.
+        std::vector<TFloat> windowed;
+
+    public:
+        /**
+         * @brief Convert frequency into (fractional) bin.
+         * @param[in] freq The frequency in Hz.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @return The bin of given frequency.
+         */
+        static TFloat get_bin(TFloat freq, TFloat sample_rate) { return freq * static_cast<TFloat>(N) / sample_rate; }
+        /**
+         * @brief Get the count of evaluated bins.
+         * @return The count of bins.
+         */
+        TIndex get_bin_count() const { return bin_count; }
+
+        /**
+         * @brief Compute the complex spectrum of given bins.
+         * @param[in] time_scope The length of this data must be N.
+         * The first data should be the oldest data and the last data should be the newest data.
+         * @param[out] spectrum The complex spectrum of each bin, whose length is the count of bins.
+         * @param[in] window The window instance applied to data.
+         */
+        void compute(const TFloat* time_scope, TComplex* spectrum, const Window<TIndex, TFloat, N>& window) {
+            if (time_scope == nullptr || spectrum == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for Goertzel computing.");
+            }
+
+            run_recurrence(time_scope, window.get_window_data());
+            for (TIndex k = 0; k < bin_count; ++k) {
+                spectrum[k] = combine_segments(k);
+            }
+        }
+
+        /**
+         * @brief Compute the power (squared magnitude) of given bins.
+         * @param[in] time_scope The length of this data must be N.
+         * The first data should be the oldest data and the last data should be the newest data.
+         * @param[out] power The power of each bin, whose length is the count of bins.
+         * @param[in] window The window instance applied to data.
+         */
+        void compute_power(const TFloat* time_scope, TFloat* power, const Window<TIndex, TFloat, N>& window) {
+            if (time_scope == nullptr || power == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for Goertzel computing.");
+            }
+
+            run_recurrence(time_scope, window.get_window_data());
+            for (TIndex k = 0; k < bin_count; ++k) {
+                const TComplex value = combine_segments(k);
+                power[k] = value.real() * value.real() + value.imag() * value.imag();
+            }
+        }
+
+    private:
+        /**
+         * @brief Run Goertzel recurrence <TT>s[n] = x[n] + 2 * cos(omega) * s[n - 1] - s[n - 2]</TT> for all bins.
+         */
+        void run_recurrence(const TFloat* time_scope, const TFloat* win_data) {
+            const TIndex padded = static_cast<TIndex>(coeffs.size());
+            util::window_multiply<false, TIndex, TFloat>(time_scope, win_data, windowed.data(), N);
+            const TFloat* x = windowed.data();
+            for (TIndex b = 0; b < padded; b += GROUP) {
+                // Keep states of one group in locals, so that they live in registers across the whole time scope.
+                const TReg c = TPack::load(coeffs.data() + b);
+                TReg s1[SEGMENT], s2[SEGMENT];
+                for (TIndex g = 0; g < SEGMENT; ++g) {
+                    s1[g] = s2[g] = TPack::zero();
+                }
+                // Segments are unrolled by hand, so that their states are not spilled into memory.
+                for (TIndex i = 0; i < SEGMENT_LEN; ++i) {
+                    recurrence_step(c, x[i], s1[0], s2[0]);
+                    recurrence_step(c, x[SEGMENT_LEN + i], s1[1], s2[1]);
+                    recurrence_step(c, x[2 * SEGMENT_LEN + i], s1[2], s2[2]);
+                    recurrence_step(c, x[3 * SEGMENT_LEN + i], s1[3], s2[3]);
+                }
+                for (TIndex g = 0; g < SEGMENT; ++g) {
+                    TPack::store(first_states.data() + g * padded + b, s1[g]);
+                    TPack::store(second_states.data() + g * padded + b, s2[g]);
+                }
+            }
+        }
+
+        /**
+         * @brief Advance recurrence by one sample.
+         * @details
+         * <TT>x[n] - s[n - 2]</TT> does not depend on last step,
+         * so only one multiplication and one addition are on the dependency chain.
+         */
+        static void recurrence_step(TReg c, TFloat x, TReg& s1, TReg& s2) {
+            const TReg s0 = TPack::add(TPack::mul(c, s1), TPack::sub(TPack::broadcast(x), s2));
+            s2 = s1;
+            s1 = s0;
+        }
+
+        /**
+         * @brief Combine the recurrence states of all segments into the spectrum of given bin.
+         */
+        TComplex combine_segments(TIndex k) const {
+            const TIndex padded = static_cast<TIndex>(coeffs.size());
+            const TFloat rr = rotations[k].real(), ri = rotations[k].imag();
+            TFloat re = static_cast<TFloat>(0), im = static_cast<TFloat>(0);
+            for (TIndex g = 0; g < SEGMENT; ++g) {
+                // y = s1 - exp(-j * omega) * s2 = sum(x[i] * exp(j * omega * (t - i))) where t is the last time of segment.
+                const TFloat s1 = first_states[g * padded + k], s2 = second_states[g * padded + k];
+                const TFloat yr = s1 - rr * s2, yi = -ri * s2;
+                // Move the time origin to the first sample of time scope.
+                const TFloat pr = phases[k * SEGMENT + g].real(), pi = phases[k * SEGMENT + g].imag();
+                re += yr * pr - yi * pi;
+                im += yr * pi + yi * pr;
+            }
+            return TComplex(re, im);
+        }
+    };
+
+    /**
+     * @brief Sliding DFT which updates a few arbitrary bins for each pushed sample.
+     * @details
+     * This class keeps the DFT of the latest N samples for given bins.
+     * Pushing one sample costs O(K) where K is the count of bins, regardless of N,
+     * so that the spectrum can be observed at every sample.
+     *
+     * For each tracked frequency, the sum <TT>A = sum(x[t] * exp(-j * omega * t))</TT> over the samples in window
+     * is updated by adding the new sample and removing the sample which leaves the window.
+     * The time origin does not move with the window, thus no rotation of sum is required for each sample,
+     * and the phase is restored only when the spectrum is read.
+     * To bound the accumulated rounding error, a shadow sum is rebuilt from scratch along with the active one,
+     * and replaces the active one every N samples.
+     * Therefore the error never grows with stream length.
+     *
+     * The window function must be a generalized cosine window (see Window::get_cosine_sum_coefficients()).
+     * Such window is the sum of a few sinusoids, so it is applied in frequency domain
+     * by combining the sums of the neighbouring frequencies of each bin.
+     * A window with L coefficients requires <TT>2 * L - 1</TT> sums per bin.
+     * The result is identical to the DFT of the latest N samples multiplied by window data.
+     *
+     * Bins are allowed to be fractional like Goertzel.
+     * Before N samples are pushed, the missing samples are treated as zero.
+     * All buffers are allocated in constructor, and pushing never allocates memory.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The length of sliding window which must be a power of 2.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_args_v<TIndex, TFloat, VN>
+    class SlidingDft {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        static constexpr TIndex M = TProperties::M;
+        using TPack = util::RealPack<TFloat>;
+        using TReg = TPack::TReg;
+        /// @brief The count of sums updated together in one pack.
+        static constexpr TIndex GROUP = static_cast<TIndex>(TPack::WIDTH);
+        /**
+         * @brief The count of samples between phase reseeding.
+         * @details
+         * The phase of each sum is rotated once per sample, and reseeded from exact table every this count of samples.
+         * It is about square root of N, balancing rounding error and table size.
+         */
+        static constexpr TIndex RESEED = static_cast<TIndex>(1) << ((M + static_cast<TIndex>(1)) / static_cast<TIndex>(2));
+
+    public:
+        /**
+         * @brief Construct sliding DFT without window function (rectangular window).
+         * @param[in] bins The bins to be tracked. Frequency of bin \c k is <TT>k * sample_rate / N</TT>.
+         * @param[in] count The count of bins. It must not be zero.
+         * @exception std::invalid_argument Invalid bins.
+         */
+        SlidingDft(const TFloat* bins, TIndex count) : SlidingDft(bins, count, std::span<const TFloat>(&RECTANGULAR, 1u)) {}
+        /**
+         * @brief Construct sliding DFT with given window function.
+         * @param[in] bins The bins to be tracked. Frequency of bin \c k is <TT>k * sample_rate / N</TT>.
+         * @param[in] count The count of bins. It must not be zero.
+         * @param[in] window The window function which must be a generalized cosine window.
+         * @exception std::invalid_argument Invalid bins or window function type.
+         */
+        SlidingDft(const TFloat* bins, TIndex count, const Window<TIndex, TFloat, VN>& window) :
+            SlidingDft(bins, count, Window<TIndex, TFloat, VN>::get_cosine_sum_coefficients(window.get_window_type())) {}
+
+    private:
+        static constexpr TFloat RECTANGULAR = static_cast<TFloat>(1);
+
+        SlidingDft(const TFloat* bins, TIndex count, std::span<const TFloat> window_coeffs) :
+            bin_count(count), term_count(0), weights(), ring(N, static_cast<TFloat>(0)), offset(0), sums(), seeds() {
+            if (bins == nullptr || count == static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("sliding DFT requires at least one bin.");
+            }
+            if (window_coeffs.empty()) [[unlikely]] {
+                throw std::invalid_argument("sliding DFT only supports generalized cosine window.");
+            }
+
+            // For window a0 - a1 * cos(x) + a2 * cos(2x) - ..., the term m of window
+            // contributes (-1)^m * a_m / 2 of sums at omega - m * theta and omega + m * theta, where theta = 2pi / (N - 1).
+            const TIndex order = static_cast<TIndex>(window_coeffs.size()) - static_cast<TIndex>(1);
+            term_count = static_cast<TIndex>(2) * order + static_cast<TIndex>(1);
+            weights.resize(term_count);
+            for (TIndex m = 0; m <= order; ++m) {
+                TFloat weight = window_coeffs[m];
+                if (m != 0) weight /= static_cast<TFloat>(2);
+                if (m % static_cast<TIndex>(2) != 0) weight = -weight;
+                weights[order - m] = weights[order + m] = weight;
+            }
+
+            // Pad sums to a multiple of group with zero frequency, so that inner loop has no remainder.
+            const TIndex used = bin_count * term_count;
+            const TIndex group_count = (used + GROUP - static_cast<TIndex>(1)) / GROUP;
+            sums.resize(group_count);
+            seeds.resize(group_count * (N / RESEED));
+            for (TIndex k = 0; k < bin_count; ++k) {
+                TFloat bin = bins[k];
+                if (!std::isfinite(bin)) [[unlikely]] {
+                    throw std::invalid_argument("bin of sliding DFT must be finite.");
+                }
+                for (TIndex t = 0; t < term_count; ++t) {
+                    TFloat shift = static_cast<TFloat>(0);
+                    if (t != order) {
+                        shift = (static_cast<TFloat>(t) - static_cast<TFloat>(order)) / static_cast<TFloat>(N - static_cast<TIndex>(1));
+                    }
+                    init_sum(k * term_count + t, bin, shift);
+                }
+            }
+            for (TIndex j = used; j < group_count * GROUP; ++j) {
+                init_sum(j, static_cast<TFloat>(0), static_cast<TFloat>(0));
+            }
+            reset();
+        }
+
+        /// @brief The complex numbers of one group, stored as separated real and imaginary parts.
+        struct ComplexGroup {
+            TFloat re[GROUP];
+            TFloat im[GROUP];
+        };
+
+        /// @brief The state and constants of one group of tracked frequencies.
+        struct SumGroup {
+            /// @brief The active sum over the latest N samples.
+            ComplexGroup active;
+            /// @brief The shadow sum over the samples since the last replacement.
+            ComplexGroup shadow;
+            /// @brief The phase <TT>exp(-j * omega * offset)</TT> of next sample.
+            ComplexGroup phase;
+            /// @brief <TT>exp(-j * omega)</TT> rotating the phase for each sample.
+            ComplexGroup step;
+            /// @brief <TT>exp(-j * omega * 2)</TT> rotating the phase for every 2 samples.
+            ComplexGroup double_step;
+            /// @brief <TT>exp(j * omega * N)</TT> moving the phase back by N samples.
+            ComplexGroup back;
+        };
+
+        /**
+         * @brief Initialize the constants of one tracked frequency.
+         * @details
+         * The frequency is <TT>bin / N + shift</TT> cycles per sample.
+         * Both parts are kept separated when computing angles,
+         * so that the whole cycles are removed precisely before multiplying by 2pi.
+         * @param[in] index The index of tracked frequency.
+         * @param[in] bin The bin where tracked frequency belongs.
+         * @param[in] shift The shift from bin in cycles per sample.
+         */
+        void init_sum(TIndex index, TFloat bin, TFloat shift) {
+            SumGroup& group = sums[index / GROUP];
+            const TIndex l = index % GROUP;
+            const TFloat omega = util::tau_v<TFloat> * (bin / static_cast<TFloat>(N) + shift);
+            group.step.re[l] = std::cos(omega);
+            group.step.im[l] = -std::sin(omega);
+            group.double_step.re[l] = std::cos(static_cast<TFloat>(2) * omega);
+            group.double_step.im[l] = -std::sin(static_cast<TFloat>(2) * omega);
+            const TFloat back = util::tau_v<TFloat> * (bin - std::floor(bin) + shift * static_cast<TFloat>(N));
+            group.back.re[l] = std::cos(back);
+            group.back.im[l] = std::sin(back);
+            const TIndex group_count = static_cast<TIndex>(sums.size());
+            for (TIndex s = 0; s < N / RESEED; ++s) {
+                const TIndex time = s * RESEED;
+                const TFloat cycles = util::bin_cycles<TIndex, TFloat>(bin, time, N) + shift * static_cast<TFloat>(time);
+                const TFloat angle = util::tau_v<TFloat> * (cycles - std::floor(cycles));
+                ComplexGroup& seed = seeds[s * group_count + index / GROUP];
+                seed.re[l] = std::cos(angle);
+                seed.im[l] = -std::sin(angle);
+            }
+        }
+
+        TIndex bin_count;
+        /// @brief The count of tracked frequencies for each bin.
+        TIndex term_count;
+        /// @brief The weight of each tracked frequency applying window function.
+        std::vector<TFloat> weights;
+        /// @brief The latest N samples.
+        std::vector<TFloat> ring;
+        /**
+         * @brief The offset of next sample from the time origin, in range [0, N).
+         * @details Time origin moves every N samples, so it is also the position of next sample in ring buffer.
+         */
+        TIndex offset;
+        std::vector<SumGroup> sums;
+        /// @brief The exact phases at every RESEED samples. Phases of the same reseeding point are stored together.
+        std::vector<ComplexGroup> seeds;
+
+    public:
+        /**
+         * @brief Convert frequency into (fractional) bin.
+         * @param[in] freq The frequency in Hz.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @return The bin of given frequency.
+         */
+        static TFloat get_bin(TFloat freq, TFloat sample_rate) { return freq * static_cast<TFloat>(N) / sample_rate; }
+        /**
+         * @brief Get the count of tracked bins.
+         * @return The count of bins.
+         */
+        TIndex get_bin_count() const { return bin_count; }
+
+        /**
+         * @brief Push one sample into sliding window.
+         * @param[in] sample The new sample.
+         */
+        void push(TFloat sample) { push(&sample, static_cast<TIndex>(1)); }
+
+        /**
+         * @brief Push samples into sliding window.
+         * @details
+         * Pushing samples in bulk is faster than pushing them one by one,
+         * because the sums are kept in registers across samples.
+         * @param[in] samples The samples in time order.
+         * @param[in] count The count of samples.
+         */
+        void push(const TFloat* samples, TIndex count) {
+            if (samples == nullptr && count != static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for sliding DFT pushing.");
+            }
+
+            while (count != static_cast<TIndex>(0)) {
+                // Split samples at reseeding points, which include the end of ring buffer.
+                const TIndex run = std::min(count, RESEED - offset % RESEED);
+                push_run(samples, run);
+                samples += run;
+                count -= run;
+            }
+        }
+
+        /**
+         * @brief Get the complex spectrum of the latest N samples.
+         * @details
+         * The result of integral bin is the same one produced by RealFft::compute() on the latest N samples multiplied by window.
+         * @param[out] spectrum The complex spectrum of each bin, whose length is the count of bins.
+         */
+        void get_spectrum(TComplex* spectrum) const {
+            if (spectrum == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for sliding DFT reading.");
+            }
+
+            for (TIndex k = 0; k < bin_count; ++k) {
+                spectrum[k] = get_bin_spectrum(k);
+            }
+        }
+
+        /**
+         * @brief Get the power (squared magnitude) of the latest N samples.
+         * @param[out] power The power of each bin, whose length is the count of bins.
+         */
+        void get_power(TFloat* power) const {
+            if (power == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for sliding DFT reading.");
+            }
+
+            for (TIndex k = 0; k < bin_count; ++k) {
+                const TComplex value = get_bin_spectrum(k);
+                power[k] = value.real() * value.real() + value.imag() * value.imag();
+            }
+        }
+
+        /**
+         * @brief Drop all pushed samples, as if nothing has been pushed.
+         */
+        void reset() {
+            std::fill(ring.begin(), ring.end(), static_cast<TFloat>(0));
+            offset = static_cast<TIndex>(0);
+            for (SumGroup& group : sums) {
+                TPack::store(group.active.re, TPack::zero());
+                TPack::store(group.active.im, TPack::zero());
+                TPack::store(group.shadow.re, TPack::zero());
+                TPack::store(group.shadow.im, TPack::zero());
+            }
+            reseed();
+        }
+
+    private:
+        /**
+         * @brief Push samples which do not cross reseeding point.
+         */
+        void push_run(const TFloat* samples, TIndex run) {
+            // The removed samples are continuous in ring buffer, because run does not cross the end of it.
+            const TFloat* removed = ring.data() + offset;
+            for (SumGroup& group : sums) {
+                TReg active_re = TPack::load(group.active.re), active_im = TPack::load(group.active.im);
+                TReg shadow_re = TPack::load(group.shadow.re), shadow_im = TPack::load(group.shadow.im);
+                const TReg back_re = TPack::load(group.back.re), back_im = TPack::load(group.back.im);
+                const TReg step_re = TPack::load(group.step.re), step_im = TPack::load(group.step.im);
+                const TReg double_re = TPack::load(group.double_step.re), double_im = TPack::load(group.double_step.im);
+                // Even and odd samples are rotated by independent phases, halving the dependency chain of rotation.
+                TReg even_re = TPack::load(group.phase.re), even_im = TPack::load(group.phase.im);
+                TReg odd_re, odd_im;
+                complex_mul(even_re, even_im, step_re, step_im, odd_re, odd_im);
+
+                TIndex i = 0;
+                for (; i + static_cast<TIndex>(1) < run; i += static_cast<TIndex>(2)) {
+                    TReg even_shadow_re, even_shadow_im, even_active_re, even_active_im;
+                    accumulate(samples[i], removed[i], even_re, even_im, back_re, back_im, even_shadow_re, even_shadow_im, even_active_re, even_active_im);
+                    TReg odd_shadow_re, odd_shadow_im, odd_active_re, odd_active_im;
+                    accumulate(samples[i + 1], removed[i + 1], odd_re, odd_im, back_re, back_im, odd_shadow_re, odd_shadow_im, odd_active_re, odd_active_im);
+                    shadow_re = TPack::add(shadow_re, TPack::add(even_shadow_re, odd_shadow_re));
+                    shadow_im = TPack::add(shadow_im, TPack::add(even_shadow_im, odd_shadow_im));
+                    active_re = TPack::add(active_re, TPack::add(even_active_re, odd_active_re));
+                    active_im = TPack::add(active_im, TPack::add(even_active_im, odd_active_im));
+                    complex_mul(even_re, even_im, double_re, double_im, even_re, even_im);
+                    complex_mul(odd_re, odd_im, double_re, double_im, odd_re, odd_im);
+                }
+                if (i < run) {
+                    TReg last_shadow_re, last_shadow_im, last_active_re, last_active_im;
+                    accumulate(samples[i], removed[i], even_re, even_im, back_re, back_im, last_shadow_re, last_shadow_im, last_active_re, last_active_im);
+                    shadow_re = TPack::add(shadow_re, last_shadow_re);
+                    shadow_im = TPack::add(shadow_im, last_shadow_im);
+                    active_re = TPack::add(active_re, last_active_re);
+                    active_im = TPack::add(active_im, last_active_im);
+                    even_re = odd_re;
+                    even_im = odd_im;
+                }
+
+                TPack::store(group.active.re, active_re);
+                TPack::store(group.active.im, active_im);
+                TPack::store(group.shadow.re, shadow_re);
+                TPack::store(group.shadow.im, shadow_im);
+                TPack::store(group.phase.re, even_re);
+                TPack::store(group.phase.im, even_im);
+            }
+            std::copy_n(samples, run, ring.data() + offset);
+
+            offset += run;
+            if (offset == N) {
+                // Shadow sum covers exactly the latest N samples now.
+                // Replace active sum by it, and move time origin to next sample.
+                offset = static_cast<TIndex>(0);
+                for (SumGroup& group : sums) {
+                    const TReg shadow_re = TPack::load(group.shadow.re), shadow_im = TPack::load(group.shadow.im);
+                    const TReg back_re = TPack::load(group.back.re), back_im = TPack::load(group.back.im);
+                    TReg active_re, active_im;
+                    complex_mul(shadow_re, shadow_im, back_re, back_im, active_re, active_im);
+                    TPack::store(group.active.re, active_re);
+                    TPack::store(group.active.im, active_im);
+                    TPack::store(group.shadow.re, TPack::zero());
+                    TPack::store(group.shadow.im, TPack::zero());
+                }
+            }
+            if (offset % RESEED == static_cast<TIndex>(0)) reseed();
+        }
+
+        /**
+         * @brief Multiply complex packs.
+         */
+        static void complex_mul(TReg a_re, TReg a_im, TReg b_re, TReg b_im, TReg& out_re, TReg& out_im) {
+            const TReg re = TPack::sub(TPack::mul(a_re, b_re), TPack::mul(a_im, b_im));
+            out_im = TPack::add(TPack::mul(a_re, b_im), TPack::mul(a_im, b_re));
+            out_re = re;
+        }
+
+        /**
+         * @brief Compute the contributions of one sample to shadow sum and active sum.
+         * @details
+         * The new sample contributes <TT>x * phase</TT>.
+         * The removed sample is N samples before, whose phase is <TT>phase * back</TT>,
+         * so that the change of active sum is <TT>phase * (x - removed * back)</TT>.
+         */
+        static void accumulate(TFloat x, TFloat removed, TReg phase_re, TReg phase_im, TReg back_re, TReg back_im,
+                               TReg& shadow_re, TReg& shadow_im, TReg& active_re, TReg& active_im) {
+            const TReg new_x = TPack::broadcast(x), old_x = TPack::broadcast(removed);
+            shadow_re = TPack::mul(new_x, phase_re);
+            shadow_im = TPack::mul(new_x, phase_im);
+            const TReg delta_re = TPack::sub(new_x, TPack::mul(old_x, back_re)), delta_im = TPack::sub(TPack::zero(), TPack::mul(old_x, back_im));
+            complex_mul(phase_re, phase_im, delta_re, delta_im, active_re, active_im);
+        }
+
+        /**
+         * @brief Replace the rotated phases by exact ones for current offset.
+         */
+        void reseed() {
+            const ComplexGroup* seed = seeds.data() + (offset / RESEED) * static_cast<TIndex>(sums.size());
+            for (SumGroup& group : sums) {
+                group.phase = *seed++;
+            }
+        }
+
+        /**
+         * @brief Combine tracked sums of given bin into its windowed spectrum.
+         */
+        TComplex get_bin_spectrum(TIndex k) const {
+            TFloat re = static_cast<TFloat>(0), im = static_cast<TFloat>(0);
+            for (TIndex t = 0; t < term_count; ++t) {
+                const TIndex j = k * term_count + t;
+                const SumGroup& group = sums[j / GROUP];
+                const TIndex l = j % GROUP;
+                // The first sample of window is N samples before next sample, whose phase is phase * exp(j * omega * N).
+                // Sum is divided by it, i.e. multiplied by its conjugate.
+                const TFloat pr = group.phase.re[l], pi = group.phase.im[l];
+                const TFloat br = group.back.re[l], bi = group.back.im[l];
+                const TFloat fr = pr * br - pi * bi, fi = -(pr * bi + pi * br);
+                const TFloat ar = group.active.re[l], ai = group.active.im[l];
+                re += weights[t] * (ar * fr - ai * fi);
+                im += weights[t] * (ar * fi + ai * fr);
+            }
+            return TComplex(re, im);
+        }
+    };
+
+#pragma endregion
+
+#pragma region Chirp-Z Transform
+
+    /**
+     * @brief Chirp-Z transform (zoom FFT) evaluating evenly spaced bins across an arbitrary band.
+     * @details
+     * This class evaluates the DFT of N samples at M bins from \c first_bin to \c last_bin (both inclusive),
+     * whose spacing can be much finer than one bin of N-point FFT.
+     * It is equivalent to zero-padding data into a huge FFT and keeping a narrow band,
+     * but only costs two FFTs whose point is the smallest power of 2 not less than <TT>N + M - 1</TT>.
+     *
+     * It uses Bluestein's algorithm, which turns the transform into a circular convolution with a chirp:
+     * <TT>X[m] = c(m) * sum(x[n] * a(n) * c(n) * conj(c(m - n)))</TT> where <TT>c(k) = exp(-j * pi * step * k^2 / N)</TT>.
+     * The chirp tables and the spectrum of convolution kernel are computed once in constructor for given band,
+     * and FFT plans are shared by FftPlanCache.
+     * So computing only costs two FFTs and three item-by-item multiplications.
+     *
+     * The chirp tables are computed in \c double for \c float instance, because the phase grows with the square of index.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam N The length of time scope data which must be a power of 2.
+     * @warning This class is \b NOT thread safe, because it owns the work buffer. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VN>
+        requires util::validate_args_v<TIndex, TFloat, VN>
+    class ChirpZ {
+    private:
+        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TComplex = TProperties::TComplex;
+        static constexpr TIndex N = TProperties::N;
+        using TPlanCache = FftPlanCache<TIndex, TFloat>;
+        /// @brief The float point type computing chirp tables.
+        using TWide = std::conditional_t<std::is_same_v<TFloat, float>, double, TFloat>;
+
+    public:
+        /**
+         * @brief Construct Chirp-Z transform for given band.
+         * @param[in] first_bin The first evaluated bin. Frequency of bin \c k is <TT>k * sample_rate / N</TT>.
+         * @param[in] last_bin The last evaluated bin. It can be less than \p first_bin for descending order.
+         * @param[in] count The count of evaluated bins. It must not be zero. If it is 1, only \p first_bin is evaluated.
+         * @exception std::invalid_argument Invalid band or count.
+         */
+        ChirpZ(TFloat first_bin, TFloat last_bin, TIndex count) :
+            first_bin(first_bin), bin_step(0), bin_count(count), fft_size(0), forward_plan(), backward_plan(), pre_chirp(N), post_chirp(count),
+            kernel(), work() {
+            if (count == static_cast<TIndex>(0)) [[unlikely]] {
+                throw std::invalid_argument("Chirp-Z transform requires at least one bin.");
+            }
+            if (!std::isfinite(first_bin) || !std::isfinite(last_bin)) [[unlikely]] {
+                throw std::invalid_argument("band of Chirp-Z transform must be finite.");
+            }
+
+            if (count > static_cast<TIndex>(1)) bin_step = (last_bin - first_bin) / static_cast<TFloat>(count - static_cast<TIndex>(1));
+            fft_size = std::bit_ceil<TIndex>(std::max(N + count - static_cast<TIndex>(1), static_cast<TIndex>(2)));
+            forward_plan = TPlanCache::get(fft_size, FftDirection::Forward);
+            backward_plan = TPlanCache::get(fft_size, FftDirection::Backward);
+            kernel.resize(fft_size, TComplex(0));
+            work.resize(fft_size);
+
+            // a(n) * c(n), where a(n) = exp(-j * 2pi * first_bin * n / N) moves the band to start from 0.
+            for (TIndex n = 0; n < N; ++n) {
+                TWide cycles = util::bin_cycles<TIndex, TWide>(static_cast<TWide>(first_bin), n, N) + chirp_cycles(n);
+                pre_chirp[n] = unit_phasor(-cycles);
+            }
+            // c(m), with the normalization of inverse FFT folded in.
+            const TWide normalization = static_cast<TWide>(1) / static_cast<TWide>(fft_size);
+            for (TIndex m = 0; m < count; ++m) {
+                TComplex value = unit_phasor(-chirp_cycles(m));
+                post_chirp[m] = TComplex(value.real() * static_cast<TFloat>(normalization), value.imag() * static_cast<TFloat>(normalization));
+            }
+            // conj(c(k)) for k in (-N, M), placed circularly, then transformed into spectrum.
+            for (TIndex k = 0; k < count; ++k) {
+                kernel[k] = unit_phasor(chirp_cycles(k));
+            }
+            for (TIndex k = 1; k < N; ++k) {
+                kernel[fft_size - k] = unit_phasor(chirp_cycles(k));
+            }
+            forward_plan->compute(kernel.data());
+        }
+
+    private:
+        TFloat first_bin;
+        /// @brief The distance between adjacent evaluated bins.
+        TFloat bin_step;
+        TIndex bin_count;
+        /// @brief The point of underlying FFT.
+        TIndex fft_size;
+        TPlanCache::TPlanPtr forward_plan;
+        TPlanCache::TPlanPtr backward_plan;
+        /// @brief The chirp multiplied with data, whose length is N.
+        std::vector<TComplex> pre_chirp;
+        /// @brief The chirp multiplied with result, whose length is the count of bins.
+        std::vector<TComplex> post_chirp;
+        /// @brief The spectrum of convolution kernel, whose length is the point of underlying FFT.
+        std::vector<TComplex> kernel;
+        /// @brief The work buffer of convolution, whose length is the point of underlying FFT.
+        std::vector<TComplex> work;
+
+        /**
+         * @brief Compute the phase of chirp <TT>step * k^2 / (2 * N)</TT> in cycles precisely.
+         */
+        TWide chirp_cycles(TIndex k) const {
+            // k^2 is computed in 64-bit, and bin_cycles() reduces its product with the integral part of step exactly.
+            const std::uint64_t square = static_cast<std::uint64_t>(k) * static_cast<std::uint64_t>(k);
+            return util::bin_cycles<std::uint64_t, TWide>(static_cast<TWide>(bin_step), square, static_cast<std::uint64_t>(N) * 2u);
+        }
+        /**
+         * @brief Compute <TT>exp(j * 2pi * cycles)</TT>.
+         */
+        static TComplex unit_phasor(TWide cycles) {
+            const TWide angle = util::tau_v<TWide> * cycles;
+            return TComplex(static_cast<TFloat>(std::cos(angle)), static_cast<TFloat>(std::sin(angle)));
+        }
+
+    public:
+        /**
+         * @brief Convert frequency into (fractional) bin.
+         * @param[in] freq The frequency in Hz.
+         * @param[in] sample_rate The sample rate of input stream in Hz.
+         * @return The bin of given frequency.
+         */
+        static TFloat get_bin(TFloat freq, TFloat sample_rate) { return freq * static_cast<TFloat>(N) / sample_rate; }
+        /**
+         * @brief Get the count of evaluated bins.
+         * @return The count of bins.
+         */
+        TIndex get_bin_count() const { return bin_count; }
+        /**
+         * @brief Get the distance between adjacent evaluated bins.
+         * @return The distance in bins of N-point FFT.
+         */
+        TFloat get_bin_step() const { return bin_step; }
+        /**
+         * @brief Get the point of underlying FFT.
+         * @return The point of FFT, which is the smallest power of 2 not less than <TT>N + M - 1</TT>.
+         */
+        TIndex get_fft_size() const { return fft_size; }
+
+        /**
+         * @brief Compute the spectrum of given band for complex sequence.
+         * @param[in] time_scope The complex sequence with length N.
+         * @param[out] spectrum The complex spectrum of each evaluated bin, whose length is the count of bins.
+         */
+        void compute(const TComplex* time_scope, TComplex* spectrum) {
+            if (time_scope == nullptr || spectrum == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for Chirp-Z transform computing.");
+            }
+
+            util::spectrum_multiply<TIndex, TFloat>(work.data(), time_scope, pre_chirp.data(), N);
+            convolve(spectrum);
+        }
+
+        /**
+         * @brief Compute the spectrum of given band for real-number sequence with window function applied.
+         * @param[in] time_scope The length of this data must be N.
+         * The first data should be the oldest data and the last data should be the newest data.
+         * @param[out] spectrum The complex spectrum of each evaluated bin, whose length is the count of bins.
+         * @param[in] window The window instance applied to data.
+         */
+        void compute(const TFloat* time_scope, TComplex* spectrum, const Window<TIndex, TFloat, N>& window) {
+            if (time_scope == nullptr || spectrum == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for Chirp-Z transform computing.");
+            }
+
+            util::window_multiply<false, TIndex, TFloat>(time_scope, window.get_window_data(), work.data(), N);
+            util::spectrum_multiply<TIndex, TFloat>(work.data(), work.data(), pre_chirp.data(), N);
+            convolve(spectrum);
+        }
+
+    private:
+        /**
+         * @brief Convolve the pre-chirped data in work buffer with kernel, and write post-chirped result.
+         */
+        void convolve(TComplex* spectrum) {
+            std::fill(work.begin() + N, work.end(), TComplex(0));
+            forward_plan->compute(work.data());
+            util::spectrum_multiply<TIndex, TFloat>(work.data(), work.data(), kernel.data(), fft_size);
+            backward_plan->compute(work.data());
+            util::spectrum_multiply<TIndex, TFloat>(spectrum, work.data(), post_chirp.data(), bin_count);
+        }
+    };
+
+#pragma endregion
+
+#pragma region Convolution
+
+    /// @brief The method of block convolution.
+    enum class ConvolutionMethod {
+        OverlapAdd,  ///< Zero-pad each input block, and add the tail of result to next output block.
+        OverlapSave, ///< Transform each input block with previous block, and discard the circular aliased half of result.
+    };
+
+    /// @brief The kind of operation computed by Convolver.
+    enum class ConvolutionKind {
+        Convolution, ///< Convolve input stream with given impulse response.
+        Correlation, ///< Cross-correlate input stream with given pattern.
+    };
+
+    /**
+     * @brief FFT based streaming convolution and correlation engine.
+     * @details
+     * This class convolves a stream of real-number samples with a fixed impulse response block by block.
+     * Each block has VBlock samples and the underlying real FFT has 2 * VBlock points.
+     *
+     * If the impulse response is longer than the block size,
+     * it is uniformly partitioned into blocks, and their spectra are multiplied with a frequency-domain delay line
+     * holding the spectra of recent input blocks.
+     * So that each block only costs one forward and one inverse FFT no matter how long the impulse response is.
+     *
+     * All buffers are allocated in constructor.
+     * Processing blocks never allocates memory.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam VBlock The count of samples in each block which must be a power of 2 and >= 2.
+     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat, TIndex VBlock>
+        requires util::validate_args_v<TIndex, TFloat, VBlock>
+    class Convolver {
+    private:
+        using TComplex = std::complex<TFloat>;
+        static constexpr TIndex BLOCK = VBlock;
+        static constexpr TIndex N = BLOCK << static_cast<TIndex>(1);
+        static constexpr TIndex BINS = BLOCK + static_cast<TIndex>(1);
+        using UnderlyingFft = RealFft<TIndex, TFloat, N>;
+
+    public:
+        /**
+         * @brief Construct convolver with given impulse response.
+         * @param[in] impulse
+         * The impulse response for convolution,
+         * or the pattern for correlation.
+         * @param[in] impulse_len The length of \p impulse. It must be greater than zero.
+         * @param[in] method The method of block convolution.
+         * @param[in] kind
+         * The kind of computation.
+         * For correlation, the n-th output is the correlation between the pattern and the input window ending at n-th input,
+         * which is equal to convolve with reversed pattern.
+         * @exception std::invalid_argument Invalid impulse response.
+         */
+        Convolver(const TFloat* impulse,
+                  TIndex impulse_len,
+                  ConvolutionMethod method = ConvolutionMethod::OverlapSave,
+                  ConvolutionKind kind = ConvolutionKind::Convolution) :
+            fft(), method(method), partitions(0), fdl_head(0), filter_spectra(), fdl(), work(BINS), history(BLOCK) {
+            if (impulse == nullptr || impulse_len == static_cast<TIndex>(0)) {
+                throw std::invalid_argument("impulse response of convolver must not be empty.");
+            }
+
+            // Allocate partitions
+            partitions = (impulse_len + BLOCK - static_cast<TIndex>(1)) / BLOCK;
+            filter_spectra.resize(partitions * BINS);
+            fdl.resize(partitions * BINS);
+
+            // Compute the spectrum of each partition.
+            // The scale of inverse transform is folded into them, so that we can skip normalization when processing.
+            const TFloat scale = static_cast<TFloat>(1) / static_cast<TFloat>(N);
+            for (TIndex p = static_cast<TIndex>(0); p < partitions; ++p) {
+                TComplex* spectrum = filter_spectra.data() + p * BINS;
+                TFloat* time = reinterpret_cast<TFloat*>(spectrum);
+                std::fill_n(time, N, static_cast<TFloat>(0));
+                for (TIndex i = static_cast<TIndex>(0); i < BLOCK; ++i) {
+                    TIndex index = p * BLOCK + i;
+                    if (index >= impulse_len) break;
+                    time[i] = kind == ConvolutionKind::Convolution ? impulse[index]
+                                                                   : impulse[impulse_len - static_cast<TIndex>(1) - index];
+                }
+                fft.compute(spectrum);
+                for (TIndex i = static_cast<TIndex>(0); i < BINS; ++i) {
+                    spectrum[i] *= scale;
+                }
+            }
+        }
+
+    private:
+        UnderlyingFft fft;
+        ConvolutionMethod method;
+        /// @brief The count of impulse response partitions.
+        TIndex partitions;
+        /// @brief The slot index of the newest input spectrum in frequency-domain delay line.
+        TIndex fdl_head;
+        /// @brief The spectra of impulse response partitions.
+        std::vector<TComplex> filter_spectra;
+        /// @brief Frequency-domain delay line. The slot (fdl_head + p) % partitions holds the spectrum of p-th previous block.
+        std::vector<TComplex> fdl;
+        /// @brief The buffer for accumulating spectrum and inverse transform.
+        std::vector<TComplex> work;
+        /// @brief The previous input block for overlap-save, or the tail of previous result for overlap-add.
+        std::vector<TFloat> history;
+
+    public:
+        /**
+         * @brief Get the count of samples in each block.
+         * @return The block size.
+         */
+        TIndex get_block_size() const { return BLOCK; }
+        /**
+         * @brief Get the count of impulse response partitions.
+         * @return The partition count. It is 1 if impulse response is not longer than block size.
+         */
+        TIndex get_partition_count() const { return partitions; }
+
+        /**
+         * @brief Process one block of samples.
+         * @param[in] input The input samples with length of block size.
+         * @param[out] output The output samples with length of block size. It can be the same one with \p input.
+         */
+        void process(const TFloat* input, TFloat* output) {
+            if (input == nullptr || output == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for convolution.");
+            }
 
-        // NOTE:
-        // We use std::has_single_bit() to check whether given number is an integral power of 2.
-        // And use (std::bit_width() - 1) to get the exponent of given number based on 2.
+            // Transform new block directly into the oldest slot of delay line.
+            fdl_head = (fdl_head + partitions - static_cast<TIndex>(1)) % partitions;
+            TComplex* newest = fdl.data() + fdl_head * BINS;
+            TFloat* time = reinterpret_cast<TFloat*>(newest);
+            if (method == ConvolutionMethod::OverlapSave) {
+                std::copy_n(history.data(), BLOCK, time);
+                std::copy_n(input, BLOCK, time + BLOCK);
+                std::copy_n(input, BLOCK, history.data());
+            } else {
+                std::copy_n(input, BLOCK, time);
+                std::fill_n(time + BLOCK, BLOCK, static_cast<TFloat>(0));
+            }
+            fft.compute(newest);
 
-        template<typename TIndex, typename TFloat, TIndex VN>
-        struct validate_args {
-        private:
-            static constexpr bool is_unsigned_int = std::is_unsigned_v<TIndex> && std::is_integral_v<TIndex>;
-            static constexpr bool is_float_point = std::is_floating_point_v<TFloat>;
-            static constexpr bool n_is_pow_2 = std::has_single_bit<TIndex>(static_cast<TIndex>(VN)) && VN >= static_cast<TIndex>(2);
+            // Multiply and accumulate with all partitions.
+            util::spectrum_multiply<TIndex, TFloat>(work.data(), newest, filter_spectra.data(), BINS);
+            for (TIndex p = static_cast<TIndex>(1); p < partitions; ++p) {
+                const TComplex* previous = fdl.data() + ((fdl_head + p) % partitions) * BINS;
+                util::spectrum_multiply_add<TIndex, TFloat>(work.data(), previous, filter_spectra.data() + p * BINS, BINS);
+            }
 
-        public:
-            static constexpr bool value = is_unsigned_int && is_float_point && n_is_pow_2;
-        };
+            // Inverse transform. The scale has been folded into filter spectra.
+            fft.compute_inverse(work.data(), FftNormalization::None);
+            const TFloat* result = reinterpret_cast<const TFloat*>(work.data());
+            if (method == ConvolutionMethod::OverlapSave) {
+                // The first half is circular aliased.
+                std::copy_n(result + BLOCK, BLOCK, output);
+            } else {
+                for (TIndex i = static_cast<TIndex>(0); i < BLOCK; ++i) {
+                    output[i] = result[i] + history[i];
+                }
+                std::copy_n(result + BLOCK, BLOCK, history.data());
+            }
+        }
 
-        template<typename TIndex, typename TFloat, TIndex VN>
-        inline constexpr bool validate_args_v = validate_args<TIndex, TFloat, VN>::value;
+        /**
+         * @brief Reset the state of stream, as if no block has been processed.
+         */
+        void reset() {
+            fdl_head = static_cast<TIndex>(0);
+            std::fill(fdl.begin(), fdl.end(), TComplex());
+            std::fill(history.begin(), history.end(), static_cast<TFloat>(0));
+        }
+    };
 
-    } // namespace util
+#pragma endregion
 
-#pragma region Window
+#pragma region Four-Step FFT
 
-    enum class WindowType { HanningWindow };
+    /**
+     * @brief Multi-threaded four-step FFT for very large point.
+     * @details
+     * N is split into N1 * N2 where N1 = 2^floor(M / 2) and N2 = N / N1,
+     * and the sequence is viewed as N1 rows and N2 columns (row-major).
+     * The computation is:
+     * \li N2 column FFTs with N1 points. Columns are grouped into chunks, gathered into continuous buffer
+     * and computed by batched FFT, so that each chunk fits in cache and whole sequence is never transposed here.
+     * \li Multiply item (k1, n2) by twiddle factor W(N)^(k1 * n2) while moving rows into scratch buffer, fused with next step.
+     * \li N1 row FFTs with N2 points, which are continuous in memory.
+     * \li Cache blocked transpose from scratch buffer (N1 * N2) back into the sequence (N2 * N1), which produces natural order result.
+     *
+     * Every step is split into independent tasks and executed by given FftThreadPool.
+     * Sub-plans are fetched from FftPlanCache, and twiddle factors are stored in two tables with about sqrt(N) items.
+     * @tparam TIndex The index type used by FFT which must be an unsigned integral type.
+     * @tparam TFloat The float point type used by FFT.
+     * @warning This class is \b NOT thread safe, because it owns the scratch buffer for transpose.
+     * Please use different instance in different thread.
+     */
+    template<typename TIndex, typename TFloat>
+        requires util::validate_plan_args_v<TIndex, TFloat>
+    class FourStepFft {
+    public:
+        using TComplex = std::complex<TFloat>;
 
-    template<typename TIndex, typename TFloat, TIndex VN>
-        requires util::validate_args_v<TIndex, TFloat, VN>
-    class Window {
     private:
-        static constexpr TIndex N = VN;
+        using TPlanCache = FftPlanCache<TIndex, TFloat>;
+        /// @brief The count of columns computed by one batched FFT task.
+        static constexpr TIndex COLUMN_CHUNK = 64u;
+        /// @brief The side length of square tile in transpose.
+        static constexpr TIndex TRANSPOSE_TILE = 32u;
 
     public:
-        Window(WindowType win_type) : window_type(win_type), window_data(nullptr) {
-            // Pre-compute window data
-            // Allocate window buffer
-            window_data = std::make_unique<TFloat[]>(N);
-            // Assign window data
-            switch (win_type) {
-                case WindowType::HanningWindow:
-                    for (TIndex i = 0u; i < N; ++i) {
-                        window_data[i] = static_cast<TFloat>(0.5)
-                                         * (static_cast<TFloat>(1)
-                                            - std::cos(util::tau_v<TFloat>
-                                                       * static_cast<TFloat>(i) / static_cast<TFloat>(N - static_cast<TIndex>(1))));
-                    }
-                    break;
-                default:
-                    throw std::invalid_argument("invalid window function type");
+        /**
+         * @brief Build four-step FFT for given point and direction.
+         * @param[in] n The point of FFT which must be a power of 2 and >= 4.
+         * @param[in] direction The direction of FFT. Backward transform is not normalized like FftPlan.
+         * @exception std::invalid_argument Given point is not a power of 2 or less than 4.
+         */
+        FourStepFft(TIndex n, FftDirection direction = FftDirection::Forward) :
+            n(n), n1(0), n2(0), fine_bits(0), direction(direction), column_plan(), row_plan(), coarse_twiddles(), fine_twiddles(),
+            scratch() {
+            if (!std::has_single_bit<TIndex>(n) || n < static_cast<TIndex>(4)) {
+                throw std::invalid_argument("the point of four-step FFT must be a power of 2 and >= 4");
             }
+
+            const unsigned m = static_cast<unsigned>(std::bit_width<TIndex>(n) - 1);
+            n1 = static_cast<TIndex>(1) << (m / 2u);
+            n2 = n / n1;
+            column_plan = TPlanCache::get(n1, direction);
+            row_plan = TPlanCache::get(n2, direction);
+
+            // W(N)^e = W(N)^((e >> B) << B) * W(N)^(e & (2^B - 1)) where e < N.
+            fine_bits = (m + 1u) / 2u;
+            const TIndex fine_count = static_cast<TIndex>(1) << fine_bits;
+            const TIndex coarse_count = n >> fine_bits;
+            auto wnp = [n, direction](TIndex p) -> TComplex {
+                TFloat angle = util::tau_v<TFloat> * static_cast<TFloat>(p) / static_cast<TFloat>(n);
+                return TComplex(std::cos(angle), direction == FftDirection::Backward ? std::sin(angle) : -std::sin(angle));
+            };
+            coarse_twiddles.resize(coarse_count);
+            for (TIndex i = 0; i < coarse_count; ++i) {
+                coarse_twiddles[i] = wnp(i << fine_bits);
+            }
+            fine_twiddles.resize(fine_count);
+            for (TIndex i = 0; i < fine_count; ++i) {
+                fine_twiddles[i] = wnp(i);
+            }
+
+            scratch.resize(n);
         }
 
     private:
-        WindowType window_type;
-        std::unique_ptr<TFloat[]> window_data;
+        TIndex n;
+        /// @brief The count of rows, which is also the point of column FFT.
+        TIndex n1;
+        /// @brief The count of columns, which is also the point of row FFT.
+        TIndex n2;
+        /// @brief The bit count of index into fine twiddle table.
+        unsigned fine_bits;
+        FftDirection direction;
+        TPlanCache::TPlanPtr column_plan;
+        TPlanCache::TPlanPtr row_plan;
+        std::vector<TComplex> coarse_twiddles;
+        std::vector<TComplex> fine_twiddles;
+        /// @brief The buffer holding rows between twiddle multiplication and transpose.
+        std::vector<TComplex> scratch;
 
     public:
         /**
-		 * @brief Apply window function to given data sequence.
-		 * @param[in,out] data 
-		 * The float-point data sequence for applying window function.
-		 * The length of this sequence must be N.
-		*/
-        void apply_window(TFloat* data) const {
+         * @brief Get the point of this FFT.
+         * @return The point of FFT.
+         */
+        TIndex get_size() const { return n; }
+        /**
+         * @brief Get the direction of this FFT.
+         * @return The direction of FFT.
+         */
+        FftDirection get_direction() const { return direction; }
+
+        /**
+         * @brief Compute FFT for given complex sequence in place.
+         * @param[in,out] data
+         * The complex sequence for computing.
+         * The length of this sequence must be the point of this FFT.
+         * @param[in] pool The thread pool executing sub-transforms.
+         */
+        void compute(TComplex* data, FftThreadPool& pool) {
             if (data == nullptr) [[unlikely]] {
-                throw std::invalid_argument("nullptr data is not allowed for applying window.");
-            }
-            for (TIndex i = static_cast<TIndex>(0); i < N; ++i) {
-                data[i] *= window_data[i];
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
             }
+
+            // Column FFTs by batched FFT on chunks of columns.
+            // Each chunk is gathered into continuous buffer owned by executing thread first,
+            // because the distance of rows is a large power of 2 which causes cache set conflicts.
+            const TIndex chunk = std::min(COLUMN_CHUNK, n2);
+            pool.parallel_for(static_cast<size_t>(n2 / chunk), [this, data, chunk](size_t i) {
+                TComplex* columns = data + static_cast<TIndex>(i) * chunk;
+                TComplex* buffer = util::thread_scratch<TFloat>(static_cast<size_t>(n1 * chunk));
+                for (TIndex r = 0; r < n1; ++r) {
+                    std::copy_n(columns + r * n2, chunk, buffer + r * chunk);
+                }
+                column_plan->compute_batch(buffer, chunk, chunk);
+                for (TIndex r = 0; r < n1; ++r) {
+                    std::copy_n(buffer + r * chunk, chunk, columns + r * n2);
+                }
+            });
+
+            // Twiddle multiplication and row FFTs.
+            // Twiddle multiplication moves each row into scratch, so that transpose can write into data directly.
+            TComplex* rows = scratch.data();
+            pool.parallel_for(static_cast<size_t>(n1), [this, data, rows](size_t i) {
+                const TIndex k1 = static_cast<TIndex>(i);
+                TComplex* row = rows + k1 * n2;
+                multiply_row_twiddles(data + k1 * n2, row, k1);
+                row_plan->compute(row);
+            });
+
+            // Transpose from scratch back into data by tiles.
+            // Each task transposes a band of TRANSPOSE_TILE rows.
+            const TIndex tile = std::min(TRANSPOSE_TILE, n1);
+            pool.parallel_for(static_cast<size_t>(n1 / tile), [this, data, rows, tile](size_t i) {
+                const TIndex r0 = static_cast<TIndex>(i) * tile;
+                for (TIndex c0 = 0; c0 < n2; c0 += tile) {
+                    for (TIndex c = c0; c < c0 + tile; ++c) {
+                        for (TIndex r = r0; r < r0 + tile; ++r) {
+                            data[c * n1 + r] = rows[r * n2 + c];
+                        }
+                    }
+                }
+            });
         }
+
+    private:
         /**
-		 * @brief Get underlying window function data for custom applying.
-		 * @return 
-		 * The pointer to the start address of underlying window function data sequence.
-		 * The length of this sequence is N.
-		*/
-        const TFloat* get_window_data() const { return window_data.get(); }
+         * @brief Multiply the row k1 by twiddle factors W(N)^(k1 * n2) while copying it.
+         * @details
+         * The arithmetic is written in real and imaginary parts explicitly,
+         * because std::complex multiplication is not cheap without fast-math.
+         * @param[in] src The row k1 with length N2.
+         * @param[out] row The buffer receiving multiplied row. It must not overlap with \p src.
+         * @param[in] k1 The index of row.
+         */
+        void multiply_row_twiddles(const TComplex* src, TComplex* row, TIndex k1) const {
+            if (k1 == static_cast<TIndex>(0)) {
+                std::copy_n(src, n2, row);
+                return;
+            }
+            row[0] = src[0];
+            const TIndex fine_mask = (static_cast<TIndex>(1) << fine_bits) - static_cast<TIndex>(1);
+            for (TIndex j = static_cast<TIndex>(1); j < n2; ++j) {
+                // k1 < N1 and j < N2, so that the exponent is always less than N.
+                const TIndex e = k1 * j;
+                const TComplex& wc = coarse_twiddles[e >> fine_bits];
+                const TComplex& wf = fine_twiddles[e & fine_mask];
+                const TFloat w_re = wc.real() * wf.real() - wc.imag() * wf.imag();
+                const TFloat w_im = wc.real() * wf.imag() + wc.imag() * wf.real();
+                const TComplex v = src[j];
+                row[j] = TComplex(v.real() * w_re - v.imag() * w_im, v.real() * w_im + v.imag() * w_re);
+            }
+        }
     };
 
 #pragma endregion
 
-#pragma region FFT
+#pragma region 2-D FFT
 
-    template<typename TIndex, typename TFloat, TIndex VN>
-        requires util::validate_args_v<TIndex, TFloat, VN>
-    struct FftProperties {
+    /**
+     * @brief 2-D FFT for row-major matrix whose size is decided at compile time.
+     * @details
+     * The matrix has \c VRows rows and \c VCols columns, and item (r, c) is located at <TT>data[r * VCols + c]</TT>.
+     * The computation is:
+     * \li \c VRows row FFTs with \c VCols points, which are continuous in memory.
+     * \li \c VCols column FFTs with \c VRows points. Columns are processed in bands.
+     * Each band is gathered row by row into the buffer owned by executing thread,
+     * computed by batched FFT where one SIMD lane processes one column, and scattered back.
+     * So column FFTs never walk through matrix with the large power-of-2 distance of rows,
+     * which causes cache set conflicts and uses only one item of each fetched cache line.
+     *
+     * Sub-plans are shared with all other FFT classes by FftPlanCache, so that constructing instance is free.
+     * Both steps are split into independent tasks, which can be executed by FftThreadPool.
+     * All functions of this class are thread safe.
+     * @tparam TIndex
+     * @tparam TFloat
+     * @tparam VRows The count of rows which must be a power of 2.
+     * @tparam VCols The count of columns which must be a power of 2.
+     */
+    template<typename TIndex, typename TFloat, TIndex VRows, TIndex VCols>
+        requires util::validate_args_v<TIndex, TFloat, VRows> && util::validate_args_v<TIndex, TFloat, VCols>
+    class Fft2D {
     public:
         using TComplex = std::complex<TFloat>;
-        static constexpr TIndex N = static_cast<TIndex>(VN);
-        static constexpr TIndex M = static_cast<TIndex>(std::bit_width<TIndex>(N) - 1);
-        static constexpr TIndex HALF_POINT = N >> static_cast<TIndex>(1);
+        static constexpr TIndex ROWS = static_cast<TIndex>(VRows);
+        static constexpr TIndex COLS = static_cast<TIndex>(VCols);
+
+    private:
+        using TPlanCache = FftPlanCache<TIndex, TFloat>;
+        using TPlan = TPlanCache::TPlan;
+        /// @brief The count of columns computed by one batched FFT task.
+        static constexpr TIndex COLUMN_BAND = std::min(static_cast<TIndex>(64u), COLS);
+
+    public:
+        /**
+         * @brief Construct 2-D FFT instance.
+         * @details
+         * Sub-plans are fetched from FftPlanCache only once for each TFloat and size, and shared by all instances.
+         * So constructing instance is free and instance occupies no memory.
+         */
+        Fft2D() = default;
+
+    private:
+        /**
+         * @brief Get the shared plan of given point and direction.
+         * @details The plan is held by this function forever, even if FftPlanCache is cleared.
+         */
+        template<TIndex VPoint, FftDirection VDirection>
+        static const TPlan& get_plan() {
+            static const typename TPlanCache::TPlanPtr plan = TPlanCache::get(VPoint, VDirection);
+            return *plan;
+        }
+
+    public:
+        /**
+         * @brief Compute 2-D FFT for given matrix in place.
+         * @param[in,out] data The row-major complex matrix with \c VRows rows and \c VCols columns.
+         */
+        void compute(TComplex* data) const { run(data, FftDirection::Forward, static_cast<TFloat>(1), nullptr); }
+        /**
+         * @brief Compute 2-D FFT for given matrix in place with multiple threads.
+         * @param[in,out] data The row-major complex matrix with \c VRows rows and \c VCols columns.
+         * @param[in] pool The thread pool executing row FFTs and column bands.
+         */
+        void compute(TComplex* data, FftThreadPool& pool) const { run(data, FftDirection::Forward, static_cast<TFloat>(1), &pool); }
+
+        /**
+         * @brief Compute inverse 2-D FFT for given matrix in place.
+         * @param[in,out] data The row-major complex matrix with \c VRows rows and \c VCols columns.
+         * @param[in] normalization
+         * The normalization of result.
+         * For FftNormalization::ByN, result is divided by <TT>VRows * VCols</TT>, which is fused with scattering column bands.
+         */
+        void compute_inverse(TComplex* data, FftNormalization normalization = FftNormalization::ByN) const {
+            run(data, FftDirection::Backward, get_inverse_scale(normalization), nullptr);
+        }
+        /**
+         * @brief Compute inverse 2-D FFT for given matrix in place with multiple threads.
+         * @param[in,out] data The row-major complex matrix with \c VRows rows and \c VCols columns.
+         * @param[in] pool The thread pool executing row FFTs and column bands.
+         * @param[in] normalization The normalization of result.
+         */
+        void compute_inverse(TComplex* data, FftThreadPool& pool, FftNormalization normalization = FftNormalization::ByN) const {
+            run(data, FftDirection::Backward, get_inverse_scale(normalization), &pool);
+        }
+
+    private:
+        static TFloat get_inverse_scale(FftNormalization normalization) {
+            if (normalization == FftNormalization::ByN) return static_cast<TFloat>(1) / (static_cast<TFloat>(ROWS) * static_cast<TFloat>(COLS));
+            else return static_cast<TFloat>(1);
+        }
+
+        /**
+         * @brief Execute <TT>task(i)</TT> for every i in [0, count), by given thread pool or in calling thread if it is nullptr.
+         */
+        static void dispatch(FftThreadPool* pool, size_t count, const std::function<void(size_t)>& task) {
+            if (pool != nullptr) {
+                pool->parallel_for(count, task);
+            } else {
+                for (size_t i = 0u; i < count; ++i) task(i);
+            }
+        }
+
+        static void run(TComplex* data, FftDirection direction, TFloat scale, FftThreadPool* pool) {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            const bool forward = direction == FftDirection::Forward;
+            const TPlan& row_plan = forward ? get_plan<COLS, FftDirection::Forward>() : get_plan<COLS, FftDirection::Backward>();
+            const TPlan& column_plan = forward ? get_plan<ROWS, FftDirection::Forward>() : get_plan<ROWS, FftDirection::Backward>();
+
+            dispatch(pool, static_cast<size_t>(ROWS), [data, &row_plan](size_t i) { row_plan.compute(data + static_cast<TIndex>(i) * COLS); });
+            dispatch(pool, static_cast<size_t>(COLS / COLUMN_BAND), [data, &column_plan, scale](size_t i) {
+                compute_band(data + static_cast<TIndex>(i) * COLUMN_BAND, column_plan, scale);
+            });
+        }
+
+        /**
+         * @brief Compute the column FFTs of a band of columns.
+         * @param[in,out] columns The pointer to the first item of the first column in band.
+         * @param[in] plan The plan of column FFT.
+         * @param[in] scale The scale applied to result.
+         */
+        static void compute_band(TComplex* columns, const TPlan& plan, TFloat scale) {
+            TComplex* band = util::thread_scratch<TFloat>(static_cast<size_t>(ROWS * COLUMN_BAND));
+            for (TIndex r = 0; r < ROWS; ++r) {
+                std::copy_n(columns + r * COLS, COLUMN_BAND, band + r * COLUMN_BAND);
+            }
+
+            plan.compute_batch(band, COLUMN_BAND, COLUMN_BAND);
+
+            if (scale == static_cast<TFloat>(1)) {
+                for (TIndex r = 0; r < ROWS; ++r) {
+                    std::copy_n(band + r * COLUMN_BAND, COLUMN_BAND, columns + r * COLS);
+                }
+            } else {
+                for (TIndex r = 0; r < ROWS; ++r) {
+                    const TComplex* src = band + r * COLUMN_BAND;
+                    TComplex* dst = columns + r * COLS;
+                    for (TIndex c = 0; c < COLUMN_BAND; ++c) dst[c] = src[c] * scale;
+                }
+            }
+        }
     };
 
+#pragma endregion
+
+#pragma region Compact FFT
+
     /**
-     * @brief The core FFT class.
-     * @details The core class implementing FFT algorithm (base-2 version).
-     * @tparam TIndex 
-     * @tparam TFloat 
-     * @tparam N 
+     * @brief The FFT class for fixed-point complex sequence with block floating-point scaling.
+     * @details
+     * \c std::int16_t is treated as Q15 number and \c std::int32_t is treated as Q31 number, that is, a number in [-1, 1).
+     * The computation is radix-2 decimation-in-time FFT in integer arithmetic,
+     * whose products are computed in double width integer and rounded.
+     * For Q15, butterflies are vectorized by SSE2 or AVX2 if they are enabled at compile time,
+     * and the result is exactly the same as the portable scalar implementation.
+     *
+     * The output of FFT grows up to N times of input, so it must be scaled for fixed-point numbers.
+     * Instead of unconditionally halving data in every stage, which throws away precision for small signals,
+     * the peak of data is tracked through stages and the whole block is shifted right before a stage
+     * only if that stage may overflow.
+     * The total count of shifted bits is returned as block exponent,
+     * so that the true result is <TT>data * 2^exponent</TT>.
+     *
+     * Twiddle factors and bit-reversed swap list are stored once per TFixed and N, and shared by all instances.
+     * @tparam TIndex The index type used by FFT which must be an unsigned integral type.
+     * @tparam TFixed \c std::int16_t for Q15 format or \c std::int32_t for Q31 format.
+     * @tparam VN The point of FFT which must be a power of 2 and >= 2.
      */
-    template<typename TIndex, typename TFloat, TIndex VN>
-        requires util::validate_args_v<TIndex, TFloat, VN>
-    class Fft {
+    template<typename TIndex, typename TFixed, TIndex VN>
+        requires util::validate_compact_args_v<TIndex, TFixed, VN> && util::is_fixed_point_v<TFixed>
+    class FixedFft {
     private:
-        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TProperties = FftProperties<TIndex, TFixed, VN>;
         using TComplex = TProperties::TComplex;
         static constexpr TIndex N = TProperties::N;
         static constexpr TIndex M = TProperties::M;
         static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
 
+        using TPack = util::FixedPack<TFixed>;
+        static constexpr TIndex WIDTH = static_cast<TIndex>(TPack::WIDTH);
+
+        /// @brief The integral type holding products and sums without overflow.
+        using TWide = std::conditional_t<std::is_same_v<TFixed, std::int16_t>, std::int32_t, std::int64_t>;
+        /// @brief The count of fraction bits.
+        static constexpr int Q = std::numeric_limits<TFixed>::digits;
+        /// @brief The value added before shifting products, so that they are rounded to nearest.
+        static constexpr TWide ROUNDING = static_cast<TWide>(1) << (Q - 1);
+        /**
+         * @brief The bit width limit of the magnitude of radix-2 stage input, that is, 1/4 in Q format.
+         * @details
+         * The output of butterfly is at most (1 + sqrt(2)) times of input per component,
+         * so the stage whose input magnitude fits in this bit width never overflows.
+         */
+        static constexpr int SAFE_BITS = Q - 2;
+
     public:
-        Fft() : wnp_cache(nullptr) {
-            // Generate WNP cache
-            wnp_cache = std::make_unique<TComplex[]>(N);
-            for (TIndex P = static_cast<TIndex>(0); P < N; ++P) {
-                TFloat angle = util::tau_v<TFloat> * static_cast<TFloat>(P) / static_cast<TFloat>(N);
-                // e^(-jx) = cosx - j sinx
-                wnp_cache[P] = TComplex(std::cos(angle), -std::sin(angle));
-            }
-        }
+        /**
+         * @brief Construct fixed-point FFT instance.
+         * @details Constructing instance is free and instance occupies no memory, like Fft.
+         */
+        FixedFft() = default;
 
     private:
-        std::unique_ptr<TComplex[]> wnp_cache;
+        /**
+         * @brief Get the shared forward twiddle factors in Q format.
+         * @details
+         * The factors are computed in double precision and rounded to Q format only once.
+         * The factors of each stage are stored continuously, so that the innermost loop reads them sequentially:
+         * the stage with half size H occupies items [H - 1, 2H - 1), whose k-th item is W(2H)^k.
+         * The factors are saturated so that cosine near 1 does not overflow.
+         * @return The table with length N - 1.
+         */
+        static const TComplex* get_twiddles() {
+            static const std::vector<TComplex> table = []() {
+                const auto quantize = [](double v) -> TFixed {
+                    const double LIMIT = static_cast<double>(std::numeric_limits<TFixed>::max());
+                    return static_cast<TFixed>(std::clamp(std::round(std::ldexp(v, Q)), -LIMIT, LIMIT));
+                };
+                std::vector<TComplex> rv(N - static_cast<TIndex>(1));
+                for (TIndex half = static_cast<TIndex>(1); half < N; half <<= 1) {
+                    for (TIndex k = static_cast<TIndex>(0); k < half; ++k) {
+                        double angle = std::numbers::pi_v<double> * static_cast<double>(k) / static_cast<double>(half);
+                        rv[half - static_cast<TIndex>(1) + k] = TComplex{quantize(std::cos(angle)), quantize(-std::sin(angle))};
+                    }
+                }
+                return rv;
+            }();
+            return table.data();
+        }
 
-    public:
         /**
-		 * @brief Compute FFT for given complex sequence.
-		 * @details
-		 * This is FFT core compute function but not suit for common user
-		 * because it order that you have enough FFT knowledge to understand what is input data and what is output data.
-		 * For convenient use, see also easy_compute().
-		 * @param[in,out] data 
-		 * The complex sequence for computing.
-		 * The length of this sequence must be N.
-		*/
-        void compute(TComplex* data) const {
-            if (data == nullptr) [[unlikely]] {
-                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+         * @brief Get the shared bit-reversed swap list.
+         * @return The swap list with bit_reverse_swap_count() pairs.
+         */
+        static const TIndex* get_bit_reverse_swaps() {
+            static const std::vector<TIndex> swaps = []() {
+                std::vector<TIndex> rv(util::bit_reverse_swap_count<TIndex>(N) * static_cast<TIndex>(2));
+                util::fill_bit_reverse_swaps<TIndex>(rv.data(), N);
+                return rv;
+            }();
+            return swaps.data();
+        }
+
+        // NOTE:
+        // Only the bit width of the largest magnitude is needed for deciding shift.
+        // The bit width of bitwise OR of some numbers is the largest bit width of them,
+        // so we accumulate magnitudes by bitwise OR instead of comparing them,
+        // which has no branch and no dependency on comparison in the innermost loop.
+        // The magnitude is computed by v ^ (v >> sign), which is |v| for positive v and |v| - 1 for negative v,
+        // so that -1.0 in Q format (|v| is 2^Q) is still in Q bits.
+
+        /// @brief Get the magnitude of given value for bit width accumulation.
+        static TWide magnitude(TWide v) { return v ^ (v >> std::numeric_limits<TWide>::digits); }
+
+        /// @brief Get the bit width of accumulated magnitudes.
+        static int magnitude_width(TWide bits) { return static_cast<int>(std::bit_width(static_cast<std::make_unsigned_t<TWide>>(bits))); }
+
+        /// @brief Accumulate the magnitudes of all real and imaginary parts in given block.
+        static TWide get_magnitude_bits(const TComplex* data) {
+            TWide bits = 0;
+            for (TIndex i = static_cast<TIndex>(0); i < N; ++i) {
+                bits |= magnitude(static_cast<TWide>(data[i].re)) | magnitude(static_cast<TWide>(data[i].im));
             }
+            return bits;
+        }
+
+        /**
+         * @brief Execute the whole FFT with block floating-point scaling.
+         * @tparam VBackward True for backward transform which uses conjugate twiddle factors.
+         * @return The block exponent of result.
+         */
+        template<bool VBackward>
+        static int transform(TComplex* data) {
+            util::bit_reverse_permute<TIndex, TComplex>(data, get_bit_reverse_swaps(), util::bit_reverse_swap_count<TIndex>(N));
 
-            TIndex LH, J, K, B, P;
-            LH = J = HALF_POINT;
+            const TComplex* twiddles = get_twiddles();
+            TWide bits = get_magnitude_bits(data);
+            int exponent = 0;
+            for (TIndex half = static_cast<TIndex>(1); half < N; half <<= 1) {
+                // Decide how many bits this stage should shift according to the magnitude produced by previous stage.
+                const int shift = std::max(0, magnitude_width(bits) - SAFE_BITS);
+                exponent += shift;
 
-            // Construct butterfly structure
-            for (TIndex I = static_cast<TIndex>(1); I <= N - static_cast<TIndex>(2); ++I) {
-                if (I < J) std::swap(data[I], data[J]);
+                const TWide shift_rounding = shift > 0 ? (static_cast<TWide>(1) << (shift - 1)) : static_cast<TWide>(0);
+                const TComplex* stage_twiddles = twiddles + (half - static_cast<TIndex>(1));
+                TWide next_bits = 0;
+                [[maybe_unused]] typename TPack::TReg pack_bits;
+                if constexpr (WIDTH > 1u) pack_bits = TPack::zero();
 
-                K = LH;
-                while (J >= K) {
-                    J -= K;
-                    K >>= static_cast<TIndex>(1);
+                // Early stages whose groups are smaller than pack are executed within pack.
+                if constexpr (WIDTH > 1u) {
+                    if (half < WIDTH && N >= WIDTH) {
+                        TComplex lanes[WIDTH];
+                        for (TIndex i = static_cast<TIndex>(0); i < WIDTH; ++i) {
+                            TIndex r = i % (half << 1);
+                            lanes[i] = r >= half ? stage_twiddles[r - half] : TComplex{0, 0};
+                        }
+                        const auto w = TPack::template twiddle<VBackward>(lanes);
+                        for (TIndex start = static_cast<TIndex>(0); start < N; start += WIDTH) {
+                            auto v = TPack::load(data + start);
+                            if (shift > 0) v = TPack::scale(v, shift);
+                            switch (half) {
+                                case 1u: v = TPack::template butterfly_within<1u>(v, w); break;
+                                case 2u: v = TPack::template butterfly_within<2u>(v, w); break;
+                                default: v = TPack::template butterfly_within<WIDTH / 2u>(v, w); break;
+                            }
+                            pack_bits = TPack::accumulate(pack_bits, v);
+                            TPack::store(data + start, v);
+                        }
+                        bits = static_cast<TWide>(TPack::reduce(pack_bits));
+                        continue;
+                    }
                 }
-                J += K;
-            }
 
-            // Calculate butterfly
-            TComplex temp, temp2;
-            for (TIndex L = static_cast<TIndex>(1); L <= M; ++L) {
-                B = static_cast<TIndex>(1u) << (L - static_cast<TIndex>(1));
-                for (J = static_cast<TIndex>(0); J <= B - static_cast<TIndex>(1); ++J) {
-                    P = J * (static_cast<TIndex>(1) << (M - L));
-
-                    // Use pre-computed cache instead of real-time computing
-                    for (TIndex KK = J; KK <= N - static_cast<TIndex>(1); KK += (static_cast<TIndex>(1) << L)) {
-                        temp2 = (data[KK + B] * this->wnp_cache[P]);
-                        temp = temp2 + data[KK];
-                        data[KK + B] = data[KK] - temp2;
-                        data[KK] = temp;
+                for (TIndex start = static_cast<TIndex>(0); start < N; start += half << 1) {
+                    TComplex* lo = data + start;
+                    TComplex* hi = lo + half;
+                    TIndex k = static_cast<TIndex>(0);
+                    if constexpr (WIDTH > 1u) {
+                        // Half size of later stages is always a multiple of WIDTH.
+                        if (half >= WIDTH) {
+                            for (; k < half; k += WIDTH) {
+                                auto a = TPack::load(lo + k), b = TPack::load(hi + k);
+                                if (shift > 0) {
+                                    a = TPack::scale(a, shift);
+                                    b = TPack::scale(b, shift);
+                                }
+                                auto t = TPack::mul(b, TPack::template twiddle<VBackward>(stage_twiddles + k));
+                                if (k == static_cast<TIndex>(0)) t = TPack::keep_first(t, b);
+                                auto x = TPack::add(a, t), y = TPack::sub(a, t);
+                                pack_bits = TPack::accumulate(TPack::accumulate(pack_bits, x), y);
+                                TPack::store(lo + k, x);
+                                TPack::store(hi + k, y);
+                            }
+                        }
+                    }
+                    for (; k < half; ++k) {
+                        TWide ar = (static_cast<TWide>(lo[k].re) + shift_rounding) >> shift, ai = (static_cast<TWide>(lo[k].im) + shift_rounding) >> shift;
+                        TWide br = (static_cast<TWide>(hi[k].re) + shift_rounding) >> shift, bi = (static_cast<TWide>(hi[k].im) + shift_rounding) >> shift;
+                        TWide tr = br, ti = bi;
+                        // The first twiddle factor is exactly 1, which can not be represented in Q format, so it is skipped.
+                        if (k != static_cast<TIndex>(0)) {
+                            const TWide wr = stage_twiddles[k].re, wi = VBackward ? -static_cast<TWide>(stage_twiddles[k].im) : static_cast<TWide>(stage_twiddles[k].im);
+                            tr = (br * wr - bi * wi + ROUNDING) >> Q;
+                            ti = (br * wi + bi * wr + ROUNDING) >> Q;
+                        }
+                        TWide xr = ar + tr, xi = ai + ti, yr = ar - tr, yi = ai - ti;
+                        next_bits |= magnitude(xr) | magnitude(xi) | magnitude(yr) | magnitude(yi);
+                        lo[k] = TComplex{static_cast<TFixed>(xr), static_cast<TFixed>(xi)};
+                        hi[k] = TComplex{static_cast<TFixed>(yr), static_cast<TFixed>(yi)};
                     }
                 }
+                if constexpr (WIDTH > 1u) next_bits |= static_cast<TWide>(TPack::reduce(pack_bits));
+                bits = next_bits;
+            }
+            return exponent;
+        }
+
+    public:
+        /**
+         * @brief Compute FFT for given fixed-point complex sequence.
+         * @param[in,out] data
+         * The complex sequence for computing.
+         * The length of this sequence must be N.
+         * @return
+         * The block exponent of result.
+         * The true result is <TT>data * 2^exponent</TT>, and it is never negative.
+         */
+        int compute(TComplex* data) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            return transform<false>(data);
+        }
+
+        /**
+         * @brief Compute inverse FFT for given fixed-point complex sequence.
+         * @details
+         * The normalization does not touch data.
+         * It is folded into returned block exponent by subtracting M.
+         * @param[in,out] data
+         * The complex sequence for computing.
+         * The length of this sequence must be N.
+         * @param[in] normalization The normalization of result.
+         * @return
+         * The block exponent of result.
+         * The true result is <TT>data * 2^exponent</TT>.
+         */
+        int compute_inverse(TComplex* data, FftNormalization normalization = FftNormalization::ByN) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
             }
+
+            int exponent = transform<true>(data);
+            if (normalization == FftNormalization::ByN) exponent -= static_cast<int>(M);
+            return exponent;
         }
     };
 
     /**
-     * @brief User friendly FFT computation class.
-     * @details 
-     * @tparam TIndex 
-     * @tparam TFloat 
-     * @tparam N 
-     * @warning This class is \b NOT thread safe. Please use different instance in different thread.
+     * @brief The FFT class for half-precision complex sequence.
+     * @details
+     * Data is stored in half-precision number (\c _Float16 if compiler supports it, or BFloat16),
+     * so that it only occupies half memory and bandwidth of \c float.
+     * The computation is done in \c float by the same engine of Fft:
+     * data is widened into the scratch buffer owned by current thread, transformed, and narrowed back with rounding.
+     *
+     * The result has the precision of storage type, that is, 11 significant bits for \c _Float16 and 8 for BFloat16.
+     * Please note that the range of \c _Float16 is only about [-65504, 65504],
+     * and the output of FFT grows up to N times of input, so input should be normalized for large N.
+     * BFloat16 has the same range as \c float.
+     * @tparam TIndex The index type used by FFT which must be an unsigned integral type.
+     * @tparam THalf \c _Float16 or BFloat16.
+     * @tparam VN The point of FFT which must be a power of 2 and >= 2.
      */
-    template<typename TIndex, typename TFloat, TIndex VN>
-        requires util::validate_args_v<TIndex, TFloat, VN>
-    class FriendlyFft {
+    template<typename TIndex, typename THalf, TIndex VN>
+        requires util::validate_compact_args_v<TIndex, THalf, VN> && util::is_half_float_v<THalf>
+    class HalfFft {
     private:
-        using UnderlyingFft = Fft<TIndex, TFloat, VN>;
-        using TProperties = FftProperties<TIndex, TFloat, VN>;
+        using TProperties = FftProperties<TIndex, THalf, VN>;
         using TComplex = TProperties::TComplex;
         static constexpr TIndex N = TProperties::N;
-        static constexpr TIndex M = TProperties::M;
-        static constexpr TIndex HALF_POINT = TProperties::HALF_POINT;
+        using UnderlyingFft = Fft<TIndex, float, VN>;
 
     public:
-        FriendlyFft() : compute_cache(N) {
-            // Initialize computation used buffer.
-            compute_cache = std::vector<TComplex>();
-        }
+        /**
+         * @brief Construct half-precision FFT instance.
+         * @details The tables of underlying single precision FFT are shared, like Fft.
+         */
+        HalfFft() = default;
 
     private:
         UnderlyingFft underlying_fft;
-        std::vector<TComplex> compute_cache;
 
     public:
         /**
-		 * @brief Get the maximum frequency by given sample rate.
-		 * @param[in] sample_rate 
-		 * The sample rate of input stream.
-		 * Unit is Hz or SPS (sample point per second).
-		 * @return 
-		 * The last data in computed FFT drequency data represented frequency.
-		 * Unit is Hz.
-		*/
-        TFloat get_max_freq(TFloat sample_rate) {
-            // Following sample priniciple
-            return sample_rate / static_cast<TFloat>(2);
+         * @brief Compute FFT for given half-precision complex sequence.
+         * @param[in,out] data
+         * The complex sequence for computing.
+         * The length of this sequence must be N.
+         */
+        void compute(TComplex* data) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
+            }
+
+            std::complex<float>* work = util::thread_scratch<float>(static_cast<size_t>(N));
+            util::widen_compact<TIndex, THalf>(data, work, N);
+            underlying_fft.compute(work);
+            util::narrow_compact<TIndex, THalf>(work, data, N);
         }
 
         /**
-		 * @brief Compute FFT for given time scope data.
-		 * @details
-		 * This is convenient FFT compute function, comparing with compute().
-		 * This function accepts time scope data and output frequency scope data automatically.
-		 * Additionally, it order a window function instance to apply to time scope data before computing.
-		 * @param[in] time_scope The length of this data must be N.
-		 * For the time order of data, the first data should be the oldest data and the last data should be the newest data.
-		 * @param[out] freq_scope The length of this data must be N / 2.
-		 * The first data is 0Hz and the frequency of last data is decided by sample rate which can be computed by get_max_freq() function in this class.
-		 * @param[in] window The window instance applied to data.
-		 * @warning
-		 * This function is \b NOT thread-safe.
-		 * Please do NOT call this function in different thread for one instance.
-		*/
-        void easy_compute(const TFloat* time_scope, TFloat* freq_scope, const Window<TIndex, TFloat, N>& window) {
-            if (time_scope == nullptr || freq_scope == nullptr) [[unlikely]] {
-                throw std::invalid_argument("nullptr data is not allowed for easy FFT computing.");
+         * @brief Compute inverse FFT for given half-precision complex sequence.
+         * @details The normalization is done in \c float before narrowing, so that it loses no precision of storage type.
+         * @param[in,out] data
+         * The complex sequence for computing.
+         * The length of this sequence must be N.
+         * @param[in] normalization The normalization of result.
+         */
+        void compute_inverse(TComplex* data, FftNormalization normalization = FftNormalization::ByN) const {
+            if (data == nullptr) [[unlikely]] {
+                throw std::invalid_argument("nullptr data is not allowed for FFT computing.");
             }
 
-            // First, we copy time scope data into cache with reversed order.
-            // because FFT order the first item should be the latest data.
-            // At the same time we multiple it with window function.
-            std::generate(compute_cache.begin(),
-                          compute_cache.end(),
-                          [data = &(time_scope[N]), win_data = window.get_window_data()]() mutable -> TComplex {
-                              return TComplex(*(data--) * *(win_data++));
-                          });
-
-            // Do FFT compute
-            underlying_fft.compute(compute_cache.data());
-
-            // Compute amplitude
-            for (TIndex i = static_cast<TIndex>(0); i < HALF_POINT; ++i) {
-                freq_scope[i] = static_cast<TFloat>(10) * std::log10(std::abs(compute_cache[i + HALF_POINT]));
-            }
+            std::complex<float>* work = util::thread_scratch<float>(static_cast<size_t>(N));
+            util::widen_compact<TIndex, THalf>(data, work, N);
+            underlying_fft.compute_inverse(work, normalization);
+            util::narrow_compact<TIndex, THalf>(work, data, N);
         }
     };
 
@@ -2,6 +2,20 @@
 #include <yycc.hpp>
 #include <yycc/carton/fft.hpp>
 #include <initializer_list>
+#include <numbers>
+#include <limits>
+#include <bit>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <tuple>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <array>
 
 #define FFT ::yycc::carton::fft
 
@@ -113,4 +127,1838 @@ namespace yycctest::carton::fft {
         test_fft<16>(src, expected);
     }
 
+    /**
+     * @brief Build deterministic complex source data for comparing FFT with reference.
+     * @param[in] n The length of data.
+     * @param[in] step_term The scale of a step term <TT>i % 3</TT> added into imaginary parts, so that data is not smooth.
+     */
+    template<typename TAnyFloat>
+    static std::vector<std::complex<TAnyFloat>> make_test_signal(TIndex n, double step_term = 0.0) {
+        std::vector<std::complex<TAnyFloat>> rv(n);
+        for (TIndex i = 0u; i < n; ++i) {
+            rv[i] = std::complex<TAnyFloat>(static_cast<TAnyFloat>(std::sin(0.37 * static_cast<double>(i))),
+                                            static_cast<TAnyFloat>(std::cos(1.13 * static_cast<double>(i))
+                                                                   + step_term * static_cast<double>(i % 3u)));
+        }
+        return rv;
+    }
+
+    /**
+     * @brief Get the tolerance of FFT result.
+     * @details The error of FFT is relative to the peak of result and grows with log2(N).
+     * @param[in] peak The peak magnitude of expected result.
+     * @param[in] n The point of FFT.
+     * @param[in] factor The count of epsilons allowed per pass.
+     */
+    template<typename TAnyFloat>
+    static double fft_tolerance(double peak, TIndex n, double factor) {
+        return peak * static_cast<double>(std::bit_width(n)) * static_cast<double>(std::numeric_limits<TAnyFloat>::epsilon()) * factor;
+    }
+
+    template<typename TAnyFloat, TIndex N>
+    static void test_fft_with_naive_dft() {
+        // prepare deterministic source data
+        auto src = make_test_signal<TAnyFloat>(N);
+
+        // compute expected result by naive DFT in double precision
+        std::vector<std::complex<double>> expected(N);
+        for (TIndex k = 0u; k < N; ++k) {
+            std::complex<double> sum(0.0, 0.0);
+            for (TIndex n = 0u; n < N; ++n) {
+                double angle = -2.0 * std::numbers::pi * static_cast<double>((k * n) % N) / static_cast<double>(N);
+                sum += std::complex<double>(src[n]) * std::complex<double>(std::cos(angle), std::sin(angle));
+            }
+            expected[k] = sum;
+        }
+
+        // compute by FFT
+        FFT::Fft<TIndex, TAnyFloat, N> fft;
+        fft.compute(src.data());
+
+        double peak = 0.0;
+        for (const auto& item : expected) peak = std::max(peak, std::abs(item));
+        const double tolerance = fft_tolerance<TAnyFloat>(peak, N, 4.0);
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(static_cast<double>(src[i].real()), expected[i].real(), tolerance);
+            EXPECT_NEAR(static_cast<double>(src[i].imag()), expected[i].imag(), tolerance);
+        }
+    }
+
+    TEST(CartonFft, NaiveDftFloat) {
+        test_fft_with_naive_dft<float, 2u>();
+        test_fft_with_naive_dft<float, 4u>();
+        test_fft_with_naive_dft<float, 8u>();
+        test_fft_with_naive_dft<float, 32u>();
+        test_fft_with_naive_dft<float, 128u>();
+        test_fft_with_naive_dft<float, 512u>();
+        test_fft_with_naive_dft<float, 2048u>();
+    }
+
+    TEST(CartonFft, NaiveDftDouble) {
+        test_fft_with_naive_dft<double, 2u>();
+        test_fft_with_naive_dft<double, 16u>();
+        test_fft_with_naive_dft<double, 64u>();
+        test_fft_with_naive_dft<double, 256u>();
+        test_fft_with_naive_dft<double, 1024u>();
+        test_fft_with_naive_dft<double, 4096u>();
+    }
+
+    template<typename TAnyFloat, TIndex N>
+    static void test_stockham_fft() {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        FFT::Fft<TIndex, TAnyFloat, N> fft;
+
+        // compute expected result by Cooley-Tukey algorithm
+        const auto src = make_test_signal<TAnyFloat>(N);
+        std::vector<TAnyComplex> expected(src);
+        fft.compute(expected.data());
+
+        double peak = 0.0;
+        for (const auto& item : expected) peak = std::max(peak, static_cast<double>(std::abs(item)));
+        const double tolerance = fft_tolerance<TAnyFloat>(peak, N, 8.0);
+        auto check = [&expected, tolerance](const std::vector<TAnyComplex>& actual) {
+            for (TIndex i = 0u; i < N; ++i) {
+                EXPECT_NEAR(actual[i].real(), expected[i].real(), tolerance);
+                EXPECT_NEAR(actual[i].imag(), expected[i].imag(), tolerance);
+            }
+        };
+
+        // in place
+        std::vector<TAnyComplex> data(src);
+        fft.compute(data.data(), FFT::FftAlgorithm::Stockham);
+        check(data);
+        // out of place with thread scratch, and source is not modified
+        const std::vector<TAnyComplex> const_src(src);
+        std::vector<TAnyComplex> dst(N);
+        fft.compute(const_src.data(), dst.data(), FFT::FftAlgorithm::Stockham);
+        check(dst);
+        EXPECT_EQ(const_src, src);
+        // out of place with given scratch
+        std::vector<TAnyComplex> scratch(N);
+        std::fill(dst.begin(), dst.end(), TAnyComplex());
+        fft.compute(const_src.data(), dst.data(), FFT::FftAlgorithm::Stockham, scratch.data());
+        check(dst);
+        // out of place with Cooley-Tukey algorithm
+        std::fill(dst.begin(), dst.end(), TAnyComplex());
+        fft.compute(const_src.data(), dst.data());
+        check(dst);
+    }
+
+    TEST(CartonFft, Stockham) {
+        test_stockham_fft<float, 2u>();
+        test_stockham_fft<float, 4u>();
+        test_stockham_fft<float, 8u>();
+        test_stockham_fft<float, 16u>();
+        test_stockham_fft<float, 512u>();
+        test_stockham_fft<float, 8192u>();
+        test_stockham_fft<double, 2u>();
+        test_stockham_fft<double, 32u>();
+        test_stockham_fft<double, 1024u>();
+        test_stockham_fft<double, 16384u>();
+
+        // backward plan
+        using TPlan = FFT::FftPlan<TIndex, TFloat>;
+        constexpr TIndex N = 128u;
+        TPlan forward(N, FFT::FftDirection::Forward, FFT::FftAlgorithm::Stockham);
+        TPlan backward(N, FFT::FftDirection::Backward, FFT::FftAlgorithm::Stockham);
+        EXPECT_EQ(forward.get_algorithm(), FFT::FftAlgorithm::Stockham);
+        EXPECT_EQ(forward.get_scratch_size(), N);
+        EXPECT_EQ(TPlan(N).get_scratch_size(), 0u);
+        std::vector<TComplex> src(N), data(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = TComplex(static_cast<TFloat>(std::sin(0.21 * static_cast<double>(i))), static_cast<TFloat>(i % 5u));
+        }
+        forward.compute(src.data(), data.data());
+        backward.compute(data.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(data[i].real() / static_cast<TFloat>(N), src[i].real(), TOLERANCE);
+            EXPECT_NEAR(data[i].imag() / static_cast<TFloat>(N), src[i].imag(), TOLERANCE);
+        }
+
+        // batched computing is not supported
+        EXPECT_THROW(forward.compute_batch(data.data(), 1u, 1u), std::invalid_argument);
+    }
+
+    template<typename TAnyFloat, TIndex N>
+    static void test_real_fft_with_naive_dft() {
+        using TAnyComplex = std::complex<TAnyFloat>;
+
+        // prepare deterministic real-number source data
+        std::vector<TAnyFloat> src(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = static_cast<TAnyFloat>(std::sin(0.37 * static_cast<double>(i)) + 0.5 * std::cos(2.71 * static_cast<double>(i)));
+        }
+
+        // compute expected first N/2 + 1 items by naive DFT in double precision
+        std::vector<std::complex<double>> expected(N / 2u + 1u);
+        double peak = 0.0;
+        for (TIndex k = 0u; k < expected.size(); ++k) {
+            std::complex<double> sum(0.0, 0.0);
+            for (TIndex n = 0u; n < N; ++n) {
+                double angle = -2.0 * std::numbers::pi * static_cast<double>((k * n) % N) / static_cast<double>(N);
+                sum += static_cast<double>(src[n]) * std::complex<double>(std::cos(angle), std::sin(angle));
+            }
+            expected[k] = sum;
+            peak = std::max(peak, std::abs(sum));
+        }
+
+        // compute by real FFT
+        FFT::RealFft<TIndex, TAnyFloat, N> fft;
+        std::vector<TAnyComplex> dst(N / 2u + 1u);
+        fft.compute(src.data(), dst.data());
+
+        const double tolerance = peak * static_cast<double>(std::bit_width(N))
+                                 * static_cast<double>(std::numeric_limits<TAnyFloat>::epsilon()) * 4.0;
+        for (TIndex i = 0u; i < dst.size(); ++i) {
+            EXPECT_NEAR(static_cast<double>(dst[i].real()), expected[i].real(), tolerance);
+            EXPECT_NEAR(static_cast<double>(dst[i].imag()), expected[i].imag(), tolerance);
+        }
+    }
+
+    TEST(CartonFft, RealFft) {
+        test_real_fft_with_naive_dft<float, 4u>();
+        test_real_fft_with_naive_dft<float, 8u>();
+        test_real_fft_with_naive_dft<float, 64u>();
+        test_real_fft_with_naive_dft<float, 1024u>();
+        test_real_fft_with_naive_dft<double, 4u>();
+        test_real_fft_with_naive_dft<double, 32u>();
+        test_real_fft_with_naive_dft<double, 2048u>();
+        // the point which is not a power of 2, including odd N/2
+        test_real_fft_with_naive_dft<float, 30u>();
+        test_real_fft_with_naive_dft<float, 480u>();
+        test_real_fft_with_naive_dft<float, 22u>();
+        test_real_fft_with_naive_dft<double, 1000u>();
+    }
+
+    template<typename TAnyFloat, TIndex N, bool VIsDctIV>
+    static void test_dct_with_naive_dct() {
+        using TDct = std::conditional_t<VIsDctIV, FFT::DctIV<TIndex, TAnyFloat, N>, FFT::DctII<TIndex, TAnyFloat, N>>;
+
+        // prepare deterministic real-number source data
+        std::vector<TAnyFloat> src(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = static_cast<TAnyFloat>(std::sin(0.37 * static_cast<double>(i)) + 0.5 * std::cos(2.71 * static_cast<double>(i)));
+        }
+
+        // compute expected coefficients by naive DCT in double precision
+        std::vector<double> expected(N);
+        double peak = 0.0;
+        for (TIndex k = 0u; k < N; ++k) {
+            double sum = 0.0;
+            for (TIndex n = 0u; n < N; ++n) {
+                // reduce phase by period, so that reference is accurate for large N
+                const double phase = VIsDctIV ? static_cast<double>(((2u * n + 1u) * (2u * k + 1u)) % (8u * N)) / static_cast<double>(4u * N)
+                                              : static_cast<double>(((2u * n + 1u) * k) % (4u * N)) / static_cast<double>(2u * N);
+                sum += static_cast<double>(src[n]) * std::cos(std::numbers::pi * phase);
+            }
+            expected[k] = sum;
+            peak = std::max(peak, std::abs(sum));
+        }
+
+        // compute by fast DCT
+        TDct dct;
+        std::vector<TAnyFloat> dst(N);
+        dct.compute(src.data(), dst.data());
+        const double tolerance = peak * static_cast<double>(std::bit_width(N))
+                                 * static_cast<double>(std::numeric_limits<TAnyFloat>::epsilon()) * 4.0;
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(static_cast<double>(dst[i]), expected[i], tolerance);
+        }
+
+        // inverse computing in place restores source
+        dct.compute_inverse(dst.data(), dst.data());
+        const double roundtrip_tolerance = static_cast<double>(std::bit_width(N))
+                                           * static_cast<double>(std::numeric_limits<TAnyFloat>::epsilon()) * 16.0;
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(static_cast<double>(dst[i]), static_cast<double>(src[i]), roundtrip_tolerance);
+        }
+
+        // nullptr is not allowed
+        EXPECT_THROW(dct.compute(nullptr, dst.data()), std::invalid_argument);
+        EXPECT_THROW(dct.compute_inverse(src.data(), nullptr), std::invalid_argument);
+    }
+
+    TEST(CartonFft, Dct) {
+        test_dct_with_naive_dct<float, 4u, false>();
+        test_dct_with_naive_dct<float, 64u, false>();
+        test_dct_with_naive_dct<float, 1024u, false>();
+        test_dct_with_naive_dct<double, 32u, false>();
+        test_dct_with_naive_dct<double, 2048u, false>();
+        test_dct_with_naive_dct<float, 30u, false>();
+        test_dct_with_naive_dct<double, 480u, false>();
+
+        test_dct_with_naive_dct<float, 4u, true>();
+        test_dct_with_naive_dct<float, 64u, true>();
+        test_dct_with_naive_dct<float, 1024u, true>();
+        test_dct_with_naive_dct<double, 32u, true>();
+        test_dct_with_naive_dct<double, 2048u, true>();
+        test_dct_with_naive_dct<float, 30u, true>();
+        test_dct_with_naive_dct<double, 480u, true>();
+
+        // unnormalized DCT-III is twice of its common definition
+        constexpr TIndex N = 16u;
+        std::vector<TFloat> coefficients(N), actual(N);
+        for (TIndex k = 0u; k < N; ++k) {
+            coefficients[k] = static_cast<TFloat>(std::cos(0.61 * static_cast<double>(k)));
+        }
+        FFT::DctII<TIndex, TFloat, N> dct;
+        dct.compute_inverse(coefficients.data(), actual.data(), FFT::FftNormalization::None);
+        for (TIndex n = 0u; n < N; ++n) {
+            double expected = static_cast<double>(coefficients[0]) / 2.0;
+            for (TIndex k = 1u; k < N; ++k) {
+                expected += static_cast<double>(coefficients[k])
+                            * std::cos(std::numbers::pi * static_cast<double>((2u * n + 1u) * k) / static_cast<double>(2u * N));
+            }
+            EXPECT_NEAR(static_cast<double>(actual[n]), expected * 2.0, TOLERANCE);
+        }
+    }
+
+    TEST(CartonFft, Window) {
+        constexpr TIndex N = 64u;
+        using TWindow = FFT::Window<TIndex, double, N>;
+        using FFT::WindowType;
+
+        // compare built-in windows with their definitions
+        auto phase = [](TIndex i) -> double { return 2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(N - 1u); };
+        auto check = [](WindowType type, auto&& expected, double kaiser_beta = TWindow::DEFAULT_KAISER_BETA) {
+            TWindow window(type, kaiser_beta);
+            EXPECT_EQ(window.get_window_type(), type);
+            const double* data = window.get_window_data();
+            for (TIndex i = 0u; i < N; ++i) {
+                EXPECT_NEAR(data[i], expected(i), 1e-9);
+                // all built-in windows are symmetric
+                EXPECT_NEAR(data[i], data[N - 1u - i], 1e-9);
+            }
+        };
+        check(WindowType::HanningWindow, [&](TIndex i) { return 0.5 - 0.5 * std::cos(phase(i)); });
+        check(WindowType::HammingWindow, [&](TIndex i) { return 0.54 - 0.46 * std::cos(phase(i)); });
+        check(WindowType::BlackmanWindow, [&](TIndex i) { return 0.42 - 0.5 * std::cos(phase(i)) + 0.08 * std::cos(2.0 * phase(i)); });
+        check(WindowType::BlackmanHarrisWindow, [&](TIndex i) {
+            return 0.35875 - 0.48829 * std::cos(phase(i)) + 0.14128 * std::cos(2.0 * phase(i)) - 0.01168 * std::cos(3.0 * phase(i));
+        });
+        check(WindowType::FlatTopWindow, [&](TIndex i) {
+            return 0.21557895 - 0.41663158 * std::cos(phase(i)) + 0.277263158 * std::cos(2.0 * phase(i))
+                   - 0.083578947 * std::cos(3.0 * phase(i)) + 0.006947368 * std::cos(4.0 * phase(i));
+        });
+        // Kaiser window with beta = 0 is rectangular window, and its center is always 1
+        check(WindowType::KaiserWindow, [](TIndex) { return 1.0; }, 0.0);
+        TWindow kaiser(WindowType::KaiserWindow, 5.0);
+        EXPECT_NEAR(kaiser.get_window_data()[0], 1.0 / std::cyl_bessel_i(0.0, 5.0), 1e-9);
+        EXPECT_LT(kaiser.get_window_data()[0], kaiser.get_window_data()[N / 2u]);
+
+        // built-in windows are shared, and different beta is different window
+        EXPECT_EQ(TWindow(WindowType::HammingWindow).get_window_data(), TWindow(WindowType::HammingWindow).get_window_data());
+        EXPECT_EQ(kaiser.get_window_data(), TWindow(WindowType::KaiserWindow, 5.0).get_window_data());
+        EXPECT_NE(kaiser.get_window_data(), TWindow(WindowType::KaiserWindow, 6.0).get_window_data());
+        // data of unused beta is freed rather than cached forever
+        const size_t cache_size = TWindow::get_cache_size();
+        for (int i = 0; i < 100; ++i) {
+            TWindow temporary(WindowType::KaiserWindow, 10.0 + 0.01 * static_cast<double>(i));
+            EXPECT_LE(TWindow::get_cache_size(), cache_size + 1u);
+        }
+        EXPECT_EQ(kaiser.get_window_data(), TWindow(WindowType::KaiserWindow, 5.0).get_window_data());
+
+        // custom window is copied
+        std::vector<double> custom(N);
+        for (TIndex i = 0u; i < N; ++i) custom[i] = static_cast<double>(i);
+        TWindow custom_window(custom.data());
+        custom[1] = -1.0;
+        EXPECT_EQ(custom_window.get_window_type(), WindowType::CustomWindow);
+        EXPECT_EQ(custom_window.get_window_data()[1], 1.0);
+
+        // invalid arguments
+        EXPECT_THROW(TWindow(WindowType::CustomWindow), std::invalid_argument);
+        EXPECT_THROW(TWindow(WindowType::KaiserWindow, -1.0), std::invalid_argument);
+        EXPECT_THROW(TWindow(static_cast<const double*>(nullptr)), std::invalid_argument);
+    }
+
+    template<typename TAnyFloat, TIndex N>
+    static void test_window_apply() {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        FFT::Window<TIndex, TAnyFloat, N> window(FFT::WindowType::BlackmanWindow);
+        const TAnyFloat* win = window.get_window_data();
+
+        std::vector<TAnyFloat> src(N);
+        for (TIndex i = 0u; i < N; ++i) src[i] = static_cast<TAnyFloat>(i + 1u);
+
+        // in place
+        std::vector<TAnyFloat> in_place(src);
+        window.apply_window(in_place.data());
+        // fused copy in both order
+        std::vector<TAnyFloat> forward(N), reversed(N);
+        window.apply_window(src.data(), forward.data());
+        window.apply_window(src.data(), reversed.data(), true);
+        // fused widening in both order
+        std::vector<TAnyComplex> widened(N, TAnyComplex(-1, -1)), widened_reversed(N, TAnyComplex(-1, -1));
+        window.apply_window(src.data(), widened.data());
+        window.apply_window(src.data(), widened_reversed.data(), true);
+
+        for (TIndex i = 0u; i < N; ++i) {
+            const TAnyFloat expected = src[i] * win[i];
+            const TAnyFloat expected_reversed = src[N - 1u - i] * win[i];
+            EXPECT_EQ(in_place[i], expected);
+            EXPECT_EQ(forward[i], expected);
+            EXPECT_EQ(reversed[i], expected_reversed);
+            EXPECT_EQ(widened[i], TAnyComplex(expected));
+            EXPECT_EQ(widened_reversed[i], TAnyComplex(expected_reversed));
+        }
+    }
+
+    TEST(CartonFft, WindowApply) {
+        test_window_apply<float, 2u>();
+        test_window_apply<float, 4u>();
+        test_window_apply<float, 64u>();
+        test_window_apply<double, 2u>();
+        test_window_apply<double, 8u>();
+        test_window_apply<double, 128u>();
+    }
+
+    TEST(CartonFft, FriendlyFft) {
+        constexpr TIndex N = 64u;
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        FFT::FriendlyFft<TIndex, TFloat, N> fft;
+
+        // prepare a sine wave locating at 8-th frequency bin
+        std::vector<TFloat> time_scope(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            time_scope[i] = static_cast<TFloat>(std::sin(2.0 * std::numbers::pi * 8.0 * static_cast<double>(i) / static_cast<double>(N)));
+        }
+        std::vector<TFloat> freq_scope(N / 2u);
+        fft.easy_compute(time_scope.data(), freq_scope.data(), window);
+
+        // compute expected result by complex FFT on reversed and windowed data
+        std::vector<TComplex> expected(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            expected[i] = TComplex(time_scope[N - 1u - i] * window.get_window_data()[i]);
+        }
+        TFft<N> complex_fft;
+        complex_fft.compute(expected.data());
+        for (TIndex i = 0u; i < N / 2u; ++i) {
+            EXPECT_NEAR(freq_scope[i], 10.0f * std::log10(std::abs(expected[i])), 0.01f);
+        }
+
+        // the peak should be located at 8-th bin
+        auto peak = std::max_element(freq_scope.begin(), freq_scope.end());
+        EXPECT_EQ(std::distance(freq_scope.begin(), peak), 8);
+    }
+
+    template<typename TAnyFloat>
+    static void test_amplitude_db(TAnyFloat bound) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+
+        // sweep amplitude through many octaves and phases, with odd length for the remainder path
+        std::vector<TAnyComplex> spectrum;
+        for (int exponent = -60; exponent <= 60; ++exponent) {
+            for (int step = 0; step < 37; ++step) {
+                double magnitude = std::ldexp(1.0 + static_cast<double>(step) / 37.0, exponent);
+                double phase = 0.17 * static_cast<double>(exponent * 37 + step);
+                spectrum.emplace_back(static_cast<TAnyFloat>(magnitude * std::cos(phase)), static_cast<TAnyFloat>(magnitude * std::sin(phase)));
+            }
+        }
+        spectrum.emplace_back(static_cast<TAnyFloat>(0), static_cast<TAnyFloat>(0));
+        const TIndex n = spectrum.size();
+
+        std::vector<TAnyFloat> power(n), amplitude(n);
+        FFT::util::power_spectrum<TIndex, TAnyFloat>(spectrum.data(), power.data(), n);
+        FFT::util::amplitude_db<TIndex, TAnyFloat>(spectrum.data(), amplitude.data(), n);
+        for (TIndex i = 0u; i + 1u < n; ++i) {
+            const TAnyFloat expected_power = spectrum[i].real() * spectrum[i].real() + spectrum[i].imag() * spectrum[i].imag();
+            EXPECT_NEAR(power[i], expected_power, expected_power * std::numeric_limits<TAnyFloat>::epsilon() * 2);
+            EXPECT_NEAR(amplitude[i], static_cast<TAnyFloat>(5) * std::log10(expected_power), bound);
+        }
+
+        // zero amplitude produces finite floor
+        EXPECT_EQ(power[n - 1u], static_cast<TAnyFloat>(0));
+        EXPECT_TRUE(std::isfinite(amplitude[n - 1u]));
+        EXPECT_NEAR(amplitude[n - 1u], static_cast<TAnyFloat>(5) * std::log10(std::numeric_limits<TAnyFloat>::min()), bound);
+    }
+
+    TEST(CartonFft, AmplitudeDb) {
+        test_amplitude_db<float>(1e-4f);
+        test_amplitude_db<double>(1e-6);
+    }
+
+    template<typename TAnyFloat>
+    static void test_complex_multiply() {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        const TAnyFloat epsilon = std::numeric_limits<TAnyFloat>::epsilon();
+
+        // explicit arithmetic is the same as std::complex multiplication for finite numbers
+        for (int i = 0; i < 64; ++i) {
+            const TAnyComplex a(static_cast<TAnyFloat>(std::sin(0.37 * i) * 100.0), static_cast<TAnyFloat>(std::cos(1.13 * i)));
+            const TAnyComplex b = std::polar(static_cast<TAnyFloat>(1), static_cast<TAnyFloat>(0.1 * i));
+            const TAnyComplex expected = a * b;
+            const TAnyComplex actual = FFT::util::complex_multiply(a, b);
+            const TAnyFloat tolerance = std::abs(a) * std::abs(b) * epsilon * static_cast<TAnyFloat>(4);
+            EXPECT_NEAR(actual.real(), expected.real(), tolerance);
+            EXPECT_NEAR(actual.imag(), expected.imag(), tolerance);
+        }
+        // special values which are exact
+        EXPECT_EQ(FFT::util::complex_multiply(TAnyComplex(0, 1), TAnyComplex(0, 1)), TAnyComplex(-1, 0));
+        EXPECT_EQ(FFT::util::complex_multiply(TAnyComplex(3, -2), TAnyComplex(1, 0)), TAnyComplex(3, -2));
+    }
+
+    TEST(CartonFft, ComplexMultiply) {
+        test_complex_multiply<float>();
+        test_complex_multiply<double>();
+    }
+
+    TEST(CartonFft, FftPlan) {
+        using TPlan = FFT::FftPlan<TIndex, TFloat>;
+        using TPlanCache = FFT::FftPlanCache<TIndex, TFloat>;
+
+        // invalid point and algorithm
+        EXPECT_THROW(TPlan(0u), std::invalid_argument);
+        EXPECT_THROW(TPlan(1u), std::invalid_argument);
+        EXPECT_THROW(TPlan(12u, FFT::FftDirection::Forward, static_cast<FFT::FftAlgorithm>(-1)), std::invalid_argument);
+
+        // runtime plan should produce the same result with compile-time FFT
+        constexpr TIndex N = 256u;
+        std::vector<TComplex> src(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = TComplex(static_cast<TFloat>(std::sin(0.37 * static_cast<double>(i))), static_cast<TFloat>(i % 3u));
+        }
+        std::vector<TComplex> expected(src), actual(src);
+        TFft<N> fft;
+        fft.compute(expected.data());
+        TPlan plan(N);
+        EXPECT_EQ(plan.get_size(), N);
+        EXPECT_EQ(plan.get_direction(), FFT::FftDirection::Forward);
+        plan.compute(actual.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(actual[i].real(), expected[i].real(), TOLERANCE);
+            EXPECT_NEAR(actual[i].imag(), expected[i].imag(), TOLERANCE);
+        }
+
+        // backward transform of forward transform is N times of source
+        auto backward = TPlanCache::get(N, FFT::FftDirection::Backward);
+        EXPECT_EQ(backward->get_direction(), FFT::FftDirection::Backward);
+        backward->compute(actual.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(actual[i].real() / static_cast<TFloat>(N), src[i].real(), TOLERANCE);
+            EXPECT_NEAR(actual[i].imag() / static_cast<TFloat>(N), src[i].imag(), TOLERANCE);
+        }
+    }
+
+    TEST(CartonFft, FftPlanCache) {
+        using TPlanCache = FFT::FftPlanCache<TIndex, TFloat>;
+
+        // the same key share the same plan
+        auto forward = TPlanCache::get(64u);
+        EXPECT_EQ(forward, TPlanCache::get(64u, FFT::FftDirection::Forward));
+        EXPECT_NE(forward, TPlanCache::get(64u, FFT::FftDirection::Backward));
+        EXPECT_NE(forward, TPlanCache::get(128u));
+        EXPECT_THROW(TPlanCache::get(1u), std::invalid_argument);
+
+        // plan is still alive after clearing cache, but new request will build new one.
+        TPlanCache::clear();
+        EXPECT_EQ(forward->get_size(), 64u);
+        EXPECT_NE(forward, TPlanCache::get(64u));
+    }
+
+    TEST(CartonFft, FftPlanner) {
+        using TPlanner = FFT::FftPlanner<TIndex, TFloat>;
+        using TPlanCache = FFT::FftPlanCache<TIndex, TFloat>;
+        using TPlan = FFT::FftPlan<TIndex, TFloat>;
+        using TDoublePlanner = FFT::FftPlanner<TIndex, double>;
+        TPlanner::clear();
+
+        // invalid point, and the point which is not a power of 2 is never measured
+        EXPECT_THROW(TPlanner::choose(1u), std::invalid_argument);
+        EXPECT_EQ(TPlanner::choose(480u), FFT::FftAlgorithm::CooleyTukey);
+        EXPECT_FALSE(TPlanner::find(480u).has_value());
+        EXPECT_THROW(TPlan(64u, FFT::FftDirection::Forward, FFT::FftAlgorithm::Measure), std::invalid_argument);
+
+        // measured algorithm is remembered, and planner mode shares the plan of chosen algorithm
+        constexpr TIndex N = 256u;
+        EXPECT_FALSE(TPlanner::find(N).has_value());
+        auto algorithm = TPlanner::choose(N);
+        EXPECT_TRUE(algorithm == FFT::FftAlgorithm::CooleyTukey || algorithm == FFT::FftAlgorithm::Stockham);
+        EXPECT_EQ(TPlanner::find(N), algorithm);
+        EXPECT_EQ(TPlanner::choose(N), algorithm);
+        auto plan = TPlanCache::get(N, FFT::FftDirection::Forward, FFT::FftAlgorithm::Measure);
+        EXPECT_EQ(plan->get_algorithm(), algorithm);
+        EXPECT_EQ(plan, TPlanCache::get(N, FFT::FftDirection::Forward, algorithm));
+        EXPECT_FALSE(TPlanner::find(N, FFT::FftDirection::Backward).has_value());
+
+        // concurrent first requests agree with each other, and other keys are not blocked by measurement
+        std::array<FFT::FftAlgorithm, 4> concurrent;
+        {
+            std::vector<std::jthread> threads;
+            for (size_t i = 0u; i < concurrent.size(); ++i) {
+                threads.emplace_back([&concurrent, i]() { concurrent[i] = TPlanner::choose(128u, FFT::FftDirection::Backward); });
+            }
+            EXPECT_EQ(TPlanner::find(N), algorithm);
+        }
+        for (auto chosen : concurrent) EXPECT_EQ(TPlanner::find(128u, FFT::FftDirection::Backward), chosen);
+
+        // planner mode of Fft produces the same result
+        std::vector<TComplex> expected(N), actual(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            expected[i] = TComplex(static_cast<TFloat>(std::sin(0.37 * static_cast<double>(i))), static_cast<TFloat>(i % 3u));
+        }
+        actual = expected;
+        TFft<N> fft;
+        fft.compute(expected.data());
+        fft.compute(actual.data(), FFT::FftAlgorithm::Measure);
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(actual[i].real(), expected[i].real(), TOLERANCE);
+            EXPECT_NEAR(actual[i].imag(), expected[i].imag(), TOLERANCE);
+        }
+
+        // wisdom roundtrip
+        auto backward_algorithm = TPlanner::choose(64u, FFT::FftDirection::Backward);
+        std::stringstream wisdom;
+        EXPECT_TRUE(TPlanner::save_wisdom(wisdom).has_value());
+        TPlanner::clear();
+        EXPECT_FALSE(TPlanner::find(N).has_value());
+        EXPECT_TRUE(TPlanner::load_wisdom(wisdom).has_value());
+        EXPECT_EQ(TPlanner::find(N), algorithm);
+        EXPECT_EQ(TPlanner::find(64u, FFT::FftDirection::Backward), backward_algorithm);
+        EXPECT_FALSE(TPlanner::find(64u).has_value());
+
+        // wisdom of other float point type is rejected, and broken stream is reported
+        std::stringstream double_wisdom;
+        EXPECT_TRUE(TDoublePlanner::save_wisdom(double_wisdom).has_value());
+        auto rv = TPlanner::load_wisdom(double_wisdom);
+        ASSERT_FALSE(rv.has_value());
+        EXPECT_EQ(rv.error(), ::yycc::carton::binstore::types::BinstoreError::BadVersion);
+        std::stringstream empty_wisdom;
+        EXPECT_FALSE(TPlanner::load_wisdom(empty_wisdom).has_value());
+        TPlanner::clear();
+    }
+
+    template<typename TAnyFloat>
+    static void test_mixed_radix_fft(TIndex n) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+
+        // the step term makes source data not smooth, so that every radix sees non-trivial input
+        const auto src = make_test_signal<TAnyFloat>(n, 0.1);
+
+        for (auto direction : {FFT::FftDirection::Forward, FFT::FftDirection::Backward}) {
+            // compute expected result by naive DFT in double precision
+            const double sign = direction == FFT::FftDirection::Forward ? -1.0 : 1.0;
+            std::vector<std::complex<double>> expected(n);
+            double peak = 0.0;
+            for (TIndex k = 0u; k < n; ++k) {
+                std::complex<double> sum(0.0, 0.0);
+                for (TIndex i = 0u; i < n; ++i) {
+                    double angle = sign * 2.0 * std::numbers::pi * static_cast<double>((k * i) % n) / static_cast<double>(n);
+                    sum += std::complex<double>(src[i]) * std::polar(1.0, angle);
+                }
+                expected[k] = sum;
+                peak = std::max(peak, std::abs(sum));
+            }
+            const double tolerance = fft_tolerance<TAnyFloat>(peak, n, 8.0);
+
+            // in place with thread owned scratch, and out of place with given scratch
+            auto plan = FFT::FftPlanCache<TIndex, TAnyFloat>::get(n, direction);
+            std::vector<TAnyComplex> in_place(src), out_of_place(n), scratch(plan->get_scratch_size());
+            plan->compute(in_place.data());
+            plan->compute(src.data(), out_of_place.data(), scratch.data());
+            for (TIndex k = 0u; k < n; ++k) {
+                EXPECT_NEAR(in_place[k].real(), expected[k].real(), tolerance);
+                EXPECT_NEAR(in_place[k].imag(), expected[k].imag(), tolerance);
+                EXPECT_EQ(out_of_place[k], in_place[k]);
+            }
+        }
+    }
+
+    TEST(CartonFft, MixedRadixFft) {
+        // mixed-radix passes
+        for (TIndex n : {3u, 5u, 6u, 7u, 9u, 12u, 15u, 30u, 49u, 60u, 100u, 210u, 480u, 1000u}) {
+            test_mixed_radix_fft<float>(n);
+        }
+        test_mixed_radix_fft<double>(960u);
+        // Bluestein algorithm
+        for (TIndex n : {11u, 13u, 22u, 66u, 97u}) {
+            test_mixed_radix_fft<float>(n);
+        }
+        test_mixed_radix_fft<double>(1009u);
+
+        // scratch size and batched computing
+        using TPlan = FFT::FftPlan<TIndex, TFloat>;
+        EXPECT_EQ(TPlan(480u).get_scratch_size(), 480u);
+        EXPECT_EQ(TPlan(97u).get_scratch_size(), 256u);
+        std::vector<TComplex> data(480u);
+        EXPECT_THROW(TPlan(480u).compute_batch(data.data(), 1u, 1u), std::invalid_argument);
+        EXPECT_THROW(TPlan(97u).compute_batch(data.data(), 1u, 1u), std::invalid_argument);
+
+        // compile-time FFT shares the same engine
+        constexpr TIndex N = 480u;
+        std::vector<TComplex> src(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = TComplex(static_cast<TFloat>(std::sin(0.37 * static_cast<double>(i))), static_cast<TFloat>(i % 3u));
+        }
+        std::vector<TComplex> expected(src), actual(src);
+        TPlan(N).compute(expected.data());
+        TFft<N> fft;
+        fft.compute(actual.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_EQ(actual[i], expected[i]);
+        }
+        fft.compute_inverse(actual.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(actual[i].real(), src[i].real(), TOLERANCE);
+            EXPECT_NEAR(actual[i].imag(), src[i].imag(), TOLERANCE);
+        }
+
+        // friendly FFT on audio frame
+        std::vector<TFloat> frame(N), freq(N / 2u);
+        for (TIndex i = 0u; i < N; ++i) {
+            frame[i] = static_cast<TFloat>(std::sin(2.0 * std::numbers::pi * 1000.0 * static_cast<double>(i) / 48000.0));
+        }
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        FFT::FriendlyFft<TIndex, TFloat, N> friendly;
+        friendly.easy_compute(frame.data(), freq.data(), window);
+        // 1kHz is exactly bin 10 with 100Hz spacing
+        EXPECT_EQ(std::distance(freq.begin(), std::max_element(freq.begin(), freq.end())), 10);
+    }
+
+    template<typename TAnyFloat, TIndex N>
+    static void test_fft_batch(TIndex channels, TIndex stride) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        FFT::Fft<TIndex, TAnyFloat, N> fft;
+
+        // prepare interleaved channels and its separated copy
+        std::vector<TAnyComplex> batch(N * stride, TAnyComplex(-1, -1));
+        std::vector<std::vector<TAnyComplex>> separated(channels, std::vector<TAnyComplex>(N));
+        for (TIndex c = 0u; c < channels; ++c) {
+            for (TIndex k = 0u; k < N; ++k) {
+                TAnyComplex value(static_cast<TAnyFloat>(std::sin(0.1 * static_cast<double>(c + 1u) * static_cast<double>(k))),
+                                  static_cast<TAnyFloat>(c % 3u));
+                batch[k * stride + c] = value;
+                separated[c][k] = value;
+            }
+        }
+
+        // compute them individually
+        fft.compute_batch(batch.data(), channels, stride);
+        for (auto& item : separated) {
+            fft.compute(item.data());
+        }
+
+        // check result and padding
+        for (TIndex k = 0u; k < N; ++k) {
+            for (TIndex c = 0u; c < stride; ++c) {
+                const auto& actual = batch[k * stride + c];
+                if (c < channels) {
+                    EXPECT_NEAR(actual.real(), separated[c][k].real(), TOLERANCE);
+                    EXPECT_NEAR(actual.imag(), separated[c][k].imag(), TOLERANCE);
+                } else {
+                    EXPECT_EQ(actual, TAnyComplex(-1, -1));
+                }
+            }
+        }
+    }
+
+    template<typename TAnyFloat>
+    static void test_split_fft(TIndex n) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+
+        // prepare deterministic source data
+        const auto src = make_test_signal<TAnyFloat>(n);
+
+        for (auto direction : {FFT::FftDirection::Forward, FFT::FftDirection::Backward}) {
+            // compute expected result by interleaved plan
+            auto plan = FFT::FftPlanCache<TIndex, TAnyFloat>::get(n, direction);
+            std::vector<TAnyComplex> expected(src);
+            plan->compute(expected.data());
+
+            std::vector<TAnyFloat> re(n), im(n);
+            for (TIndex i = 0u; i < n; ++i) {
+                re[i] = src[i].real();
+                im[i] = src[i].imag();
+            }
+            plan->compute(re.data(), im.data());
+
+            double peak = 0.0;
+            for (const auto& item : expected) peak = std::max(peak, static_cast<double>(std::abs(item)));
+            const double tolerance = fft_tolerance<TAnyFloat>(peak, n, 8.0);
+            for (TIndex i = 0u; i < n; ++i) {
+                EXPECT_NEAR(re[i], expected[i].real(), tolerance);
+                EXPECT_NEAR(im[i], expected[i].imag(), tolerance);
+            }
+        }
+    }
+
+    TEST(CartonFft, SplitFft) {
+        // both odd and even exponent, and strides around SIMD width
+        for (TIndex n : {2u, 4u, 8u, 16u, 32u, 64u, 128u, 1024u, 2048u}) {
+            test_split_fft<float>(n);
+            test_split_fft<double>(n);
+        }
+        // fallback for the point which is not a power of 2
+        test_split_fft<float>(480u);
+        test_split_fft<float>(97u);
+
+        // compile-time FFT and its inverse
+        constexpr TIndex N = 256u;
+        std::vector<TFloat> re(N), im(N), src_re(N), src_im(N);
+        std::vector<TComplex> expected(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src_re[i] = static_cast<TFloat>(std::sin(0.37 * static_cast<double>(i)));
+            src_im[i] = static_cast<TFloat>(i % 5u);
+            expected[i] = TComplex(src_re[i], src_im[i]);
+        }
+        re = src_re;
+        im = src_im;
+        TFft<N> fft;
+        fft.compute(expected.data());
+        fft.compute(re.data(), im.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(re[i], expected[i].real(), TOLERANCE * 10);
+            EXPECT_NEAR(im[i], expected[i].imag(), TOLERANCE * 10);
+        }
+        fft.compute_inverse(re.data(), im.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(re[i], src_re[i], TOLERANCE);
+            EXPECT_NEAR(im[i], src_im[i], TOLERANCE);
+        }
+
+        EXPECT_THROW(fft.compute(nullptr, im.data()), std::invalid_argument);
+
+        // lazily built split tables do not prevent plan from moving, before or after they are built
+        using TPlan = FFT::FftPlan<TIndex, TFloat>;
+        static_assert(std::is_nothrow_move_constructible_v<TPlan> && std::is_nothrow_move_assignable_v<TPlan>);
+        TPlan built(N);
+        re = src_re;
+        im = src_im;
+        built.compute(re.data(), im.data());
+        TPlan moved(std::move(built));
+        std::vector<TFloat> moved_re(src_re), moved_im(src_im);
+        moved.compute(moved_re.data(), moved_im.data());
+        EXPECT_EQ(moved_re, re);
+        EXPECT_EQ(moved_im, im);
+        TPlan assigned(8u);
+        assigned = TPlan(N);
+        moved_re = src_re;
+        moved_im = src_im;
+        assigned.compute(moved_re.data(), moved_im.data());
+        EXPECT_EQ(moved_re, re);
+        EXPECT_EQ(moved_im, im);
+    }
+
+    TEST(CartonFft, FftBatch) {
+        test_fft_batch<float, 64u>(1u, 1u);
+        test_fft_batch<float, 64u>(8u, 8u);
+        test_fft_batch<float, 128u>(5u, 7u);
+        test_fft_batch<double, 64u>(3u, 4u);
+        test_fft_batch<double, 128u>(9u, 9u);
+        test_fft_batch<float, 1024u>(3u, 4u);
+
+        TFft<8u> fft;
+        std::vector<TComplex> data(16u);
+        EXPECT_THROW(fft.compute_batch(data.data(), 2u, 1u), std::invalid_argument);
+        EXPECT_THROW(fft.compute_batch(nullptr, 1u, 1u), std::invalid_argument);
+    }
+
+    TEST(CartonFft, FftThreadPool) {
+        for (size_t thread_count : {0u, 1u, 4u}) {
+            FFT::FftThreadPool pool(thread_count);
+            EXPECT_EQ(pool.get_thread_count(), std::max<size_t>(thread_count, 1u));
+
+            // every task is executed exactly once
+            std::vector<int> visited(1000u, 0);
+            pool.parallel_for(visited.size(), [&visited](size_t i) { visited[i] += 1; });
+            EXPECT_TRUE(std::all_of(visited.begin(), visited.end(), [](int v) { return v == 1; }));
+
+            // exception is rethrown after all tasks are finished
+            std::vector<int> finished(100u, 0);
+            EXPECT_THROW(pool.parallel_for(finished.size(),
+                                           [&finished](size_t i) {
+                                               finished[i] = 1;
+                                               if (i == 7u) throw std::runtime_error("task failed");
+                                           }),
+                         std::runtime_error);
+            EXPECT_TRUE(std::all_of(finished.begin(), finished.end(), [](int v) { return v == 1; }));
+
+            // nested call from a task is executed inline rather than deadlocking
+            std::vector<std::atomic<int>> nested(64u);
+            pool.parallel_for(8u, [&pool, &nested](size_t outer) {
+                pool.parallel_for(8u, [&nested, outer](size_t inner) { nested[outer * 8u + inner] += 1; });
+            });
+            EXPECT_TRUE(std::all_of(nested.begin(), nested.end(), [](const std::atomic<int>& v) { return v.load() == 1; }));
+        }
+    }
+
+    template<typename TAnyFloat, TIndex N>
+    static void test_fft_parallel(TIndex count, size_t thread_count) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        FFT::FftThreadPool pool(thread_count);
+        FFT::Fft<TIndex, TAnyFloat, N> fft;
+
+        // prepare deterministic frames
+        const auto src = make_test_signal<TAnyFloat>(count * N);
+
+        // compute expected result frame by frame, which must be exactly the same
+        std::vector<TAnyComplex> expected(src), actual(src);
+        for (TIndex i = 0u; i < count; ++i) {
+            fft.compute(expected.data() + i * N);
+        }
+        fft.parallel_compute(actual.data(), count, pool);
+        EXPECT_EQ(actual, expected);
+
+        for (TIndex i = 0u; i < count; ++i) {
+            fft.compute_inverse(expected.data() + i * N);
+        }
+        fft.parallel_compute_inverse(actual.data(), count, pool);
+        EXPECT_EQ(actual, expected);
+    }
+
+    TEST(CartonFft, FftParallel) {
+        for (size_t thread_count : {1u, 4u}) {
+            // inline execution for small batch
+            test_fft_parallel<float, 64u>(3u, thread_count);
+            // split into chunks
+            test_fft_parallel<float, 2048u>(67u, thread_count);
+            test_fft_parallel<double, 256u>(301u, thread_count);
+            test_fft_parallel<float, 480u>(100u, thread_count);
+        }
+
+        FFT::FftThreadPool pool(2u);
+        TFft<8u> fft;
+        // empty batch does nothing
+        std::vector<TComplex> data(8u, TComplex(1, 0));
+        fft.parallel_compute(data.data(), 0u, pool);
+        EXPECT_EQ(data, std::vector<TComplex>(8u, TComplex(1, 0)));
+        EXPECT_THROW(fft.parallel_compute(nullptr, 1u, pool), std::invalid_argument);
+        EXPECT_THROW(fft.parallel_compute_inverse(nullptr, 1u, pool), std::invalid_argument);
+    }
+
+    template<typename TAnyFloat>
+    static void test_four_step_fft(TIndex n, size_t thread_count) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        FFT::FftThreadPool pool(thread_count);
+        const auto src = make_test_signal<TAnyFloat>(n);
+
+        for (auto direction : {FFT::FftDirection::Forward, FFT::FftDirection::Backward}) {
+            // compute expected result by single plan
+            std::vector<TAnyComplex> expected(src), actual(src);
+            FFT::FftPlan<TIndex, TAnyFloat>(n, direction).compute(expected.data());
+            FFT::FourStepFft<TIndex, TAnyFloat> fft(n, direction);
+            EXPECT_EQ(fft.get_size(), n);
+            EXPECT_EQ(fft.get_direction(), direction);
+            fft.compute(actual.data(), pool);
+
+            double peak = 0.0;
+            for (const auto& item : expected) peak = std::max(peak, static_cast<double>(std::abs(item)));
+            const double tolerance = fft_tolerance<TAnyFloat>(peak, n, 8.0);
+            for (TIndex i = 0u; i < n; ++i) {
+                EXPECT_NEAR(actual[i].real(), expected[i].real(), tolerance);
+                EXPECT_NEAR(actual[i].imag(), expected[i].imag(), tolerance);
+            }
+        }
+    }
+
+    TEST(CartonFft, FourStepFft) {
+        test_four_step_fft<float>(4u, 1u);
+        test_four_step_fft<float>(8u, 2u);
+        test_four_step_fft<float>(1024u, 1u);
+        test_four_step_fft<float>(2048u, 3u);
+        test_four_step_fft<float>(65536u, 4u);
+        test_four_step_fft<double>(32u, 2u);
+        test_four_step_fft<double>(131072u, 4u);
+
+        EXPECT_THROW((FFT::FourStepFft<TIndex, TFloat>(2u)), std::invalid_argument);
+        EXPECT_THROW((FFT::FourStepFft<TIndex, TFloat>(96u)), std::invalid_argument);
+    }
+
+    template<typename TAnyFloat, TIndex ROWS, TIndex COLS>
+    static void test_fft_2d(size_t thread_count) {
+        using TAnyComplex = std::complex<TAnyFloat>;
+        FFT::FftThreadPool pool(thread_count);
+        FFT::Fft2D<TIndex, TAnyFloat, ROWS, COLS> fft;
+
+        // prepare deterministic source data
+        const auto src = make_test_signal<TAnyFloat>(ROWS * COLS);
+
+        // compute expected result by naive separable DFT in double precision
+        std::vector<std::complex<double>> expected(ROWS * COLS), temp(ROWS * COLS);
+        for (TIndex r = 0u; r < ROWS; ++r) {
+            for (TIndex k = 0u; k < COLS; ++k) {
+                std::complex<double> sum(0.0, 0.0);
+                for (TIndex c = 0u; c < COLS; ++c) {
+                    double angle = -2.0 * std::numbers::pi * static_cast<double>((k * c) % COLS) / static_cast<double>(COLS);
+                    sum += std::complex<double>(src[r * COLS + c]) * std::polar(1.0, angle);
+                }
+                temp[r * COLS + k] = sum;
+            }
+        }
+        for (TIndex c = 0u; c < COLS; ++c) {
+            for (TIndex k = 0u; k < ROWS; ++k) {
+                std::complex<double> sum(0.0, 0.0);
+                for (TIndex r = 0u; r < ROWS; ++r) {
+                    double angle = -2.0 * std::numbers::pi * static_cast<double>((k * r) % ROWS) / static_cast<double>(ROWS);
+                    sum += temp[r * COLS + c] * std::polar(1.0, angle);
+                }
+                expected[k * COLS + c] = sum;
+            }
+        }
+
+        double peak = 0.0;
+        for (const auto& item : expected) peak = std::max(peak, std::abs(item));
+        const double tolerance = fft_tolerance<TAnyFloat>(peak, ROWS * COLS, 8.0);
+
+        // single thread and thread pool should produce the same result
+        std::vector<TAnyComplex> single(src), pooled(src);
+        fft.compute(single.data());
+        fft.compute(pooled.data(), pool);
+        for (TIndex i = 0u; i < ROWS * COLS; ++i) {
+            EXPECT_NEAR(single[i].real(), expected[i].real(), tolerance);
+            EXPECT_NEAR(single[i].imag(), expected[i].imag(), tolerance);
+            EXPECT_EQ(pooled[i], single[i]);
+        }
+
+        // inverse transform should restore source, whose peak is about 1
+        const double roundtrip_tolerance = fft_tolerance<TAnyFloat>(1.0, ROWS * COLS, 8.0);
+        std::vector<TAnyComplex> unnormalized(single);
+        fft.compute_inverse(single.data());
+        fft.compute_inverse(pooled.data(), pool);
+        fft.compute_inverse(unnormalized.data(), FFT::FftNormalization::None);
+        const double n = static_cast<double>(ROWS * COLS);
+        for (TIndex i = 0u; i < ROWS * COLS; ++i) {
+            EXPECT_NEAR(single[i].real(), src[i].real(), roundtrip_tolerance);
+            EXPECT_NEAR(single[i].imag(), src[i].imag(), roundtrip_tolerance);
+            EXPECT_EQ(pooled[i], single[i]);
+            EXPECT_NEAR(unnormalized[i].real(), src[i].real() * n, roundtrip_tolerance * n);
+            EXPECT_NEAR(unnormalized[i].imag(), src[i].imag() * n, roundtrip_tolerance * n);
+        }
+    }
+
+    TEST(CartonFft, Fft2D) {
+        test_fft_2d<float, 2u, 2u>(1u);
+        test_fft_2d<float, 8u, 16u>(2u);
+        test_fft_2d<float, 32u, 4u>(3u);
+        test_fft_2d<float, 16u, 256u>(4u);
+        test_fft_2d<double, 64u, 128u>(4u);
+
+        FFT::Fft2D<TIndex, TFloat, 4u, 4u> fft;
+        EXPECT_THROW(fft.compute(nullptr), std::invalid_argument);
+        EXPECT_THROW(fft.compute_inverse(nullptr), std::invalid_argument);
+    }
+
+    template<typename TFixed, TIndex N>
+    static void test_fixed_fft(double amplitude, double tolerance, double roundtrip_tolerance) {
+        using TCompact = FFT::CompactComplex<TFixed>;
+        constexpr int Q = std::numeric_limits<TFixed>::digits;
+        const auto quantize = [](double v) -> TFixed {
+            constexpr double LIMIT = static_cast<double>(std::numeric_limits<TFixed>::max());
+            return static_cast<TFixed>(std::clamp(std::round(std::ldexp(v, Q)), -LIMIT - 1.0, LIMIT));
+        };
+
+        // prepare quantized signal and its exact value
+        std::vector<TCompact> data(N), origin(N);
+        std::vector<std::complex<double>> expected(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            double x = static_cast<double>(i);
+            origin[i] = TCompact{quantize(amplitude * std::sin(0.37 * x + 0.1 * x * x / N)), quantize(amplitude * std::cos(1.9 * x))};
+            expected[i] = std::complex<double>(std::ldexp(origin[i].re, -Q), std::ldexp(origin[i].im, -Q));
+        }
+        // full scale negative number should not overflow
+        origin[1].re = std::numeric_limits<TFixed>::min();
+        expected[1].real(-1.0);
+        data = origin;
+
+        FFT::Fft<TIndex, double, N> reference;
+        reference.compute(expected.data());
+        double peak = 0.0;
+        for (const auto& v : expected) peak = std::max({peak, std::abs(v.real()), std::abs(v.imag())});
+
+        FFT::FixedFft<TIndex, TFixed, N> fft;
+        int exponent = fft.compute(data.data());
+        EXPECT_GE(exponent, 0);
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(std::ldexp(data[i].re, exponent - Q), expected[i].real(), peak * tolerance);
+            EXPECT_NEAR(std::ldexp(data[i].im, exponent - Q), expected[i].imag(), peak * tolerance);
+        }
+
+        // inverse transform restores the signal, with the error of quantizing spectrum
+        exponent += fft.compute_inverse(data.data());
+        double origin_peak = 0.0;
+        for (const auto& v : origin) origin_peak = std::max({origin_peak, std::abs(std::ldexp(v.re, -Q)), std::abs(std::ldexp(v.im, -Q))});
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(std::ldexp(data[i].re, exponent - Q), std::ldexp(origin[i].re, -Q), origin_peak * roundtrip_tolerance);
+            EXPECT_NEAR(std::ldexp(data[i].im, exponent - Q), std::ldexp(origin[i].im, -Q), origin_peak * roundtrip_tolerance);
+        }
+    }
+
+    TEST(CartonFft, FixedFft) {
+        test_fixed_fft<std::int16_t, 4u>(0.9, 0.001, 0.001);
+        test_fixed_fft<std::int16_t, 256u>(0.9, 0.002, 0.02);
+        test_fixed_fft<std::int32_t, 1024u>(0.9, 1e-7, 1e-6);
+
+        // block scaling does not shift small signal which never overflows
+        std::vector<FFT::CompactComplex<std::int16_t>> impulse(16u, {0, 0});
+        impulse[0] = {100, -100};
+        EXPECT_EQ((FFT::FixedFft<TIndex, std::int16_t, 16u>().compute(impulse.data())), 0);
+        for (const auto& v : impulse) {
+            EXPECT_EQ(v.re, 100);
+            EXPECT_EQ(v.im, -100);
+        }
+        EXPECT_THROW((FFT::FixedFft<TIndex, std::int16_t, 16u>().compute(nullptr)), std::invalid_argument);
+    }
+
+    TEST(CartonFft, BFloat16) {
+        static_assert(sizeof(FFT::BFloat16) == 2u);
+        EXPECT_EQ(FFT::BFloat16(1.0f).bits, 0x3F80u);
+        EXPECT_EQ(FFT::BFloat16(-2.0f).bits, 0xC000u);
+        // round to nearest even
+        EXPECT_EQ(FFT::BFloat16(1.0f + std::ldexp(1.0f, -8)).bits, 0x3F80u);
+        EXPECT_EQ(FFT::BFloat16(1.0f + 3.0f * std::ldexp(1.0f, -8)).bits, 0x3F82u);
+        EXPECT_EQ(FFT::BFloat16(1.0f + std::ldexp(1.0f, -8) + std::ldexp(1.0f, -20)).bits, 0x3F81u);
+        // conversion back is exact
+        EXPECT_EQ(static_cast<float>(FFT::BFloat16(0.375f)), 0.375f);
+        EXPECT_TRUE(std::isnan(static_cast<float>(FFT::BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+        EXPECT_TRUE(std::isinf(static_cast<float>(FFT::BFloat16(std::numeric_limits<float>::infinity()))));
+    }
+
+    template<typename THalf, TIndex N>
+    static void test_half_fft(double tolerance) {
+        using TCompact = FFT::CompactComplex<THalf>;
+
+        // prepare signal in storage type and its exact value
+        std::vector<TCompact> data(N), origin(N);
+        std::vector<std::complex<double>> expected(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            double x = static_cast<double>(i);
+            origin[i] = TCompact{static_cast<THalf>(static_cast<float>(std::sin(0.37 * x))), static_cast<THalf>(static_cast<float>(std::cos(1.9 * x) * 0.5))};
+            expected[i] = std::complex<double>(static_cast<float>(origin[i].re), static_cast<float>(origin[i].im));
+        }
+        data = origin;
+
+        FFT::Fft<TIndex, double, N> reference;
+        reference.compute(expected.data());
+        double peak = 0.0;
+        for (const auto& v : expected) peak = std::max({peak, std::abs(v.real()), std::abs(v.imag())});
+
+        FFT::HalfFft<TIndex, THalf, N> fft;
+        fft.compute(data.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(static_cast<float>(data[i].re), expected[i].real(), peak * tolerance);
+            EXPECT_NEAR(static_cast<float>(data[i].im), expected[i].imag(), peak * tolerance);
+        }
+
+        // inverse transform restores the signal
+        fft.compute_inverse(data.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(static_cast<float>(data[i].re), static_cast<float>(origin[i].re), tolerance * 2.0);
+            EXPECT_NEAR(static_cast<float>(data[i].im), static_cast<float>(origin[i].im), tolerance * 2.0);
+        }
+        EXPECT_THROW(fft.compute(nullptr), std::invalid_argument);
+    }
+
+    TEST(CartonFft, HalfFft) {
+        test_half_fft<FFT::BFloat16, 8u>(std::ldexp(1.0, -8));
+        test_half_fft<FFT::BFloat16, 1024u>(std::ldexp(1.0, -8));
+#if defined(YYCC_FFT_HAS_FLOAT16)
+        test_half_fft<_Float16, 8u>(std::ldexp(1.0, -10));
+        test_half_fft<_Float16, 1024u>(std::ldexp(1.0, -10));
+#endif
+    }
+
+    TEST(CartonFft, SharedTables) {
+        // plans are shared per point and direction, rather than built by each instance.
+        using TPlanCache = FFT::FftPlanCache<TIndex, TFloat>;
+        EXPECT_EQ(TPlanCache::get(1024u).get(), TPlanCache::get(1024u).get());
+        EXPECT_EQ(TPlanCache::get(1024u, FFT::FftDirection::Backward).get(),
+                  TPlanCache::get(1024u, FFT::FftDirection::Backward).get());
+        EXPECT_NE(TPlanCache::get(1024u).get(), TPlanCache::get(1024u, FFT::FftDirection::Backward).get());
+
+        // instances created before and after clearing plan cache produce the same result.
+        constexpr TIndex N = 512u;
+        std::vector<TComplex> src(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = TComplex(static_cast<TFloat>(std::cos(0.57 * static_cast<double>(i))), static_cast<TFloat>(i % 7u));
+        }
+        std::vector<TComplex> first(src), second(src);
+        TFft<N> fft;
+        fft.compute(first.data());
+        FFT::FftPlanCache<TIndex, TFloat>::clear();
+        TFft<N> another_fft;
+        another_fft.compute(second.data());
+        EXPECT_EQ(first, second);
+    }
+
+    TEST(CartonFft, InverseFft) {
+        constexpr TIndex N = 128u;
+
+        // complex inverse
+        std::vector<TComplex> src(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            src[i] = TComplex(static_cast<TFloat>(std::sin(0.37 * static_cast<double>(i))), static_cast<TFloat>(i % 5u));
+        }
+        std::vector<TComplex> data(src);
+        TFft<N> fft;
+        fft.compute(data.data());
+        fft.compute_inverse(data.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(data[i].real(), src[i].real(), TOLERANCE);
+            EXPECT_NEAR(data[i].imag(), src[i].imag(), TOLERANCE);
+        }
+
+        // real inverse in both out-of-place and in-place
+        std::vector<TFloat> real_src(N), real_dst(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            real_src[i] = static_cast<TFloat>(std::cos(0.91 * static_cast<double>(i)) + static_cast<double>(i % 4u));
+        }
+        FFT::RealFft<TIndex, TFloat, N> real_fft;
+        std::vector<TComplex> spectrum(N / 2u + 1u);
+        real_fft.compute(real_src.data(), spectrum.data());
+        real_fft.compute_inverse(spectrum.data(), real_dst.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(real_dst[i], real_src[i], TOLERANCE);
+        }
+        // output is not required to be aligned as complex number
+        std::vector<TFloat> unaligned_dst(N + 1u);
+        real_fft.compute_inverse(spectrum.data(), unaligned_dst.data() + 1);
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(unaligned_dst[i + 1u], real_src[i], TOLERANCE);
+        }
+        // half point which is not a power of 2 also uses scratch inside
+        constexpr TIndex MIXED_N = 24u;
+        FFT::RealFft<TIndex, TFloat, MIXED_N> mixed_fft;
+        std::vector<TComplex> mixed_spectrum(MIXED_N / 2u + 1u);
+        std::vector<TFloat> mixed_dst(MIXED_N);
+        mixed_fft.compute(real_src.data(), mixed_spectrum.data());
+        mixed_fft.compute_inverse(mixed_spectrum.data(), mixed_dst.data());
+        for (TIndex i = 0u; i < MIXED_N; ++i) {
+            EXPECT_NEAR(mixed_dst[i], real_src[i], TOLERANCE);
+        }
+        real_fft.compute_inverse(spectrum.data(), FFT::FftNormalization::None);
+        const TFloat* unnormalized = reinterpret_cast<const TFloat*>(spectrum.data());
+        for (TIndex i = 0u; i < N; ++i) {
+            EXPECT_NEAR(unnormalized[i] / static_cast<TFloat>(N), real_src[i], TOLERANCE);
+        }
+    }
+
+    template<TIndex BLOCK>
+    static void test_convolver(TIndex impulse_len, FFT::ConvolutionMethod method, FFT::ConvolutionKind kind) {
+        constexpr TIndex BLOCK_COUNT = 7u;
+        const TIndex total = BLOCK * BLOCK_COUNT;
+
+        // prepare impulse and input stream
+        std::vector<TFloat> impulse(impulse_len), input(total), output(total);
+        for (TIndex i = 0u; i < impulse_len; ++i) {
+            impulse[i] = static_cast<TFloat>(std::sin(0.7 * static_cast<double>(i)) / static_cast<double>(i + 1u));
+        }
+        for (TIndex i = 0u; i < total; ++i) {
+            input[i] = static_cast<TFloat>(std::cos(0.23 * static_cast<double>(i)) + static_cast<double>(i % 3u) * 0.5);
+        }
+
+        // process stream block by block
+        FFT::Convolver<TIndex, TFloat, BLOCK> convolver(impulse.data(), impulse_len, method, kind);
+        EXPECT_EQ(convolver.get_block_size(), BLOCK);
+        EXPECT_EQ(convolver.get_partition_count(), (impulse_len + BLOCK - 1u) / BLOCK);
+        for (TIndex b = 0u; b < BLOCK_COUNT; ++b) {
+            convolver.process(input.data() + b * BLOCK, output.data() + b * BLOCK);
+        }
+
+        // compare with direct computation
+        for (TIndex n = 0u; n < total; ++n) {
+            double expected = 0.0;
+            for (TIndex k = 0u; k < impulse_len && k <= n; ++k) {
+                double tap = kind == FFT::ConvolutionKind::Convolution ? impulse[k] : impulse[impulse_len - 1u - k];
+                expected += tap * static_cast<double>(input[n - k]);
+            }
+            EXPECT_NEAR(output[n], expected, 0.001);
+        }
+
+        // after reset, the first block should be the same
+        std::vector<TFloat> again(BLOCK);
+        convolver.reset();
+        convolver.process(input.data(), again.data());
+        for (TIndex i = 0u; i < BLOCK; ++i) {
+            EXPECT_NEAR(again[i], output[i], TOLERANCE);
+        }
+    }
+
+    TEST(CartonFft, Convolver) {
+        using FFT::ConvolutionKind;
+        using FFT::ConvolutionMethod;
+
+        for (auto method : {ConvolutionMethod::OverlapAdd, ConvolutionMethod::OverlapSave}) {
+            test_convolver<16u>(1u, method, ConvolutionKind::Convolution);
+            test_convolver<16u>(5u, method, ConvolutionKind::Convolution);
+            test_convolver<16u>(16u, method, ConvolutionKind::Convolution);
+            test_convolver<16u>(57u, method, ConvolutionKind::Convolution);
+            test_convolver<32u>(45u, method, ConvolutionKind::Correlation);
+        }
+
+        TFloat impulse = 1.0f;
+        using TConvolver = FFT::Convolver<TIndex, TFloat, 16u>;
+        EXPECT_THROW(TConvolver(nullptr, 1u), std::invalid_argument);
+        EXPECT_THROW(TConvolver(&impulse, 0u), std::invalid_argument);
+    }
+
+    TEST(CartonFft, Stft) {
+        constexpr TIndex N = 32u;
+        constexpr TIndex HOP = 8u;
+        constexpr TIndex BINS = N / 2u + 1u;
+        FFT::Stft<TIndex, TFloat, N> stft(HOP);
+        EXPECT_EQ(stft.get_hop(), HOP);
+        EXPECT_THROW((FFT::Stft<TIndex, TFloat, N>(0u)), std::invalid_argument);
+        EXPECT_THROW((FFT::Stft<TIndex, TFloat, N>(N + 1u)), std::invalid_argument);
+
+        // prepare stream
+        constexpr TIndex TOTAL = 200u;
+        std::vector<TFloat> stream(TOTAL);
+        for (TIndex i = 0u; i < TOTAL; ++i) {
+            stream[i] = static_cast<TFloat>(std::sin(0.31 * static_cast<double>(i)) + static_cast<double>(i % 7u) * 0.1);
+        }
+
+        // push stream in irregular chunks and pop all frames
+        std::vector<std::vector<TComplex>> frames;
+        TIndex pushed = 0u, chunk = 1u;
+        while (pushed < TOTAL) {
+            TIndex count = std::min(chunk, TOTAL - pushed);
+            pushed += stft.push(stream.data() + pushed, count);
+            std::vector<TComplex> frame(BINS);
+            while (stft.pop_frame(frame.data())) {
+                frames.emplace_back(frame);
+            }
+            chunk = chunk % 13u + 5u;
+        }
+        EXPECT_EQ(frames.size(), (TOTAL - N) / HOP + 1u);
+        EXPECT_EQ(stft.get_frame_count(), 0u);
+
+        // compare with computing each windowed frame individually
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        FFT::RealFft<TIndex, TFloat, N> fft;
+        std::vector<TFloat> slice(N);
+        std::vector<TComplex> expected(BINS);
+        for (TIndex f = 0u; f < frames.size(); ++f) {
+            std::copy_n(stream.data() + f * HOP, N, slice.data());
+            window.apply_window(slice.data());
+            fft.compute(slice.data(), expected.data());
+            for (TIndex i = 0u; i < BINS; ++i) {
+                EXPECT_NEAR(frames[f][i].real(), expected[i].real(), TOLERANCE);
+                EXPECT_NEAR(frames[f][i].imag(), expected[i].imag(), TOLERANCE);
+            }
+        }
+
+        // samples occupied by pending frames are not overwritten
+        stft.reset();
+        EXPECT_EQ(stft.push(stream.data(), TOTAL), 64u);
+        EXPECT_EQ(stft.get_frame_count(), (64u - N) / HOP + 1u);
+        EXPECT_EQ(stft.get_free_space(), 0u);
+        std::vector<TFloat> amplitude(N / 2u);
+        EXPECT_TRUE(stft.pop_frame(amplitude.data()));
+        EXPECT_EQ(stft.get_free_space(), HOP);
+
+        // amplitude frames are the same as FriendlyFft even with asymmetric window,
+        // including frames wrapping around the end of ring buffer.
+        std::vector<TFloat> ramp(N);
+        for (TIndex i = 0u; i < N; ++i) ramp[i] = static_cast<TFloat>(i + 1u) / static_cast<TFloat>(N);
+        FFT::Window<TIndex, TFloat, N> ramp_window(ramp.data());
+        FFT::Stft<TIndex, TFloat, N> ramp_stft(HOP, ramp_window);
+        FFT::FriendlyFft<TIndex, TFloat, N> friendly;
+        std::vector<TFloat> expected_amplitude(N / 2u);
+        TIndex frame_index = 0u;
+        pushed = 0u;
+        while (pushed < TOTAL) {
+            pushed += ramp_stft.push(stream.data() + pushed, std::min<TIndex>(11u, TOTAL - pushed));
+            while (ramp_stft.pop_frame(amplitude.data())) {
+                friendly.easy_compute(stream.data() + frame_index * HOP, expected_amplitude.data(), ramp_window);
+                for (TIndex i = 0u; i < N / 2u; ++i) {
+                    EXPECT_NEAR(amplitude[i], expected_amplitude[i], 1e-3);
+                }
+                ++frame_index;
+            }
+        }
+        EXPECT_EQ(frame_index, (TOTAL - N) / HOP + 1u);
+    }
+
+    TEST(CartonFft, WelchPsd) {
+        constexpr TIndex N = 64u;
+        constexpr TIndex HOP = 32u;
+        constexpr TIndex BINS = N / 2u + 1u;
+        constexpr TIndex AVERAGE = 4u;
+        constexpr TFloat SAMPLE_RATE = 8000.0f;
+        using TWelch = FFT::WelchPsd<TIndex, TFloat, N>;
+        // relative tolerance, so that small off-peak bins are checked as strictly as the peak,
+        // and a tiny floor for bins whose power is close to zero.
+        constexpr double PSD_TOLERANCE = 1e-5;
+        constexpr double PSD_FLOOR = 1e-12;
+        using FFT::PsdAveraging;
+        EXPECT_THROW(TWelch(0u, PsdAveraging::FixedCount, AVERAGE), std::invalid_argument);
+        EXPECT_THROW(TWelch(HOP, PsdAveraging::FixedCount, 0u), std::invalid_argument);
+
+        // prepare stream: a tone with amplitude 2 at fractional bin, and some harmonics
+        constexpr TIndex TOTAL = N + HOP * 11u;
+        std::vector<TFloat> stream(TOTAL);
+        for (TIndex i = 0u; i < TOTAL; ++i) {
+            double phase = 2.0 * std::numbers::pi * 10.5 * static_cast<double>(i) / static_cast<double>(N);
+            stream[i] = static_cast<TFloat>(2.0 * std::sin(phase) + 0.3 * std::cos(3.1 * static_cast<double>(i)) + 0.1);
+        }
+
+        // compute the power of each frame individually
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        FFT::RealFft<TIndex, TFloat, N> fft;
+        double energy = 0.0;
+        for (TIndex i = 0u; i < N; ++i) energy += window.get_window_data()[i] * window.get_window_data()[i];
+        const TIndex frame_total = (TOTAL - N) / HOP + 1u;
+        std::vector<std::vector<double>> frame_powers;
+        std::vector<TFloat> slice(N);
+        std::vector<TComplex> spectrum(BINS);
+        for (TIndex f = 0u; f < frame_total; ++f) {
+            std::copy_n(stream.data() + f * HOP, N, slice.data());
+            window.apply_window(slice.data());
+            fft.compute(slice.data(), spectrum.data());
+            std::vector<double> power(BINS);
+            for (TIndex i = 0u; i < BINS; ++i) {
+                double fold = (i == 0u || i == N / 2u) ? 1.0 : 2.0;
+                power[i] = fold * std::norm(spectrum[i]) / (static_cast<double>(SAMPLE_RATE) * energy);
+            }
+            frame_powers.emplace_back(std::move(power));
+        }
+
+        // fixed count averaging publishes the average of the last full block
+        TWelch fixed(HOP, PsdAveraging::FixedCount, AVERAGE);
+        EXPECT_EQ(fixed.get_hop(), HOP);
+        std::vector<TFloat> psd(BINS), psd_db(BINS);
+        EXPECT_FALSE(fixed.get_psd(psd.data(), SAMPLE_RATE));
+        fixed.push(stream.data(), N + HOP * (AVERAGE - 2u));
+        EXPECT_FALSE(fixed.has_estimate());
+        fixed.push(stream.data() + N + HOP * (AVERAGE - 2u), TOTAL - (N + HOP * (AVERAGE - 2u)));
+        ASSERT_TRUE(fixed.get_psd(psd.data(), SAMPLE_RATE));
+        ASSERT_TRUE(fixed.get_psd_db(psd_db.data(), SAMPLE_RATE));
+        const TIndex last_block = frame_total / AVERAGE * AVERAGE - AVERAGE;
+        double integral = 0.0;
+        for (TIndex i = 0u; i < BINS; ++i) {
+            double expected = 0.0;
+            for (TIndex f = last_block; f < last_block + AVERAGE; ++f) expected += frame_powers[f][i];
+            expected /= static_cast<double>(AVERAGE);
+            EXPECT_NEAR(psd[i], expected, expected * PSD_TOLERANCE + PSD_FLOOR);
+            EXPECT_NEAR(psd_db[i], 10.0 * std::log10(psd[i]), 1e-3);
+            integral += psd[i] * SAMPLE_RATE / static_cast<double>(N);
+        }
+        // the integral of PSD is the mean power: 2^2 / 2 + 0.3^2 / 2 + 0.1^2
+        EXPECT_NEAR(integral, 2.0 + 0.045 + 0.01, 0.05);
+
+        // exponential averaging starts with plain average, then weights new frame by 1 / count
+        TWelch exponential(HOP, PsdAveraging::Exponential, AVERAGE, window);
+        exponential.push(stream.data(), TOTAL);
+        ASSERT_TRUE(exponential.get_psd(psd.data(), SAMPLE_RATE));
+        for (TIndex i = 0u; i < BINS; ++i) {
+            double expected = 0.0;
+            for (TIndex f = 0u; f < frame_total; ++f) {
+                double weight = 1.0 / static_cast<double>(std::min(f + 1u, AVERAGE));
+                expected += weight * (frame_powers[f][i] - expected);
+            }
+            EXPECT_NEAR(psd[i], expected, expected * PSD_TOLERANCE + PSD_FLOOR);
+        }
+
+        // after reset, there is no estimate
+        exponential.reset();
+        EXPECT_FALSE(exponential.has_estimate());
+        EXPECT_FALSE(exponential.get_psd_db(psd_db.data(), SAMPLE_RATE));
+
+        // invalid sample rate is rejected even if there is no estimate
+        EXPECT_THROW(exponential.get_psd(psd.data(), 0.0f), std::invalid_argument);
+        EXPECT_THROW(exponential.get_psd(psd.data(), -SAMPLE_RATE), std::invalid_argument);
+        EXPECT_THROW(exponential.get_psd(psd.data(), std::numeric_limits<TFloat>::quiet_NaN()), std::invalid_argument);
+        EXPECT_THROW(exponential.get_psd_db(psd_db.data(), std::numeric_limits<TFloat>::infinity()), std::invalid_argument);
+    }
+
+    TEST(CartonFft, MelFilterbank) {
+        constexpr TIndex N = 512u;
+        constexpr TIndex BINS = N / 2u + 1u;
+        constexpr TIndex MELS = 40u;
+        constexpr TFloat SAMPLE_RATE = 16000.0f;
+        using TMel = FFT::MelFilterbank<TIndex, TFloat, N>;
+        TMel mel(SAMPLE_RATE, MELS);
+        EXPECT_EQ(mel.get_mel_count(), MELS);
+
+        // filters are triangles on mel scale with peak 1,
+        // and adjacent filters sum to 1 between the centers of first and last filter.
+        const auto to_mel = [](double freq) { return 2595.0 * std::log10(1.0 + freq / 700.0); };
+        const auto to_freq = [](double m) { return 700.0 * (std::pow(10.0, m / 2595.0) - 1.0); };
+        const double mel_step = to_mel(SAMPLE_RATE / 2.0) / static_cast<double>(MELS + 1u);
+        std::vector<double> dense(BINS * MELS, 0.0), coverage(BINS, 0.0);
+        for (TIndex m = 0u; m < MELS; ++m) {
+            auto [start, weights] = mel.get_filter(m);
+            EXPECT_FALSE(weights.empty());
+            for (TIndex i = 0u; i < weights.size(); ++i) {
+                EXPECT_GT(weights[i], 0.0f);
+                EXPECT_LE(weights[i], 1.0f);
+                dense[m * BINS + start + i] = weights[i];
+                coverage[start + i] += weights[i];
+            }
+        }
+        const double bin_width = SAMPLE_RATE / static_cast<double>(N);
+        for (TIndex k = 0u; k < BINS; ++k) {
+            const double freq = static_cast<double>(k) * bin_width;
+            if (freq >= to_freq(mel_step) && freq <= to_freq(mel_step * MELS)) {
+                EXPECT_NEAR(coverage[k], 1.0, 1e-5);
+            }
+        }
+
+        // prepare deterministic power spectrum
+        std::vector<TFloat> power(BINS);
+        for (TIndex k = 0u; k < BINS; ++k) {
+            power[k] = static_cast<TFloat>(1.5 + std::sin(0.37 * static_cast<double>(k)));
+        }
+
+        // sparse filterbank is the same as dense matrix multiplication
+        std::vector<TFloat> energies(MELS), mfcc(13u);
+        std::vector<double> expected(MELS, 0.0);
+        mel.apply(power.data(), energies.data());
+        for (TIndex m = 0u; m < MELS; ++m) {
+            for (TIndex k = 0u; k < BINS; ++k) expected[m] += dense[m * BINS + k] * power[k];
+            EXPECT_NEAR(energies[m], expected[m], expected[m] * 1e-5);
+        }
+
+        // MFCC is orthonormal DCT-II of mel energies in decibel
+        mel.apply_mfcc(power.data(), mfcc.data(), 13u);
+        for (TIndex j = 0u; j < 13u; ++j) {
+            double sum = 0.0;
+            for (TIndex m = 0u; m < MELS; ++m) {
+                sum += 10.0 * std::log10(expected[m]) * std::cos(std::numbers::pi * j * (m + 0.5) / MELS);
+            }
+            sum *= std::sqrt((j == 0u ? 1.0 : 2.0) / MELS);
+            EXPECT_NEAR(mfcc[j], sum, 1e-3);
+        }
+
+        // tables are shared by the instances with the same parameters
+        TMel other(SAMPLE_RATE, MELS);
+        EXPECT_EQ(other.get_filter(3u).second.data(), mel.get_filter(3u).second.data());
+        TMel band(SAMPLE_RATE, MELS, 300.0f, 4000.0f);
+        EXPECT_NE(band.get_filter(3u).second.data(), mel.get_filter(3u).second.data());
+        EXPECT_GE(static_cast<double>(band.get_filter(0u).first) * bin_width, 300.0);
+        // tables of parameters which are not used anymore are freed rather than cached forever
+        const size_t cache_size = TMel::get_cache_size();
+        for (TIndex i = 0u; i < 50u; ++i) {
+            TMel temporary(SAMPLE_RATE, MELS, 100.0f + static_cast<TFloat>(i), 4000.0f);
+            EXPECT_LE(TMel::get_cache_size(), cache_size + 1u);
+        }
+
+        // 1kHz sine falls into the filter whose center is the nearest to 1kHz
+        std::vector<TFloat> frame(N), mel_db(MELS);
+        for (TIndex i = 0u; i < N; ++i) {
+            frame[i] = static_cast<TFloat>(std::sin(2.0 * std::numbers::pi * 1000.0 * static_cast<double>(i) / SAMPLE_RATE));
+        }
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        mel.easy_compute(frame.data(), mel_db.data(), window);
+        const TIndex nearest = static_cast<TIndex>(std::lround(to_mel(1000.0) / mel_step)) - 1u;
+        EXPECT_EQ(std::distance(mel_db.begin(), std::max_element(mel_db.begin(), mel_db.end())), nearest);
+        // it is the same as computing power spectrum by hand
+        std::vector<TComplex> spectrum(BINS);
+        std::vector<TFloat> windowed(N), expected_mfcc(13u);
+        window.apply_window(frame.data(), windowed.data(), true);
+        FFT::RealFft<TIndex, TFloat, N>().compute(windowed.data(), spectrum.data());
+        std::transform(spectrum.begin(), spectrum.end(), power.begin(), [](const TComplex& v) { return std::norm(v); });
+        mel.apply_mfcc(power.data(), expected_mfcc.data(), 13u);
+        mel.easy_compute_mfcc(frame.data(), mfcc.data(), 13u, window);
+        for (TIndex j = 0u; j < 13u; ++j) {
+            EXPECT_NEAR(mfcc[j], expected_mfcc[j], 1e-3);
+        }
+
+        // invalid arguments
+        EXPECT_THROW(TMel(0.0f, MELS), std::invalid_argument);
+        EXPECT_THROW(TMel(SAMPLE_RATE, 0u), std::invalid_argument);
+        EXPECT_THROW(TMel(SAMPLE_RATE, MELS, 4000.0f, 300.0f), std::invalid_argument);
+        EXPECT_THROW(TMel(SAMPLE_RATE, MELS, 0.0f, 9000.0f), std::invalid_argument);
+        EXPECT_THROW(mel.apply_mfcc(power.data(), mfcc.data(), MELS + 1u), std::invalid_argument);
+        EXPECT_THROW(mel.apply(nullptr, energies.data()), std::invalid_argument);
+        EXPECT_THROW(mel.get_filter(MELS), std::invalid_argument);
+    }
+
+    TEST(CartonFft, SpectrumBinner) {
+        constexpr TIndex N = 1024u;
+        constexpr TIndex BINS = N / 2u + 1u;
+        constexpr TIndex COLUMNS = 100u;
+        constexpr TFloat SAMPLE_RATE = 48000.0f;
+        using TBinner = FFT::SpectrumBinner<TIndex, TFloat, N>;
+
+        // logarithmic columns cover all bins above 0Hz in order without hole,
+        // and narrow columns at low frequency take one nearest bin.
+        TBinner binner(SAMPLE_RATE, COLUMNS);
+        EXPECT_EQ(binner.get_column_count(), COLUMNS);
+        TIndex covered = 1u;
+        for (TIndex c = 0u; c < COLUMNS; ++c) {
+            auto [start, length] = binner.get_column(c);
+            EXPECT_GE(length, 1u);
+            EXPECT_LE(start + length, BINS);
+            if (start + length > covered) {
+                EXPECT_LE(start, covered);
+                covered = start + length;
+            }
+        }
+        EXPECT_EQ(binner.get_column(0u).first, 1u);
+        EXPECT_EQ(covered, BINS);
+        EXPECT_EQ(binner.get_column(0u).second, 1u);
+        EXPECT_GT(binner.get_column(COLUMNS - 1u).second, 1u);
+
+        // linear columns split bins evenly, and the last one includes Nyquist frequency
+        FFT::SpectrumBinner<TIndex, TFloat, 16u> linear(16.0f, 4u, FFT::SpectrumScale::Linear);
+        for (TIndex c = 0u; c < 4u; ++c) {
+            EXPECT_EQ(linear.get_column(c), std::make_pair(c * 2u, c == 3u ? TIndex(3u) : TIndex(2u)));
+        }
+
+        // prepare deterministic complex spectrum
+        std::vector<TComplex> spectrum(BINS);
+        std::vector<TFloat> power(BINS);
+        for (TIndex k = 0u; k < BINS; ++k) {
+            spectrum[k] = TComplex(static_cast<TFloat>(1.5 + std::sin(0.37 * static_cast<double>(k))),
+                                   static_cast<TFloat>(std::cos(1.13 * static_cast<double>(k))));
+            power[k] = std::norm(spectrum[k]);
+        }
+
+        // pooling is done on linear power, and the result is in the same decibel as FriendlyFft
+        for (auto pooling : {FFT::SpectrumPooling::Max, FFT::SpectrumPooling::Mean}) {
+            TBinner pooled(SAMPLE_RATE, COLUMNS, FFT::SpectrumScale::Logarithmic, pooling);
+            std::vector<TFloat> from_spectrum(COLUMNS), from_power(COLUMNS);
+            pooled.apply(spectrum.data(), from_spectrum.data());
+            pooled.apply(power.data(), from_power.data());
+            for (TIndex c = 0u; c < COLUMNS; ++c) {
+                auto [start, length] = pooled.get_column(c);
+                double expected = 0.0;
+                for (TIndex k = start; k < start + length; ++k) {
+                    expected = pooling == FFT::SpectrumPooling::Max ? std::max(expected, static_cast<double>(power[k]))
+                                                                    : expected + static_cast<double>(power[k]);
+                }
+                if (pooling == FFT::SpectrumPooling::Mean) expected /= static_cast<double>(length);
+                EXPECT_NEAR(from_spectrum[c], 5.0 * std::log10(expected), 1e-3);
+                EXPECT_NEAR(from_power[c], from_spectrum[c], 1e-4);
+            }
+        }
+
+        // 1kHz sine falls into the column covering its bin,
+        // and it is the same as computing spectrum by hand.
+        std::vector<TFloat> frame(N), columns_db(COLUMNS), expected_db(COLUMNS);
+        for (TIndex i = 0u; i < N; ++i) {
+            frame[i] = static_cast<TFloat>(std::sin(2.0 * std::numbers::pi * 1000.0 * static_cast<double>(i) / SAMPLE_RATE));
+        }
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        binner.easy_compute(frame.data(), columns_db.data(), window);
+        auto loudest = binner.get_column(static_cast<TIndex>(std::distance(columns_db.begin(), std::max_element(columns_db.begin(), columns_db.end()))));
+        const TIndex tone_bin = static_cast<TIndex>(std::lround(1000.0 * N / SAMPLE_RATE));
+        EXPECT_LE(loudest.first, tone_bin);
+        EXPECT_GT(loudest.first + loudest.second, tone_bin);
+        std::vector<TFloat> windowed(N);
+        window.apply_window(frame.data(), windowed.data(), true);
+        FFT::RealFft<TIndex, TFloat, N>().compute(windowed.data(), spectrum.data());
+        binner.apply(spectrum.data(), expected_db.data());
+        for (TIndex c = 0u; c < COLUMNS; ++c) {
+            EXPECT_NEAR(columns_db[c], expected_db[c], 1e-3);
+        }
+
+        // peak-hold keeps loud frame and decays by given decibel per frame
+        std::vector<TFloat> loud(BINS, 100.0f), quiet(BINS, 1.0f), held(COLUMNS);
+        TBinner holder(SAMPLE_RATE, COLUMNS);
+        holder.enable_peak_hold(3.0f);
+        holder.apply(loud.data(), held.data());
+        EXPECT_NEAR(held[0], 10.0f, 1e-3);
+        holder.apply(quiet.data(), held.data());
+        EXPECT_NEAR(held[0], 7.0f, 1e-3);
+        holder.apply(quiet.data(), held.data());
+        EXPECT_NEAR(held[0], 4.0f, 1e-3);
+        holder.apply(quiet.data(), held.data());
+        holder.apply(quiet.data(), held.data());
+        EXPECT_NEAR(held[0], 0.0f, 1e-3);
+        holder.apply(loud.data(), held.data());
+        holder.reset_peak_hold();
+        holder.apply(quiet.data(), held.data());
+        EXPECT_NEAR(held[0], 0.0f, 1e-3);
+        holder.apply(loud.data(), held.data());
+        holder.disable_peak_hold();
+        holder.apply(quiet.data(), held.data());
+        EXPECT_NEAR(held[0], 0.0f, 1e-3);
+
+        // maps are shared by the instances with the same parameters, whatever pooling is
+        TBinner other(SAMPLE_RATE, COLUMNS, FFT::SpectrumScale::Logarithmic, FFT::SpectrumPooling::Mean);
+        for (TIndex c = 0u; c < COLUMNS; ++c) {
+            EXPECT_EQ(other.get_column(c), binner.get_column(c));
+        }
+        // maps of parameters which are not used anymore are freed rather than cached forever
+        const size_t cache_size = TBinner::get_cache_size();
+        for (TIndex i = 0u; i < 50u; ++i) {
+            TBinner temporary(SAMPLE_RATE, COLUMNS + i + 1u);
+            EXPECT_LE(TBinner::get_cache_size(), cache_size + 1u);
+        }
+
+        // invalid arguments
+        EXPECT_THROW(TBinner(0.0f, COLUMNS), std::invalid_argument);
+        EXPECT_THROW(TBinner(SAMPLE_RATE, 0u), std::invalid_argument);
+        EXPECT_THROW(TBinner(SAMPLE_RATE, COLUMNS, FFT::SpectrumScale::Logarithmic, FFT::SpectrumPooling::Max, 0.0f, 1000.0f),
+                     std::invalid_argument);
+        EXPECT_THROW(TBinner(SAMPLE_RATE, COLUMNS, FFT::SpectrumScale::Linear, FFT::SpectrumPooling::Max, 0.0f, 30000.0f),
+                     std::invalid_argument);
+        EXPECT_THROW(holder.enable_peak_hold(-1.0f), std::invalid_argument);
+        EXPECT_THROW(binner.apply(static_cast<const TFloat*>(nullptr), held.data()), std::invalid_argument);
+        EXPECT_THROW(binner.get_column(COLUMNS), std::invalid_argument);
+    }
+
+    /// @brief Compute DFT of given bin for windowed data in double precision.
+    template<TIndex N>
+    static std::complex<double> naive_windowed_dft(const TFloat* data, const TFloat* window, double bin) {
+        std::complex<double> sum(0.0, 0.0);
+        for (TIndex i = 0u; i < N; ++i) {
+            double angle = -2.0 * std::numbers::pi * bin * static_cast<double>(i) / static_cast<double>(N);
+            sum += static_cast<double>(data[i]) * static_cast<double>(window[i]) * std::polar(1.0, angle);
+        }
+        return sum;
+    }
+
+    TEST(CartonFft, Goertzel) {
+        constexpr TIndex N = 256u;
+        constexpr TIndex BINS = N / 2u + 1u;
+        const std::vector<TFloat> bins = {0.0f, 3.0f, 17.5f, 100.0f, 127.25f, 128.0f};
+        FFT::Goertzel<TIndex, TFloat, N> goertzel(bins.data(), bins.size());
+        EXPECT_EQ(goertzel.get_bin_count(), bins.size());
+        EXPECT_FLOAT_EQ((FFT::Goertzel<TIndex, TFloat, N>::get_bin(1000.0f, 8000.0f)), 32.0f);
+        EXPECT_THROW((FFT::Goertzel<TIndex, TFloat, N>(nullptr, 1u)), std::invalid_argument);
+        EXPECT_THROW((FFT::Goertzel<TIndex, TFloat, N>(bins.data(), 0u)), std::invalid_argument);
+
+        // prepare data
+        std::vector<TFloat> data(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            data[i] = static_cast<TFloat>(std::sin(0.41 * static_cast<double>(i)) + std::cos(2.3 * static_cast<double>(i)) * 0.5
+                                          + static_cast<double>(i % 5u) * 0.1);
+        }
+
+        for (auto window_type : {FFT::WindowType::HanningWindow, FFT::WindowType::BlackmanHarrisWindow}) {
+            FFT::Window<TIndex, TFloat, N> window(window_type);
+            std::vector<TComplex> spectrum(bins.size());
+            std::vector<TFloat> power(bins.size());
+            goertzel.compute(data.data(), spectrum.data(), window);
+            goertzel.compute_power(data.data(), power.data(), window);
+
+            // integral bins should be the same one produced by real FFT on windowed data
+            std::vector<TFloat> windowed(N);
+            std::vector<TComplex> expected(BINS);
+            window.apply_window(data.data(), windowed.data());
+            FFT::RealFft<TIndex, TFloat, N> fft;
+            fft.compute(windowed.data(), expected.data());
+
+            for (TIndex k = 0u; k < bins.size(); ++k) {
+                auto reference = naive_windowed_dft<N>(data.data(), window.get_window_data(), bins[k]);
+                EXPECT_NEAR(spectrum[k].real(), reference.real(), 0.001);
+                EXPECT_NEAR(spectrum[k].imag(), reference.imag(), 0.001);
+                EXPECT_NEAR(power[k], std::norm(reference), 0.001 * std::max(1.0, std::norm(reference)));
+                if (bins[k] == std::floor(bins[k])) {
+                    TIndex bin = static_cast<TIndex>(bins[k]);
+                    EXPECT_NEAR(spectrum[k].real(), expected[bin].real(), 0.001);
+                    EXPECT_NEAR(spectrum[k].imag(), expected[bin].imag(), 0.001);
+                }
+            }
+        }
+    }
+
+    template<TIndex N>
+    static void test_sliding_dft(const std::vector<TFloat>& bins, const FFT::Window<TIndex, TFloat, N>& window, bool windowed) {
+        auto sliding = windowed ? FFT::SlidingDft<TIndex, TFloat, N>(bins.data(), bins.size(), window)
+                                : FFT::SlidingDft<TIndex, TFloat, N>(bins.data(), bins.size());
+        EXPECT_EQ(sliding.get_bin_count(), bins.size());
+
+        // prepare stream with leading zeros standing for the samples before stream
+        constexpr TIndex TOTAL = N * 7u + 13u;
+        std::vector<TFloat> stream(N + TOTAL, 0.0f);
+        for (TIndex i = 0u; i < TOTAL; ++i) {
+            stream[N + i] = static_cast<TFloat>(std::sin(0.37 * static_cast<double>(i)) + std::cos(1.9 * static_cast<double>(i)) * 0.5
+                                                + static_cast<double>(i % 3u) * 0.2);
+        }
+        std::vector<TFloat> ones(N, 1.0f);
+        const TFloat* win_data = windowed ? window.get_window_data() : ones.data();
+
+        // push samples one by one and check spectrum at irregular points
+        std::vector<TComplex> spectrum(bins.size());
+        std::vector<TFloat> power(bins.size());
+        for (TIndex i = 0u; i < TOTAL; ++i) {
+            sliding.push(stream[N + i]);
+            if (i % 11u != 0u && i != TOTAL - 1u) continue;
+
+            sliding.get_spectrum(spectrum.data());
+            sliding.get_power(power.data());
+            const TFloat* latest = stream.data() + i + 1u;
+            for (TIndex k = 0u; k < bins.size(); ++k) {
+                auto reference = naive_windowed_dft<N>(latest, win_data, bins[k]);
+                EXPECT_NEAR(spectrum[k].real(), reference.real(), 0.001);
+                EXPECT_NEAR(spectrum[k].imag(), reference.imag(), 0.001);
+                EXPECT_NEAR(power[k], std::norm(reference), 0.001 * std::max(1.0, std::norm(reference)));
+            }
+        }
+
+        // pushing in bulk after reset should produce the same result
+        std::vector<TComplex> again(bins.size());
+        sliding.reset();
+        sliding.push(stream.data() + N, TOTAL);
+        sliding.get_spectrum(again.data());
+        for (TIndex k = 0u; k < bins.size(); ++k) {
+            EXPECT_NEAR(again[k].real(), spectrum[k].real(), TOLERANCE);
+            EXPECT_NEAR(again[k].imag(), spectrum[k].imag(), TOLERANCE);
+        }
+    }
+
+    TEST(CartonFft, SlidingDft) {
+        const std::vector<TFloat> bins = {0.0f, 1.0f, 5.0f, 9.5f, 31.0f, 32.0f};
+        using FFT::WindowType;
+        for (auto window_type : {WindowType::HanningWindow,
+                                 WindowType::HammingWindow,
+                                 WindowType::BlackmanWindow,
+                                 WindowType::BlackmanHarrisWindow,
+                                 WindowType::FlatTopWindow}) {
+            test_sliding_dft<64u>(bins, FFT::Window<TIndex, TFloat, 64u>(window_type), true);
+        }
+        test_sliding_dft<64u>(bins, FFT::Window<TIndex, TFloat, 64u>(WindowType::HanningWindow), false);
+        test_sliding_dft<1024u>({3.0f, 100.25f, 511.0f}, FFT::Window<TIndex, TFloat, 1024u>(WindowType::HanningWindow), true);
+
+        using TSliding = FFT::SlidingDft<TIndex, TFloat, 64u>;
+        EXPECT_THROW(TSliding(nullptr, 1u), std::invalid_argument);
+        EXPECT_THROW(TSliding(bins.data(), 0u), std::invalid_argument);
+        EXPECT_THROW(TSliding(bins.data(), 1u, FFT::Window<TIndex, TFloat, 64u>(WindowType::KaiserWindow)), std::invalid_argument);
+    }
+
+    TEST(CartonFft, ChirpZ) {
+        constexpr TIndex N = 256u;
+        using TChirpZ = FFT::ChirpZ<TIndex, TFloat, N>;
+        EXPECT_THROW(TChirpZ(0.0f, 1.0f, 0u), std::invalid_argument);
+        EXPECT_THROW(TChirpZ(0.0f, std::numeric_limits<TFloat>::infinity(), 4u), std::invalid_argument);
+        EXPECT_FLOAT_EQ(TChirpZ::get_bin(1000.0f, 8000.0f), 32.0f);
+
+        // prepare data
+        std::vector<TFloat> data(N);
+        std::vector<TFloat> imag(N);
+        std::vector<TComplex> complex_data(N);
+        for (TIndex i = 0u; i < N; ++i) {
+            data[i] = static_cast<TFloat>(std::sin(0.41 * static_cast<double>(i)) + std::cos(2.3 * static_cast<double>(i)) * 0.5
+                                          + static_cast<double>(i % 5u) * 0.1);
+            imag[i] = static_cast<TFloat>(std::cos(0.77 * static_cast<double>(i)));
+            complex_data[i] = TComplex(data[i], imag[i]);
+        }
+        FFT::Window<TIndex, TFloat, N> window(FFT::WindowType::HanningWindow);
+        std::vector<TFloat> ones(N, 1.0f);
+
+        // zoomed band, descending band, whole spectrum and single bin
+        const std::vector<std::tuple<TFloat, TFloat, TIndex>> bands = {
+            {15.0f, 18.0f, 97u},
+            {100.5f, 20.25f, 33u},
+            {0.0f, 255.0f, 256u},
+            {42.75f, 42.75f, 1u},
+        };
+        for (const auto& [first, last, count] : bands) {
+            TChirpZ czt(first, last, count);
+            EXPECT_EQ(czt.get_bin_count(), count);
+            EXPECT_GE(czt.get_fft_size(), N + count - 1u);
+            EXPECT_TRUE(std::has_single_bit(czt.get_fft_size()));
+
+            std::vector<TComplex> spectrum(count), complex_spectrum(count);
+            czt.compute(data.data(), spectrum.data(), window);
+            czt.compute(complex_data.data(), complex_spectrum.data());
+            for (TIndex k = 0u; k < count; ++k) {
+                const double bin = static_cast<double>(first) + static_cast<double>(czt.get_bin_step()) * static_cast<double>(k);
+                auto reference = naive_windowed_dft<N>(data.data(), window.get_window_data(), bin);
+                EXPECT_NEAR(spectrum[k].real(), reference.real(), 0.001);
+                EXPECT_NEAR(spectrum[k].imag(), reference.imag(), 0.001);
+
+                // complex input is the sum of real part and j times imaginary part.
+                auto complex_reference = naive_windowed_dft<N>(data.data(), ones.data(), bin)
+                                         + std::complex<double>(0.0, 1.0) * naive_windowed_dft<N>(imag.data(), ones.data(), bin);
+                EXPECT_NEAR(complex_spectrum[k].real(), complex_reference.real(), 0.002);
+                EXPECT_NEAR(complex_spectrum[k].imag(), complex_reference.imag(), 0.002);
+            }
+        }
+    }
+
 } // namespace yycctest::carton::fft